@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * U8g2 UTF8 font rendering benchmark
+ * Please note this font is 1,024,137 in size and cannot fit in many platform.
+ * This font is generated by U8g2 tools:
+ * u8g2/tools/font/bdfconv/bdfconv -v -f 1 -b 1 -m "32-127,11904-12351,19968-40959,63744-64255,65280-65376" unifont_jp-14.0.02.bdf -o u8g2_font_unifont_t_chinese.h -n u8g2_font_unifont_t_chinese
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Start of Arduino_GFX setting
+ *
+ * Arduino_GFX try to find the settings depends on selected board in Arduino IDE
+ * Or you can define the display dev kit not in the board list
+ * Defalult pin list for non display dev kit:
+ * Arduino Nano, Micro and more: CS:  9, DC:  8, RST:  7, BL:  6, SCK: 13, MOSI: 11, MISO: 12
+ * ESP32 various dev board     : CS:  5, DC: 27, RST: 33, BL: 22, SCK: 18, MOSI: 23, MISO: nil
+ * ESP32-C3 various dev board  : CS:  7, DC:  2, RST:  1, BL:  3, SCK:  4, MOSI:  6, MISO: nil
+ * ESP32-S2 various dev board  : CS: 34, DC: 38, RST: 33, BL: 21, SCK: 36, MOSI: 35, MISO: nil
+ * ESP32-S3 various dev board  : CS: 40, DC: 41, RST: 42, BL: 48, SCK: 36, MOSI: 35, MISO: nil
+ * ESP8266 various dev board   : CS: 15, DC:  4, RST:  2, BL:  5, SCK: 14, MOSI: 13, MISO: 12
+ * Raspberry Pi Pico dev board : CS: 17, DC: 27, RST: 26, BL: 28, SCK: 18, MOSI: 19, MISO: 16
+ * RTL8720 BW16 old patch core : CS: 18, DC: 17, RST:  2, BL: 23, SCK: 19, MOSI: 21, MISO: 20
+ * RTL8720_BW16 Official core  : CS:  9, DC:  8, RST:  6, BL:  3, SCK: 10, MOSI: 12, MISO: 11
+ * RTL8722 dev board           : CS: 18, DC: 17, RST: 22, BL: 23, SCK: 13, MOSI: 11, MISO: 12
+ * RTL8722_mini dev board      : CS: 12, DC: 14, RST: 15, BL: 13, SCK: 11, MOSI:  9, MISO: 10
+ * Seeeduino XIAO dev board    : CS:  3, DC:  2, RST:  1, BL:  0, SCK:  8, MOSI: 10, MISO:  9
+ * Teensy 4.1 dev board        : CS: 39, DC: 41, RST: 40, BL: 22, SCK: 13, MOSI: 11, MISO: 12
+ ******************************************************************************/
+#include <U8g2lib.h>
+#include <Arduino_GFX_Library.h>
+
+#define GFX_BL DF_GFX_BL // default backlight pin, you may replace DF_GFX_BL to actual backlight pin
+
+/* More dev device declaration: https://github.com/moononournation/Arduino_GFX/wiki/Dev-Device-Declaration */
+#if defined(DISPLAY_DEV_KIT)
+Arduino_GFX *gfx = create_default_Arduino_GFX();
+#else /* !defined(DISPLAY_DEV_KIT) */
+
+/* More data bus class: https://github.com/moononournation/Arduino_GFX/wiki/Data-Bus-Class */
+Arduino_DataBus *bus = create_default_Arduino_DataBus();
+
+/* More display class: https://github.com/moononournation/Arduino_GFX/wiki/Display-Class */
+Arduino_GFX *gfx = new Arduino_ILI9341(bus, DF_GFX_RST, 0 /* rotation */, false /* IPS */);
+
+#endif /* !defined(DISPLAY_DEV_KIT) */
+/*******************************************************************************
+ * End of Arduino_GFX setting
+ ******************************************************************************/
+
+/* more fonts at: https://github.com/moononournation/ArduinoFreeFontFile.git */
+
+#define ROUNDS 20
+
+static const char paragraph[] = "Arduino 是一個開源嵌入式硬體平台，用來供用戶製作可互動式的嵌入式專案。此外 Arduino 作為一個開源硬體和開源軟件的公司，同時兼有專案和用戶社群。該公司負責設計和製造Arduino電路板及相關附件。";
+
+Arduino_Canvas *canvas;
+
+uint32_t renderParagraph(uint16_t color, uint16_t bg)
+{
+  canvas->setTextColor(color, bg);
+  uint32_t start = micros();
+  for (int i = 0; i < ROUNDS; ++i)
+  {
+    canvas->setCursor(0, 16);
+    canvas->print(paragraph);
+  }
+  return (micros() - start) / ROUNDS;
+}
+
+void setup(void)
+{
+#ifdef DEV_DEVICE_INIT
+  DEV_DEVICE_INIT();
+#endif
+
+  Serial.begin(115200);
+  // Serial.setDebugOutput(true);
+  // while(!Serial);
+  Serial.println("Arduino_GFX U8g2 Font UTF8 Benchmark example");
+
+  // Render into a canvas so the figures measure glyph lookup and decode rather than the data bus
+  canvas = new Arduino_Canvas(gfx->width(), gfx->height(), gfx);
+
+  // Init Display
+  if (!canvas->begin())
+  {
+    Serial.println("canvas->begin() failed!");
+  }
+  canvas->fillScreen(RGB565_BLACK);
+  canvas->setUTF8Print(true); // enable UTF8 support for the Arduino print() function
+
+#ifdef GFX_BL
+  pinMode(GFX_BL, OUTPUT);
+  digitalWrite(GFX_BL, HIGH);
+#endif
+
+  uint32_t t = micros();
+  canvas->setFont(u8g2_font_unifont_t_chinese);
+  Serial.printf("setFont() with glyph index: %lu us\n", (unsigned long)(micros() - t));
+
+  Serial.printf("Transparent background: %lu us per paragraph\n", (unsigned long)renderParagraph(RGB565_WHITE, RGB565_WHITE));
+  canvas->fillScreen(RGB565_BLACK);
+  Serial.printf("Opaque background: %lu us per paragraph\n", (unsigned long)renderParagraph(RGB565_WHITE, RGB565_BLACK));
+
+  canvas->flush();
+}
+
+void loop()
+{
+}
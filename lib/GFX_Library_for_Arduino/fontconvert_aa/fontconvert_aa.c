@@ -0,0 +1,396 @@
+/*
+TrueType to Arduino_GFX anti-aliased font converter.
+Derived from Adafruit_GFX fontconvert, produces GFXAAfont (gfxfont_aa.h)
+headers with 4-bit coverage per pixel instead of 1-bit bitmaps.
+
+REQUIRES FREETYPE LIBRARY. www.freetype.org
+
+Usage: fontconvert_aa [-c] [FONTFILE] [SIZE] [FIRSTCHAR] [LASTCHAR]
+  -c  run-length compress glyph bitmaps (see gfxfont_aa.h for packet format)
+
+Currently this only extracts the printable 7-bit ASCII chars of a font.
+Will eventually extend with some int'l chars a la ftGFX, not there yet.
+Keep 7-bit fonts around as an option in that case, more compact.
+
+See notes at end for glyph nomenclature & other tidbits.
+*/
+
+#include <ctype.h>
+#include <ft2build.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include FT_GLYPH_H
+#include FT_MODULE_H
+#include FT_TRUETYPE_DRIVER_H
+#include "../src/gfxfont_aa.h" // Arduino_GFX anti-aliased font structures
+
+#define DPI 141 // Approximate res. of Adafruit 2.8" TFT
+
+static uint32_t offset = 0; // Bytes emitted so far
+static int column = 0;      // Current output column
+
+// Emit one byte of bitmap data, 12 bytes per line.
+static void writeByte(uint8_t b)
+{
+  if (column == 0)
+  {
+    printf("\n  ");
+  }
+  printf("0x%02X, ", b);
+  if (++column >= 12)
+  {
+    column = 0;
+  }
+  offset++;
+}
+
+// Quantize 8-bit FreeType coverage to 4-bit alpha.
+static uint8_t quantize(uint8_t v) { return (uint8_t)((v * 15 + 127) / 255); }
+
+// Emit alpha values as raw nibbles, high nibble first, glyph padded to a byte.
+static void writeRaw(const uint8_t *alpha, int count)
+{
+  int i;
+  for (i = 0; i < count; i += 2)
+  {
+    uint8_t b = alpha[i] << 4;
+    if ((i + 1) < count)
+    {
+      b |= alpha[i + 1];
+    }
+    writeByte(b);
+  }
+}
+
+// Length of the run of value v starting at alpha[i], limited to max.
+static int runLength(const uint8_t *alpha, int i, int count, uint8_t v, int max)
+{
+  int n = 0;
+  while (((i + n) < count) && (alpha[i + n] == v) && (n < max))
+  {
+    n++;
+  }
+  return n;
+}
+
+// Emit alpha values as run-length packets. Runs of 0 and 15 shorter than
+// 3 pixels are cheaper inside a literal packet.
+static void writeCompressed(const uint8_t *alpha, int count)
+{
+  int i = 0, n, j;
+  while (i < count)
+  {
+    if ((alpha[i] == 0) || (alpha[i] == 15))
+    {
+      n = runLength(alpha, i, count, alpha[i], GFXAA_PACKET_MAX_RUN);
+      if ((n >= 3) || ((i + n) == count))
+      {
+        writeByte(((alpha[i] == 0) ? GFXAA_PACKET_TRANSPARENT : GFXAA_PACKET_OPAQUE) | (n - 1));
+        i += n;
+        continue;
+      }
+    }
+    // literal packet, stop before a run worth its own packet
+    n = 1;
+    while (((i + n) < count) && (n < GFXAA_PACKET_MAX_RUN))
+    {
+      uint8_t v = alpha[i + n];
+      if (((v == 0) || (v == 15)) &&
+          (runLength(alpha, i + n, count, v, 3) >= 3))
+      {
+        break;
+      }
+      n++;
+    }
+    writeByte(GFXAA_PACKET_LITERAL | (n - 1));
+    for (j = 0; j < n; j += 2)
+    {
+      uint8_t b = alpha[i + j] << 4;
+      if ((j + 1) < n)
+      {
+        b |= alpha[i + j + 1];
+      }
+      writeByte(b);
+    }
+    i += n;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  int i, j, err, size, first = ' ', last = '~', bitmapOffset = 0, x, y;
+  int compressed = 0, argi = 1;
+  uint32_t rawBytes = 0;
+  char *fontName, c, *ptr;
+  FT_Library library;
+  FT_Face face;
+  FT_Glyph glyph;
+  FT_Bitmap *bitmap;
+  FT_BitmapGlyphRec *g;
+  GFXAAglyph *table;
+  uint8_t *alpha;
+
+  // Parse command line. Valid syntaxes are:
+  //   fontconvert_aa [-c] [filename] [size]
+  //   fontconvert_aa [-c] [filename] [size] [last char]
+  //   fontconvert_aa [-c] [filename] [size] [first char] [last char]
+  // Unless overridden, default first and last chars are
+  // ' ' (space) and '~', respectively
+
+  if ((argc > argi) && !strcmp(argv[argi], "-c"))
+  {
+    compressed = 1;
+    argi++;
+  }
+
+  if ((argc - argi) < 2)
+  {
+    fprintf(stderr, "Usage: %s [-c] fontfile size [first] [last]\n", argv[0]);
+    return 1;
+  }
+
+  size = atoi(argv[argi + 1]);
+
+  if ((argc - argi) == 3)
+  {
+    last = atoi(argv[argi + 2]);
+  }
+  else if ((argc - argi) == 4)
+  {
+    first = atoi(argv[argi + 2]);
+    last = atoi(argv[argi + 3]);
+  }
+
+  if (last < first)
+  {
+    i = first;
+    first = last;
+    last = i;
+  }
+
+  ptr = strrchr(argv[argi], '/'); // Find last slash in filename
+  if (ptr)
+    ptr++; // First character of filename (path stripped)
+  else
+    ptr = argv[argi]; // No path; font in local dir.
+
+  // Allocate space for font name and glyph table
+  if ((!(fontName = malloc(strlen(ptr) + 20))) ||
+      (!(table = (GFXAAglyph *)malloc((last - first + 1) * sizeof(GFXAAglyph)))))
+  {
+    fprintf(stderr, "Malloc error\n");
+    return 1;
+  }
+
+  // Derive font table names from filename. Period (filename
+  // extension) is truncated and replaced with the font size & bits.
+  strcpy(fontName, ptr);
+  ptr = strrchr(fontName, '.'); // Find last period (file ext)
+  if (!ptr)
+    ptr = &fontName[strlen(fontName)]; // If none, append
+  // Insert font size and 4-bit alpha extension
+  sprintf(ptr, "%dptAA4%s", size, compressed ? "c" : "");
+  // Space and punctuation chars in name replaced w/ underscores.
+  for (i = 0; (c = fontName[i]); i++)
+  {
+    if (isspace(c) || ispunct(c))
+      fontName[i] = '_';
+  }
+
+  // Init FreeType lib, load font
+  if ((err = FT_Init_FreeType(&library)))
+  {
+    fprintf(stderr, "FreeType init error: %d", err);
+    return err;
+  }
+
+  // Use TrueType engine version 35, same hinting as fontconvert so
+  // glyph metrics match the 1-bit GFXfont of the same size.
+  FT_UInt interpreter_version = TT_INTERPRETER_VERSION_35;
+  FT_Property_Set(library, "truetype", "interpreter-version",
+                  &interpreter_version);
+
+  if ((err = FT_New_Face(library, argv[argi], 0, &face)))
+  {
+    fprintf(stderr, "Font load error: %d", err);
+    FT_Done_FreeType(library);
+    return err;
+  }
+
+  // << 6 because '26dot6' fixed-point format
+  FT_Set_Char_Size(face, size << 6, 0, DPI, 0);
+
+  // Currently all symbols from 'first' to 'last' are processed.
+  // Fonts may contain WAY more glyphs than that, but this code
+  // will need to handle encoding stuff to deal with extracting
+  // the right symbols, and that's not done yet.
+  // fprintf(stderr, "%ld glyphs\n", face->num_glyphs);
+
+  printf("const uint8_t %sBitmaps[] PROGMEM = {", fontName);
+
+  // Process glyphs and output huge bitmap data array
+  for (i = first, j = 0; i <= last; i++, j++)
+  {
+    // NORMAL renderer provides 8-bit coverage with a tight crop
+    // (no wasted pixels) via bitmap struct.
+    if ((err = FT_Load_Char(face, i, FT_LOAD_TARGET_NORMAL)))
+    {
+      fprintf(stderr, "Error %d loading char '%c'\n", err, i);
+      continue;
+    }
+
+    if ((err = FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL)))
+    {
+      fprintf(stderr, "Error %d rendering char '%c'\n", err, i);
+      continue;
+    }
+
+    if ((err = FT_Get_Glyph(face->glyph, &glyph)))
+    {
+      fprintf(stderr, "Error %d getting glyph '%c'\n", err, i);
+      continue;
+    }
+
+    bitmap = &face->glyph->bitmap;
+    g = (FT_BitmapGlyphRec *)glyph;
+
+    // Minimal font and per-glyph information is stored to
+    // reduce flash space requirements.  Glyph alpha nibbles are
+    // packed with no per-scanline pad, the end of each character
+    // is padded to the next byte boundary when needed.  (Doesn't
+    // check that size & offsets are within bounds...please
+    // convert fonts responsibly.)
+    table[j].bitmapOffset = bitmapOffset;
+    table[j].width = bitmap->width;
+    table[j].height = bitmap->rows;
+    table[j].xAdvance = face->glyph->advance.x >> 6;
+    table[j].xOffset = g->left;
+    table[j].yOffset = 1 - g->top;
+
+    if (!(alpha = malloc((bitmap->width * bitmap->rows) + 1)))
+    {
+      fprintf(stderr, "Malloc error\n");
+      return 1;
+    }
+    for (y = 0; y < bitmap->rows; y++)
+    {
+      for (x = 0; x < bitmap->width; x++)
+      {
+        alpha[(y * bitmap->width) + x] = quantize(bitmap->buffer[(y * bitmap->pitch) + x]);
+      }
+    }
+
+    offset = 0;
+    if (compressed)
+    {
+      writeCompressed(alpha, bitmap->width * bitmap->rows);
+    }
+    else
+    {
+      writeRaw(alpha, bitmap->width * bitmap->rows);
+    }
+    rawBytes += ((bitmap->width * bitmap->rows) + 1) / 2;
+    bitmapOffset += offset;
+
+    free(alpha);
+    FT_Done_Glyph(glyph);
+  }
+
+  printf(" };\n\n"); // End bitmap array
+
+  // Output glyph attributes table (one per character)
+  printf("const GFXAAglyph %sGlyphs[] PROGMEM = {\n", fontName);
+  for (i = first, j = 0; i <= last; i++, j++)
+  {
+    printf("  { %6d, %3d, %3d, %3d, %4d, %4d }", table[j].bitmapOffset,
+           table[j].width, table[j].height, table[j].xAdvance, table[j].xOffset,
+           table[j].yOffset);
+    if (i < last)
+    {
+      printf(",   // 0x%02X", i);
+      if ((i >= ' ') && (i <= '~'))
+      {
+        printf(" '%c'", i);
+      }
+      putchar('\n');
+    }
+  }
+  printf(" }; // 0x%02X", last);
+  if ((last >= ' ') && (last <= '~'))
+    printf(" '%c'", last);
+  printf("\n\n");
+
+  // Output font structure
+  printf("const GFXAAfont %s PROGMEM = {\n", fontName);
+  printf("  (uint8_t  *)%sBitmaps,\n", fontName);
+  printf("  (GFXAAglyph *)%sGlyphs,\n", fontName);
+  if (face->size->metrics.height == 0)
+  {
+    // No face height info, assume fixed width and get from a glyph.
+    printf("  0x%02X, 0x%02X, %d, %d };\n\n", first, last, table[0].height,
+           compressed);
+  }
+  else
+  {
+    printf("  0x%02X, 0x%02X, %ld, %d };\n\n", first, last,
+           face->size->metrics.height >> 6, compressed);
+  }
+  printf("// Approx. %d bytes (raw 4-bpp bitmaps: %u bytes)\n",
+         bitmapOffset + (last - first + 1) * 10 + 12, rawBytes);
+  // Size estimate is based on AVR struct and pointer sizes;
+  // actual size may vary.
+
+  FT_Done_FreeType(library);
+
+  return 0;
+}
+
+/* -------------------------------------------------------------------------
+
+Character metrics are slightly different from classic GFX & ftGFX.
+In classic GFX: cursor position is the upper-left pixel of each 5x7
+character; lower extent of most glyphs (except those w/descenders)
+is +6 pixels in Y direction.
+W/new GFX fonts: cursor position is on baseline, where baseline is
+'inclusive' (containing the bottom-most row of pixels in most symbols,
+except those with descenders; ftGFX is one pixel lower).
+
+Cursor Y will be moved automatically when switching between classic
+and new fonts.  If you switch fonts, any print() calls will continue
+along the same baseline.
+
+                    ...........#####.. -- yOffset
+                    ..........######..
+                    ..........######..
+                    .........#######..
+                    ........#########.
+   * = Cursor pos.  ........#########.
+                    .......##########.
+                    ......#####..####.
+                    ......#####..####.
+       *.#..        .....#####...####.
+       .#.#.        ....##############
+       #...#        ...###############
+       #...#        ...###############
+       #####        ..#####......#####
+       #...#        .#####.......#####
+====== #...# ====== #*###.........#### ======= Baseline
+                    || xOffset
+
+glyph->xOffset and yOffset are pretty self-explanatory for the
+new GFX fonts, the rest take some explaining:
+
+Hsync: horizontal sync, the area between the bitmap and cursor
+position (often negative).  Xadvance: distance from the cursor to the
+next cursor position, including any horizontal gap.
+
+yAdvance: newline distance, the value is calculated from the font
+height info when available.  If not, the height of a glyph is used.
+
+In the anti-aliased format each '#' above is a 4-bit coverage value
+instead of a single bit, so partially covered edge pixels are blended
+between foreground and background at draw time.
+
+------------------------------------------------------------------------- */
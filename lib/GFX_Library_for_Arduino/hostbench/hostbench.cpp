@@ -0,0 +1,1451 @@
+/*
+ * Host side display benchmark, runs PDQgraphicstest style workloads on an
+ * Arduino_ST7789 through Arduino_RecordBus and reports the bus traffic and
+ * the estimated SPI wire time of each workload. The emulated display memory
+ * after each workload is hashed, compare the hashes with a golden file to
+ * catch rendering regressions.
+ *
+ * The gfxconvert row kernels are checked against the per pixel conversion
+ * the scroll / partial / idle command sequences against the expected bytes,
+ * Arduino_TFT_T against the virtual class hierarchy, the frame pacer
+ * against a simulated TE source and the band queue between 2 threads on
+ * every run.
+ *
+ * usage: hostbench [-s spi_hz] [-t transaction_ns] [-r rotation]
+ *                  [-g golden.txt] [-u golden.txt] [-o image_dir] [-k]
+ *   -g  compare with golden hashes, exit code 1 on mismatch
+ *   -u  write golden hashes
+ *   -o  write the display memory after each workload as PPM image
+ *   -k  also time the row kernels against the per pixel conversion and the
+ *       primitives of Arduino_TFT_T against the virtual class hierarchy
+ *   -j  decode cost in ns per decoded pixel for the image latency model
+ */
+#include "Arduino_GFX.h"
+#include "databus/Arduino_RecordBus.h"
+#include "display/Arduino_ST7789.h"
+#include "Arduino_TFT_T.h"
+#include "Arduino_FramePacer.h"
+#include "canvas/Arduino_Canvas.h"
+#include "canvas/Arduino_ImagePipeline.h"
+#include "canvas/Arduino_Canvas_Strip.h"
+#include "canvas/Arduino_BandQueue.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define GRAM_W 240
+#define GRAM_H 320
+#define TRACE_SIZE (64 * 1024 * 1024)
+#define MAX_WORKLOADS 32
+
+Arduino_RecordBus *bus;
+Arduino_ST7789 *gfx;
+int32_t w, h, n, n1, cx, cy, cx1, cy1, cn, cn1;
+
+uint16_t bitmap16[64 * 48];
+uint8_t bitmap1[64 / 8 * 48];
+uint8_t bitmap8[64 * 48];
+uint16_t palette[256];
+uint8_t bitmap24[61 * 37 * 3];
+uint8_t bitmapGray[61 * 37];
+uint8_t bitmapIdx[61 * 37];
+uint16_t bitmapBe[61 * 37];
+
+// each workload returns its number of drawing operations
+int32_t testFillScreen()
+{
+  gfx->fillScreen(RGB565_WHITE);
+  gfx->fillScreen(RGB565_RED);
+  gfx->fillScreen(RGB565_GREEN);
+  gfx->fillScreen(RGB565_BLUE);
+  gfx->fillScreen(RGB565_BLACK);
+  return 5;
+}
+
+int32_t testText()
+{
+  static const char *lines[] = {
+      "Hello World!", "I implore thee,", "my foonting turlingdromes.",
+      "And hooptiously drangle me", "with crinkly bindlewurdles,"};
+  int32_t ops = 0;
+  gfx->setCursor(0, 0);
+  for (uint8_t s = 1; s <= 3; ++s)
+  {
+    gfx->setTextSize(s);
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+      gfx->setTextColor(gfx->color565(i * 50, 255 - i * 50, s * 80), (i & 1) ? RGB565_WHITE : RGB565_BLACK);
+      ops += gfx->println(lines[i]) - 2;
+    }
+  }
+  gfx->setTextSize(1);
+  return ops;
+}
+
+int32_t testPixels()
+{
+  for (int16_t y = 0; y < h; y++)
+  {
+    for (int16_t x = 0; x < w; x++)
+    {
+      gfx->drawPixel(x, y, gfx->color565(x << 3, y << 3, x * y));
+    }
+  }
+  return w * h;
+}
+
+int32_t testLines()
+{
+  int32_t ops = 0;
+  int32_t x1 = 0, y1 = 0, x2, y2;
+  for (int c = 0; c < 4; ++c)
+  {
+    x1 = (c & 1) ? (w - 1) : 0;
+    y1 = (c & 2) ? (h - 1) : 0;
+    y2 = h - 1 - y1;
+    for (x2 = 0; x2 < w; x2 += 6, ++ops)
+    {
+      gfx->drawLine(x1, y1, x2, y2, RGB565_BLUE);
+    }
+    x2 = w - 1 - x1;
+    for (y2 = 0; y2 < h; y2 += 6, ++ops)
+    {
+      gfx->drawLine(x1, y1, x2, y2, RGB565_BLUE);
+    }
+  }
+  return ops;
+}
+
+int32_t testFastLines()
+{
+  int32_t ops = 0;
+  for (int32_t y = 0; y < h; y += 5, ++ops)
+  {
+    gfx->drawFastHLine(0, y, w, RGB565_RED);
+  }
+  for (int32_t x = 0; x < w; x += 5, ++ops)
+  {
+    gfx->drawFastVLine(x, 0, h, RGB565_BLUE);
+  }
+  return ops;
+}
+
+int32_t testFilledRects()
+{
+  int32_t ops = 0;
+  for (int32_t i = n; i > 0; i -= 6, ++ops)
+  {
+    gfx->fillRect(cx - i / 2, cy - i / 2, i, i, gfx->color565(i, i, 0));
+  }
+  return ops;
+}
+
+int32_t testRects()
+{
+  int32_t ops = 0;
+  for (int32_t i = 2; i < n; i += 6, ++ops)
+  {
+    gfx->drawRect(cx - i / 2, cy - i / 2, i, i, RGB565_GREEN);
+  }
+  return ops;
+}
+
+int32_t testFilledCircles()
+{
+  int32_t ops = 0;
+  for (int32_t x = 10; x < w; x += 20)
+  {
+    for (int32_t y = 10; y < h; y += 20, ++ops)
+    {
+      gfx->fillCircle(x, y, 10, RGB565_MAGENTA);
+    }
+  }
+  return ops;
+}
+
+int32_t testCircles()
+{
+  int32_t ops = 0;
+  for (int32_t x = 0; x < w + 10; x += 20)
+  {
+    for (int32_t y = 0; y < h + 10; y += 20, ++ops)
+    {
+      gfx->drawCircle(x, y, 10, RGB565_WHITE);
+    }
+  }
+  return ops;
+}
+
+int32_t testFillArcs()
+{
+  int32_t ops = 0;
+  int16_t r = (360 > cn) ? (360 / cn) : 1;
+  for (int16_t i = 6; i < cn; i += 6, ++ops)
+  {
+    gfx->fillArc(cx1, cy1, i, i - 3, 0, i * r, RGB565_RED);
+  }
+  return ops;
+}
+
+int32_t testArcs()
+{
+  int32_t ops = 0;
+  int16_t r = (360 > cn) ? (360 / cn) : 1;
+  for (int16_t i = 6; i < cn; i += 6, ++ops)
+  {
+    gfx->drawArc(cx1, cy1, i, i - 3, 0, i * r, RGB565_WHITE);
+  }
+  return ops;
+}
+
+int32_t testFilledTriangles()
+{
+  int32_t ops = 0;
+  for (int32_t i = cn1; i > 10; i -= 5, ++ops)
+  {
+    gfx->fillTriangle(cx1, cy1 - i, cx1 - i, cy1 + i, cx1 + i, cy1 + i, gfx->color565(0, i, i));
+  }
+  return ops;
+}
+
+int32_t testTriangles()
+{
+  int32_t ops = 0;
+  for (int32_t i = 0; i < cn; i += 5, ++ops)
+  {
+    gfx->drawTriangle(cx1, cy1 - i, cx1 - i, cy1 + i, cx1 + i, cy1 + i, gfx->color565(0, 0, i));
+  }
+  return ops;
+}
+
+int32_t testFilledRoundRects()
+{
+  int32_t ops = 0;
+  for (int32_t i = n1; i > 20; i -= 6, ++ops)
+  {
+    gfx->fillRoundRect(cx - i / 2, cy - i / 2, i, i, i / 8, gfx->color565(0, i, 0));
+  }
+  return ops;
+}
+
+int32_t testRoundRects()
+{
+  int32_t ops = 0;
+  for (int32_t i = 20; i < n1; i += 6, ++ops)
+  {
+    gfx->drawRoundRect(cx - i / 2, cy - i / 2, i, i, i / 8, gfx->color565(i, 0, 0));
+  }
+  return ops;
+}
+
+int32_t testBitmaps()
+{
+  int32_t ops = 0;
+  for (int32_t y = -24; y < h; y += 48)
+  {
+    for (int32_t x = -32; x < w; x += 64)
+    {
+      switch (ops++ % 3)
+      {
+      case 0:
+        gfx->draw16bitRGBBitmap(x, y, bitmap16, 64, 48);
+        break;
+      case 1:
+        gfx->drawBitmap(x, y, bitmap1, 64, 48, RGB565_YELLOW, RGB565_NAVY);
+        break;
+      default:
+        gfx->drawIndexedBitmap(x, y, bitmap8, palette, 64, 48);
+        break;
+      }
+    }
+  }
+  return ops;
+}
+
+int32_t testConvertBitmaps()
+{
+  // odd sizes and positions on and across the screen edges, through the
+  // display and through a canvas covering the lower third
+  static Arduino_Canvas *canvas = nullptr;
+  if (!canvas)
+  {
+    canvas = new Arduino_Canvas(w, h / 3, gfx, 0, h - (h / 3));
+    canvas->begin(GFX_SKIP_OUTPUT_BEGIN);
+  }
+  int32_t ops = 0;
+  for (uint8_t pass = 0; pass < 2; ++pass)
+  {
+    Arduino_GFX *g = pass ? (Arduino_GFX *)canvas : (Arduino_GFX *)gfx;
+    if (pass)
+    {
+      canvas->fillScreen(RGB565_BLACK);
+    }
+    for (int32_t y = -19 + pass * 7; y < g->height(); y += 41)
+    {
+      for (int32_t x = -31 + pass * 5; x < g->width(); x += 67)
+      {
+        switch (ops++ % 8)
+        {
+        case 0:
+          g->draw24bitRGBBitmap(x, y, bitmap24, 61, 37);
+          break;
+        case 1:
+          g->draw24bitRGBBitmap(x, y, (const uint8_t *)bitmap24, 61, 37);
+          break;
+        case 2:
+          g->drawGrayscaleBitmap(x, y, bitmapGray, 61, 37);
+          break;
+        case 3:
+          g->drawGrayscaleBitmap(x, y, (const uint8_t *)bitmapGray, 61, 37);
+          break;
+        case 4:
+          g->drawIndexedBitmap(x, y, bitmapIdx, palette, 61, 37);
+          break;
+        case 5:
+          g->drawIndexedBitmap(x, y, bitmapIdx + 3, palette, (int16_t)53, (int16_t)37, (int16_t)8);
+          break;
+        case 6:
+          g->draw16bitBeRGBBitmap(x, y, bitmapBe, 61, 37);
+          break;
+        default:
+          g->draw24bitRGBBitmap(x, y, bitmap24 + 3, 60, 36);
+          break;
+        }
+      }
+    }
+    if (pass)
+    {
+      canvas->flush(true);
+    }
+  }
+  return ops;
+}
+
+// synthetic decoder output, stands in for JPEGDEC MCU blocks / PNGdec rows
+uint16_t imagePixel(int32_t x, int32_t y)
+{
+  return ((x * 3 + y) & 0xF8) << 8 | (((x ^ y) & 0xFC) << 3) | ((y * 5 - x) & 0xFF) >> 3;
+}
+
+void imageBlock(uint16_t *block, int32_t x, int32_t y, int32_t bw, int32_t bh, bool big_endian)
+{
+  for (int32_t j = 0; j < bh; ++j)
+  {
+    for (int32_t i = 0; i < bw; ++i)
+    {
+      uint16_t p = imagePixel(x + i, y + j);
+      block[j * bw + i] = big_endian ? MSB_16(p) : p;
+    }
+  }
+}
+
+int32_t testImageBlocks()
+{
+  // each 16x16 MCU drawn on its own, as the ImgViewer examples do
+  static uint16_t block[16 * 16];
+  int32_t ops = 0;
+  for (int32_t y = 0; y < h; y += 16)
+  {
+    for (int32_t x = 0; x < w; x += 16, ++ops)
+    {
+      imageBlock(block, x, y, 16, 16, true);
+      gfx->draw16bitBeRGBBitmap(x, y, block, 16, 16);
+    }
+  }
+  return ops;
+}
+
+int32_t testImagePipeline()
+{
+  // same MCUs assembled into full width bands, same pixels as image_blocks
+  static uint16_t block[16 * 16];
+  static Arduino_ImagePipeline *pipeline = nullptr;
+  if (!pipeline)
+  {
+    pipeline = new Arduino_ImagePipeline(gfx, 16);
+  }
+  int32_t ops = 0;
+  pipeline->begin(0, 0, w, h, 0, true);
+  for (int32_t y = 0; y < h; y += 16)
+  {
+    for (int32_t x = 0; x < w; x += 16, ++ops)
+    {
+      imageBlock(block, x, y, 16, 16, true);
+      pipeline->drawBlock(x, y, block, 16, 16);
+    }
+  }
+  pipeline->end();
+  return ops;
+}
+
+int32_t testImageHalf()
+{
+  // PNG like rows of a double size image, averaged down to the screen
+  static uint16_t row[GRAM_H * 2];
+  static Arduino_ImagePipeline *pipeline = nullptr;
+  if (!pipeline)
+  {
+    pipeline = new Arduino_ImagePipeline(gfx, 16);
+  }
+  pipeline->begin(0, 0, w * 2, h * 2, 1);
+  for (int32_t y = 0; y < h * 2; ++y)
+  {
+    imageBlock(row, 0, y, w * 2, 1, false);
+    pipeline->drawRow(y, row, w * 2);
+  }
+  pipeline->end();
+  return h * 2;
+}
+
+int32_t testCanvasFlush()
+{
+  // a clock like screen: full frame once, then small changes per flush
+  static Arduino_Canvas *canvas = nullptr;
+  if (!canvas)
+  {
+    canvas = new Arduino_Canvas(w, h, gfx);
+    canvas->begin(GFX_SKIP_OUTPUT_BEGIN);
+  }
+  canvas->fillScreen(RGB565_BLACK);
+  canvas->drawCircle(cx, cy, cn, RGB565_WHITE);
+  canvas->flush(true);
+  canvas->setTextSize(3);
+  canvas->setTextColor(RGB565_WHITE, RGB565_BLACK);
+  char buf[8];
+  for (int32_t s = 0; s < 30; ++s)
+  {
+    snprintf(buf, sizeof(buf), "%02d:%02d", 25 - (s + 1) / 60, (60 - s) % 60);
+    canvas->setCursor(cx - 45, cy - 12);
+    canvas->print(buf);
+    canvas->fillRect(cx - 60, cy + 40, s * 4, 6, RGB565_GREEN);
+    canvas->flush();
+  }
+  return 31;
+}
+
+struct workload_t
+{
+  const char *name;
+  int32_t (*fn)();
+};
+
+workload_t workloads[] = {
+    {"fill_screen", testFillScreen},
+    {"text", testText},
+    {"pixels", testPixels},
+    {"lines", testLines},
+    {"hv_lines", testFastLines},
+    {"filled_rects", testFilledRects},
+    {"rects", testRects},
+    {"filled_circles", testFilledCircles},
+    {"circles", testCircles},
+    {"filled_arcs", testFillArcs},
+    {"arcs", testArcs},
+    {"filled_triangles", testFilledTriangles},
+    {"triangles", testTriangles},
+    {"filled_round_rects", testFilledRoundRects},
+    {"round_rects", testRoundRects},
+    {"bitmaps", testBitmaps},
+    {"convert_bitmaps", testConvertBitmaps},
+    {"image_blocks", testImageBlocks},
+    {"image_pipeline", testImagePipeline},
+    {"image_half", testImageHalf},
+    {"canvas_flush", testCanvasFlush},
+};
+
+uint32_t hashGram(uint16_t *gram)
+{
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (uint32_t i = 0; i < GRAM_W * GRAM_H; ++i)
+  {
+    hash = (hash ^ (gram[i] & 0xFF)) * 16777619u;
+    hash = (hash ^ (gram[i] >> 8)) * 16777619u;
+  }
+  return hash;
+}
+
+bool writePPM(const char *path, uint16_t *gram)
+{
+  FILE *f = fopen(path, "wb");
+  if (!f)
+  {
+    return false;
+  }
+  fprintf(f, "P6\n%d %d\n255\n", GRAM_W, GRAM_H);
+  for (uint32_t i = 0; i < GRAM_W * GRAM_H; ++i)
+  {
+    uint16_t p = gram[i];
+    uint8_t rgb[3] = {(uint8_t)(((p >> 11) & 0x1F) * 255 / 31), (uint8_t)(((p >> 5) & 0x3F) * 255 / 63), (uint8_t)((p & 0x1F) * 255 / 31)};
+    fwrite(rgb, 1, 3, f);
+  }
+  fclose(f);
+  return true;
+}
+
+void initBitmaps()
+{
+  for (int y = 0; y < 48; ++y)
+  {
+    for (int x = 0; x < 64; ++x)
+    {
+      bitmap16[y * 64 + x] = gfx->color565(x * 4, y * 5, (x ^ y) * 4);
+      bitmap8[y * 64 + x] = (x / 8) + (y / 6) * 8;
+      if (((x / 4) + (y / 4)) & 1)
+      {
+        bitmap1[y * 8 + x / 8] |= 0x80 >> (x & 7);
+      }
+    }
+  }
+  for (int i = 0; i < 61 * 37; ++i)
+  {
+    uint32_t r = i * 2654435761u;
+    bitmap24[i * 3] = r >> 24;
+    bitmap24[i * 3 + 1] = r >> 16;
+    bitmap24[i * 3 + 2] = (i * 7) & 0xFF;
+    bitmapGray[i] = (r >> 8) ^ i;
+    bitmapIdx[i] = r >> 20;
+    bitmapBe[i] = (r >> 16) ^ (r & 0xFFFF);
+  }
+  for (int i = 0; i < 256; ++i)
+  {
+    palette[i] = gfx->color565(i * 3, 255 - i * 2, i * 5);
+  }
+}
+
+// per pixel conversion as the bitmap draw functions did before the row kernels
+uint16_t convertPixel(uint8_t format, const uint8_t *src, uint32_t i)
+{
+  uint16_t p;
+  switch (format)
+  {
+  case GFX_CONVERT_RGB888:
+    return gfx->color565(src[i * 3], src[i * 3 + 1], src[i * 3 + 2]);
+  case GFX_CONVERT_GRAY8:
+    return gfx->color565(src[i], src[i], src[i]);
+  case GFX_CONVERT_RGB565BE:
+    p = ((const uint16_t *)src)[i];
+    return MSB_16(p);
+  default: // GFX_CONVERT_INDEXED
+    return palette[src[i]];
+  }
+}
+
+static const char *format_names[] = {"rgb888", "gray8", "rgb565be", "indexed"};
+
+// every format, source and destination alignment and length up to a few
+// word loops, the pixel after the run must stay untouched
+int checkKernels()
+{
+  static uint8_t src[80 * 3 + 8] __attribute__((aligned(4)));
+  static uint16_t out[80 + 4] __attribute__((aligned(4)));
+  for (uint32_t i = 0; i < sizeof(src); ++i)
+  {
+    src[i] = (i * 2654435761u) >> 13;
+  }
+  int failed = 0;
+  for (uint8_t format = 0; format < 4; ++format)
+  {
+    for (uint8_t src_ofs = 0; src_ofs < 4; src_ofs += (format == GFX_CONVERT_RGB565BE) ? 2 : 1)
+    {
+      for (uint8_t dst_ofs = 0; dst_ofs < 2; ++dst_ofs)
+      {
+        for (uint32_t len = 0; len <= 70; ++len)
+        {
+          memset(out, 0xA5, sizeof(out));
+          gfx_convert_row(format, out + dst_ofs, src + src_ofs, palette, len);
+          for (uint32_t i = 0; i <= len; ++i)
+          {
+            uint16_t expect = (i < len) ? convertPixel(format, src + src_ofs, i) : 0xA5A5;
+            if (out[dst_ofs + i] != expect)
+            {
+              if (!failed)
+              {
+                printf("kernel %s src+%d dst+%d len %lu: pixel %lu is %04x, expected %04x\n",
+                       format_names[format], src_ofs, dst_ofs, (unsigned long)len, (unsigned long)i, out[dst_ofs + i], expect);
+              }
+              ++failed;
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+  printf("kernels: %s\n", failed ? "MISMATCH" : "ok");
+  return failed ? 1 : 0;
+}
+
+void benchKernels()
+{
+  static uint8_t src[GFX_CONVERT_BUF_PIXELS * 3] __attribute__((aligned(4)));
+  static uint16_t out[GFX_CONVERT_BUF_PIXELS] __attribute__((aligned(4)));
+  const uint32_t rounds = 100000;
+  for (uint32_t i = 0; i < sizeof(src); ++i)
+  {
+    src[i] = i * 37;
+  }
+  printf("\n%-10s %14s %14s %8s\n", "kernel", "pixel Mpx/s", "row Mpx/s", "speedup");
+  for (uint8_t format = 0; format < 4; ++format)
+  {
+    volatile uint16_t sink = 0;
+    unsigned long t0 = micros();
+    for (uint32_t r = 0; r < rounds; ++r)
+    {
+      for (uint32_t i = 0; i < GFX_CONVERT_BUF_PIXELS; ++i)
+      {
+        out[i] = convertPixel(format, src, i);
+      }
+      sink = sink + out[r % GFX_CONVERT_BUF_PIXELS];
+    }
+    unsigned long t1 = micros();
+    for (uint32_t r = 0; r < rounds; ++r)
+    {
+      gfx_convert_row(format, out, src, palette, GFX_CONVERT_BUF_PIXELS);
+      sink = sink + out[r % GFX_CONVERT_BUF_PIXELS];
+    }
+    unsigned long t2 = micros();
+    double px = (double)rounds * GFX_CONVERT_BUF_PIXELS;
+    double pixel_us = (t1 > t0) ? (t1 - t0) : 1;
+    double row_us = (t2 > t1) ? (t2 - t1) : 1;
+    printf("%-10s %14.1f %14.1f %7.2fx\n", format_names[format], px / pixel_us, px / row_us, pixel_us / row_us);
+  }
+}
+
+// flush callback that only remembers the band and copies it in the wait
+// callback, like a DMA transfer still reading the buffer after flush returns
+struct deferred_flush_t
+{
+  uint16_t *fb;
+  int16_t fb_w;
+  uint16_t *band;
+  int16_t x, y, w, h;
+};
+
+void deferredFlush(void *user, int16_t x, int16_t y, uint16_t *band, int16_t w, int16_t h)
+{
+  deferred_flush_t *d = (deferred_flush_t *)user;
+  d->band = band;
+  d->x = x;
+  d->y = y;
+  d->w = w;
+  d->h = h;
+}
+
+void deferredWait(void *user)
+{
+  deferred_flush_t *d = (deferred_flush_t *)user;
+  for (int16_t j = 0; j < d->h; ++j)
+  {
+    memcpy(d->fb + (d->y + j) * d->fb_w + d->x, d->band + j * d->w, d->w * 2);
+  }
+  // a reused buffer must not be read again
+  memset(d->band, 0, d->w * d->h * 2);
+  d->h = 0;
+}
+
+// downscaled output through the asynchronous callbacks against a plain
+// box average of the source
+int checkImagePipeline()
+{
+  const int16_t sw = 101, sh = 77;
+  static uint16_t fb[sw * sh];
+  static uint16_t block[8 * 8];
+  int failed = 0;
+  for (uint8_t shift = 0; shift <= IMAGEPIPELINE_MAX_SCALE_SHIFT; ++shift)
+  {
+    for (uint8_t be = 0; be < 2; ++be)
+    {
+      int16_t ow = sw >> shift, oh = sh >> shift;
+      deferred_flush_t d = {fb, ow, nullptr, 0, 0, 0, 0};
+      Arduino_ImagePipeline pipeline(gfx, 5, true);
+      pipeline.setFlushCallback(deferredFlush, deferredWait, &d);
+      memset(fb, 0xA5, sizeof(fb));
+      pipeline.begin(0, 0, sw, sh, shift, be);
+      for (int16_t y = 0; y < sh; y += 8)
+      {
+        for (int16_t x = 0; x < sw; x += 8)
+        {
+          int16_t bw = (sw - x < 8) ? (sw - x) : 8;
+          int16_t bh = (sh - y < 8) ? (sh - y) : 8;
+          imageBlock(block, x, y, bw, bh, be);
+          pipeline.drawBlock(x, y, block, bw, bh);
+        }
+      }
+      pipeline.end();
+
+      uint8_t n = 1 << shift;
+      for (int16_t y = 0; (y < oh) && (!failed); ++y)
+      {
+        for (int16_t x = 0; x < ow; ++x)
+        {
+          uint32_t r = 0, g = 0, b = 0;
+          for (uint8_t j = 0; j < n; ++j)
+          {
+            for (uint8_t i = 0; i < n; ++i)
+            {
+              uint16_t p = imagePixel(x * n + i, y * n + j);
+              r += p >> 11;
+              g += (p >> 5) & 0x3F;
+              b += p & 0x1F;
+            }
+          }
+          uint32_t nn = n * n;
+          uint16_t expect = (((r + nn / 2) / nn) << 11) | (((g + nn / 2) / nn) << 5) | ((b + nn / 2) / nn);
+          uint16_t got = fb[y * ow + x];
+          if (be)
+          {
+            got = MSB_16(got);
+          }
+          if (got != expect)
+          {
+            printf("image pipeline shift %d %s (%d, %d): %04x, expected %04x\n", shift, be ? "be" : "le", x, y, got, expect);
+            ++failed;
+            break;
+          }
+        }
+      }
+    }
+  }
+  printf("image pipeline: %s\n", failed ? "MISMATCH" : "ok");
+  return failed ? 1 : 0;
+}
+
+// compare the trace recorded since start with the expected records
+int checkTrace(const char *name, uint32_t start, const uint8_t *expect, uint32_t len)
+{
+  uint32_t got = bus->getTraceLength() - start;
+  if ((got != len) || (len && memcmp(bus->getTrace() + start, expect, len)))
+  {
+    printf("panel modes %s: trace mismatch\n", name);
+    return 1;
+  }
+  return 0;
+}
+
+// scroll, partial and idle mode command sequences, on the benchmark panel
+// and on a 240x280 panel at frame memory row 20
+int checkPanelModes()
+{
+  int failed = 0;
+  uint32_t start;
+
+  start = bus->getTraceLength();
+  failed += !gfx->setScrollArea(10, 20);
+  const uint8_t scroll_area[] = {RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x33, RECORDBUS_DATA, 6, 0x00, 10, 0x01, 0x22, 0x00, 20, RECORDBUS_END_WRITE};
+  failed += checkTrace("scroll area", start, scroll_area, sizeof(scroll_area));
+
+  start = bus->getTraceLength();
+  gfx->scrollTo(300);
+  const uint8_t scroll[] = {RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x37, RECORDBUS_DATA, 2, 0x00, 20, RECORDBUS_END_WRITE};
+  failed += checkTrace("scroll", start, scroll, sizeof(scroll));
+
+  start = bus->getTraceLength();
+  failed += gfx->setScrollArea(200, 120);
+  failed += checkTrace("scroll area too big", start, nullptr, 0);
+
+  start = bus->getTraceLength();
+  failed += !gfx->partialDisplay(100, 50);
+  gfx->normalDisplay();
+  const uint8_t partial[] = {RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x30, RECORDBUS_DATA, 4, 0x00, 100, 0x00, 149, RECORDBUS_COMMAND, 0x12, RECORDBUS_END_WRITE,
+                             RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x13, RECORDBUS_END_WRITE};
+  failed += checkTrace("partial", start, partial, sizeof(partial));
+
+  start = bus->getTraceLength();
+  gfx->idleDisplay(true);
+  gfx->idleDisplay(false);
+  const uint8_t idle[] = {RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x39, RECORDBUS_END_WRITE,
+                          RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x38, RECORDBUS_END_WRITE};
+  failed += checkTrace("idle", start, idle, sizeof(idle));
+
+  Arduino_ST7789 panel280(bus, GFX_NOT_DEFINED, 0, true, 240, 280, 0, 20, 0, 20);
+  start = bus->getTraceLength();
+  failed += !panel280.setScrollArea(0, 0);
+  panel280.scrollTo(1);
+  failed += !panel280.partialDisplay(0, 280);
+  const uint8_t offset[] = {RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x33, RECORDBUS_DATA, 6, 0x00, 20, 0x01, 0x18, 0x00, 20, RECORDBUS_END_WRITE,
+                            RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x37, RECORDBUS_DATA, 2, 0x00, 21, RECORDBUS_END_WRITE,
+                            RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x30, RECORDBUS_DATA, 4, 0x00, 20, 0x01, 0x2B, RECORDBUS_COMMAND, 0x12, RECORDBUS_END_WRITE};
+  failed += checkTrace("row offset", start, offset, sizeof(offset));
+
+  gfx->normalDisplay();
+  gfx->scrollTo(0);
+  printf("panel modes: %s\n", failed ? "MISMATCH" : "ok");
+  return failed ? 1 : 0;
+}
+
+// the benchmark panel and a 240x280 module at row 20 for Arduino_TFT_T
+struct HostPanelTraits : ST7789Traits
+{
+  static constexpr bool IPS = true;
+};
+
+struct Host280PanelTraits : HostPanelTraits
+{
+  static constexpr int16_t HEIGHT = 280;
+  static constexpr uint8_t ROW_OFFSET1 = 20, ROW_OFFSET2 = 20;
+};
+
+// data bus that only folds the bytes into a checksum, measures the cost of
+// the calls down to the bus
+class CountBus final : public Arduino_DataBus
+{
+public:
+  bool begin(int32_t, int8_t) override { return true; }
+  void beginWrite() override { ++sum; }
+  void endWrite() override { sum += 2; }
+  void writeCommand(uint8_t c) override { sum = sum * 31 + c; }
+  void writeCommand16(uint16_t c) override { sum = sum * 31 + c; }
+  void writeCommandBytes(uint8_t *data, uint32_t len) override
+  {
+    while (len--)
+    {
+      sum = sum * 31 + *data++;
+    }
+  }
+  void write(uint8_t d) override { sum = sum * 31 + d; }
+  void write16(uint16_t d) override { sum = sum * 31 + d; }
+  void writeC8D16D16(uint8_t c, uint16_t d1, uint16_t d2) override { sum = ((sum * 31 + c) * 31 + d1) * 31 + d2; }
+  void writeRepeat(uint16_t p, uint32_t len) override { sum = sum * 31 + p * len; }
+  void writeBytes(uint8_t *data, uint32_t len) override { writeCommandBytes(data, len); }
+  void writePixels(uint16_t *data, uint32_t len) override
+  {
+    while (len--)
+    {
+      sum = sum * 31 + *data++;
+    }
+  }
+
+  uint32_t sum = 0;
+};
+
+// primitives with clipping, negative sizes, batched rows and the Arduino_GFX
+// functions built on top of them
+template <class G>
+void drawPrimitives(G *g)
+{
+  int16_t gw = g->width(), gh = g->height();
+  for (int16_t i = -3; i < 40; ++i)
+  {
+    g->drawPixel(i * 7 - 10, i * 11 - 20, RGB565(i * 6, 255 - i * 6, i));
+  }
+  for (int16_t i = 0; i < 30; ++i)
+  {
+    g->drawFastHLine(i * 9 - 30, i * 13 - 15, (i & 1) ? -i * 5 : i * 5, RGB565(255, i * 8, 0));
+    g->drawFastVLine(i * 11 - 20, i * 7 - 30, (i & 1) ? i * 6 : -i * 6, RGB565(0, i * 8, 255));
+    g->fillRect(i * 10 - 25, gh - i * 12, (i % 3 - 1) * 17, (i % 5 - 2) * 9, RGB565(i * 8, 0, 255 - i * 8));
+  }
+  g->startWrite();
+  for (int16_t y = 40; y < 90; ++y)
+  {
+    g->writeFastHLine(20, y, 50, RGB565(y, 128, 255 - y));
+  }
+  g->endWrite();
+  g->drawLine(-10, -10, gw + 10, gh + 10, RGB565_WHITE);
+  g->fillCircle(gw / 2, gh / 2, 40, RGB565_YELLOW);
+  g->drawRoundRect(5, 5, gw - 10, gh - 10, 12, RGB565_CYAN);
+  g->setCursor(10, gh / 3);
+  g->setTextColor(RGB565_MAGENTA, RGB565_NAVY);
+  g->print("Arduino_TFT_T");
+  g->draw16bitRGBBitmap(gw - 50, 30, bitmap16, 64, 48);
+}
+
+template <class Panel>
+int checkTemplatePanel(const char *name, int16_t panel_h, uint8_t row_offset)
+{
+  int failed = 0;
+  Arduino_RecordBus virtual_bus(GRAM_W, GRAM_H, 1024 * 1024);
+  Arduino_RecordBus template_bus(GRAM_W, GRAM_H, 1024 * 1024);
+  Arduino_ST7789 virtual_gfx(&virtual_bus, GFX_NOT_DEFINED, 0, true, GRAM_W, panel_h, 0, row_offset, 0, row_offset);
+  Arduino_TFT_T<Panel, Arduino_RecordBus> template_gfx(&template_bus, GFX_NOT_DEFINED, 0);
+  virtual_gfx.begin();
+  template_gfx.begin();
+  for (uint8_t r = 0; r < 4; ++r)
+  {
+    virtual_gfx.setRotation(r);
+    template_gfx.setRotation(r);
+    uint32_t start_virtual = virtual_bus.getTraceLength();
+    uint32_t start_template = template_bus.getTraceLength();
+    drawPrimitives((Arduino_GFX *)&virtual_gfx);
+    drawPrimitives(&template_gfx);
+    drawPrimitives((Arduino_GFX *)&virtual_gfx);
+    drawPrimitives((Arduino_GFX *)&template_gfx);
+    uint32_t len = virtual_bus.getTraceLength() - start_virtual;
+    if (virtual_bus.isTraceOverflow() || template_bus.isTraceOverflow() || (template_bus.getTraceLength() - start_template != len) || memcmp(virtual_bus.getTrace() + start_virtual, template_bus.getTrace() + start_template, len))
+    {
+      printf("template %s rotation %d: trace mismatch\n", name, r);
+      ++failed;
+    }
+  }
+  return failed;
+}
+
+// Arduino_TFT_T must send the same bytes as the virtual class hierarchy,
+// through its own type and through an Arduino_GFX pointer
+int checkTemplate()
+{
+  int failed = checkTemplatePanel<HostPanelTraits>("240x320", GRAM_H, 0);
+  failed += checkTemplatePanel<Host280PanelTraits>("240x280", 280, 20);
+  printf("template front end: %s\n", failed ? "MISMATCH" : "ok");
+  return failed ? 1 : 0;
+}
+
+template <class G>
+double benchPrimitive(G *g, uint8_t primitive, uint32_t rounds)
+{
+  unsigned long t0 = micros();
+  for (uint32_t i = 0; i < rounds; ++i)
+  {
+    int16_t x = i % 200, y = (i >> 3) % 300;
+    switch (primitive)
+    {
+    case 0:
+      g->drawPixel(x, y, i);
+      break;
+    case 1:
+      g->drawFastHLine(x, y, 16, i);
+      break;
+    default:
+      g->fillRect(x, y, 4, 4, i);
+    }
+  }
+  unsigned long t1 = micros();
+  return (double)((t1 > t0) ? (t1 - t0) : 1) * 1000 / rounds;
+}
+
+// per call cost of the virtual class hierarchy against Arduino_TFT_T, both
+// on a bus that does almost no work
+void benchTemplate()
+{
+  const char *names[] = {"drawPixel", "drawFastHLine", "fillRect"};
+  const uint32_t rounds = 2000000;
+  CountBus *virtual_bus = new CountBus();
+  CountBus *template_bus = new CountBus();
+  Arduino_GFX *virtual_gfx = new Arduino_ST7789(virtual_bus, GFX_NOT_DEFINED, 0, true, GRAM_W, GRAM_H);
+  Arduino_TFT_T<HostPanelTraits, CountBus> *template_gfx = new Arduino_TFT_T<HostPanelTraits, CountBus>(template_bus);
+  virtual_gfx->begin();
+  template_gfx->begin();
+  printf("\n%-14s %14s %14s %8s\n", "primitive", "virtual ns", "template ns", "speedup");
+  for (uint8_t p = 0; p < 3; ++p)
+  {
+    double virtual_ns = benchPrimitive(virtual_gfx, p, rounds);
+    double template_ns = benchPrimitive(template_gfx, p, rounds);
+    printf("%-14s %14.1f %14.1f %7.2fx\n", names[p], virtual_ns, template_ns, virtual_ns / template_ns);
+  }
+  if (virtual_bus->sum != template_bus->sum)
+  {
+    printf("template bench: bus checksum differs\n");
+  }
+  delete virtual_gfx;
+  delete template_gfx;
+  delete virtual_bus;
+  delete template_bus;
+}
+
+// one second of a panel with TE pulses every te_period us (0 if not wired)
+// until te_stop_us, frames that take busy_us to send and every late_every
+// frame late_us longer, polled every 50 us like waitFrame()
+gfx_frame_stats_t simulatePacer(Arduino_FramePacer *pacer, uint32_t te_period, uint32_t te_stop_us, uint32_t busy_us, uint32_t late_every, uint32_t late_us, uint32_t *max_start_delay)
+{
+  const uint32_t t0 = 1000, t1 = t0 + 1000000;
+  uint32_t te_next = t0 + 3000, te_last = 0, done = 0, k = 0;
+  bool busy = false;
+  *max_start_delay = 0;
+  pacer->begin();
+  for (uint32_t t = t0; t < t1; t += 50)
+  {
+    while (te_period && (te_next <= t) && (te_next < te_stop_us))
+    {
+      pacer->teEdge(te_next);
+      te_last = te_next;
+      te_next += te_period + ((k++ * 37) % 41) - 20; // +-20 us jitter
+    }
+    if (busy && (t >= done))
+    {
+      pacer->frameDone(t);
+      busy = false;
+    }
+    if ((!busy) && pacer->frameDue(t))
+    {
+      if (pacer->isTeActive(t) && ((t - te_last) > *max_start_delay))
+      {
+        *max_start_delay = t - te_last;
+      }
+      pacer->frameStart(t);
+      busy = true;
+      done = t + busy_us;
+      if (late_every && ((pacer->getStats().frames % late_every) == 0))
+      {
+        done += late_us;
+      }
+    }
+  }
+  return pacer->getStats();
+}
+
+bool inRange(uint32_t v, uint32_t lo, uint32_t hi)
+{
+  return (v >= lo) && (v <= hi);
+}
+
+// frame scheduling against a simulated TE source, and the TEON / TEOFF bytes
+int checkFramePacer()
+{
+  int failed = 0;
+  uint32_t delay;
+  gfx_frame_stats_t s;
+
+  // 30 fps on a 60 Hz panel, every start right after a pulse
+  Arduino_FramePacer te30(33333, 5);
+  s = simulatePacer(&te30, 16667, UINT32_MAX, 8000, 0, 0, &delay);
+  failed += !(inRange(s.frames, 29, 31) && (s.missed == 0) && (delay <= 16667 / 4) && inRange(s.te_period_us, 16620, 16710) && inRange(s.min_frame_us, 33200, 33450) && inRange(s.max_frame_us, 33200, 33450) && inRange(s.last_busy_us, 8000, 8050));
+  printf("frame pacer te 30 fps:      %3lu frames, %lu missed, %lu-%lu us, start %lu us after TE\n", (unsigned long)s.frames, (unsigned long)s.missed, (unsigned long)s.min_frame_us, (unsigned long)s.max_frame_us, (unsigned long)delay);
+
+  // 60 fps with every 10th frame too slow, each costs one TE period
+  Arduino_FramePacer te60(16667, 5);
+  s = simulatePacer(&te60, 16667, UINT32_MAX, 8000, 10, 15000, &delay);
+  failed += !(inRange(s.missed, 4, 6) && inRange(s.frames + s.missed, 58, 61) && (delay <= 16667 / 4) && inRange(s.max_busy_us, 23000, 23050));
+  printf("frame pacer te 60 fps late: %3lu frames, %lu missed, %lu-%lu us, start %lu us after TE\n", (unsigned long)s.frames, (unsigned long)s.missed, (unsigned long)s.min_frame_us, (unsigned long)s.max_frame_us, (unsigned long)delay);
+
+  // TE stops, software pacing takes over after the timeout
+  Arduino_FramePacer te_lost(16667, 5);
+  s = simulatePacer(&te_lost, 16667, 300000, 8000, 0, 0, &delay);
+  failed += !(inRange(s.frames, 55, 60) && (s.max_frame_us <= 16667 * (FRAMEPACER_TE_TIMEOUT_FRAMES + 1)) && (!te_lost.isTeActive(1001000)));
+  printf("frame pacer te lost:        %3lu frames, %lu missed, %lu-%lu us\n", (unsigned long)s.frames, (unsigned long)s.missed, (unsigned long)s.min_frame_us, (unsigned long)s.max_frame_us);
+
+  // no TE wired, software pacing keeps the frame time
+  Arduino_FramePacer soft(33333);
+  s = simulatePacer(&soft, 0, 0, 8000, 0, 0, &delay);
+  failed += !(inRange(s.frames, 30, 31) && (s.missed == 0) && inRange(s.min_frame_us, 33300, 33400) && inRange(s.max_frame_us, 33300, 33400) && (s.te_edges == 0));
+  printf("frame pacer software:       %3lu frames, %lu missed, %lu-%lu us\n", (unsigned long)s.frames, (unsigned long)s.missed, (unsigned long)s.min_frame_us, (unsigned long)s.max_frame_us);
+
+  uint32_t start = bus->getTraceLength();
+  Arduino_FramePacer te_gfx(16667, 5);
+  te_gfx.begin(gfx);
+  te_gfx.end();
+  const uint8_t te[] = {RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x35, RECORDBUS_DATA, 1, 0x00, RECORDBUS_END_WRITE,
+                        RECORDBUS_BEGIN_WRITE, RECORDBUS_COMMAND, 0x34, RECORDBUS_END_WRITE};
+  failed += checkTrace("tearing effect", start, te, sizeof(te));
+
+  printf("frame pacer: %s\n", failed ? "MISMATCH" : "ok");
+  return failed ? 1 : 0;
+}
+
+// band queue harness: the producer fills each band with a pattern of its
+// frame and band number, the consumer checks the order and reads every band
+// in 2 halves with a random pause between, so a buffer handed back to the
+// producer too early shows up as a changed second half
+#define QUEUE_BAND_W 64
+#define QUEUE_BAND_H 8
+#define QUEUE_BANDS 10
+#define QUEUE_FRAMES 300
+
+static uint32_t xorshift(uint32_t *state)
+{
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+static void randomPause(uint32_t *state)
+{
+  uint32_t n = xorshift(state) % 64;
+  if (n > 48)
+  {
+    sched_yield();
+  }
+  for (volatile uint32_t i = 0; i < n * 16; ++i)
+  {
+  }
+}
+
+static uint16_t queuePattern(uint32_t frame, uint32_t band, uint32_t i)
+{
+  return (frame * 131) + (band * 17) + i;
+}
+
+class QueueCheckOutput : public Arduino_G
+{
+public:
+  QueueCheckOutput() : Arduino_G(QUEUE_BAND_W, QUEUE_BAND_H * QUEUE_BANDS) {}
+  bool begin(int32_t) override { return true; }
+  void drawBitmap(int16_t, int16_t, uint8_t *, int16_t, int16_t, uint16_t, uint16_t) override {}
+  void drawIndexedBitmap(int16_t, int16_t, uint8_t *, uint16_t *, int16_t, int16_t, int16_t) override {}
+  void draw3bitRGBBitmap(int16_t, int16_t, uint8_t *, int16_t, int16_t) override {}
+  void draw24bitRGBBitmap(int16_t, int16_t, uint8_t *, int16_t, int16_t) override {}
+  void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override
+  {
+    uint32_t frame = received / QUEUE_BANDS, band = received % QUEUE_BANDS;
+    if ((x != 0) || (y != (int16_t)(band * QUEUE_BAND_H)) || (w != QUEUE_BAND_W) || (h != QUEUE_BAND_H))
+    {
+      ++order_errors;
+    }
+    const uint32_t len = QUEUE_BAND_W * QUEUE_BAND_H;
+    for (uint32_t i = 0; i < len; ++i)
+    {
+      if (i == len / 2)
+      {
+        randomPause(&rng);
+      }
+      if (bitmap[i] != queuePattern(frame, band, i))
+      {
+        ++data_errors;
+        break;
+      }
+    }
+    ++received;
+  }
+
+  uint32_t received = 0;
+  uint32_t order_errors = 0;
+  uint32_t data_errors = 0;
+  uint32_t rng = 0x9E3779B9;
+};
+
+typedef struct
+{
+  Arduino_BandQueue *queue;
+  volatile bool stop;
+} queue_consumer_t;
+
+static void *queueConsumer(void *param)
+{
+  queue_consumer_t *c = (queue_consumer_t *)param;
+  while (!__atomic_load_n(&c->stop, __ATOMIC_ACQUIRE))
+  {
+    if (!c->queue->pump())
+    {
+      sched_yield();
+    }
+  }
+  while (c->queue->pump())
+  {
+  }
+  return nullptr;
+}
+
+static void startConsumer(queue_consumer_t *c, pthread_t *thread, Arduino_BandQueue *queue)
+{
+  c->queue = queue;
+  c->stop = false;
+  pthread_create(thread, nullptr, queueConsumer, c);
+}
+
+static void stopConsumer(queue_consumer_t *c, pthread_t thread)
+{
+  __atomic_store_n(&c->stop, true, __ATOMIC_RELEASE);
+  pthread_join(thread, nullptr);
+}
+
+int checkBandQueueRun(uint8_t buffers, uint8_t mode)
+{
+  QueueCheckOutput output;
+  Arduino_BandQueue queue(&output, buffers);
+  queue_consumer_t consumer;
+  pthread_t thread;
+  uint32_t rng = 0x2545F491 + buffers;
+  queue.begin(QUEUE_BAND_W * QUEUE_BAND_H, mode);
+  if (mode == BANDQUEUE_EXTERNAL)
+  {
+    startConsumer(&consumer, &thread, &queue);
+  }
+  for (uint32_t frame = 0; frame < QUEUE_FRAMES; ++frame)
+  {
+    for (uint32_t band = 0; band < QUEUE_BANDS; ++band)
+    {
+      uint16_t *buf = queue.acquire();
+      for (uint32_t i = 0; i < QUEUE_BAND_W * QUEUE_BAND_H; ++i)
+      {
+        buf[i] = queuePattern(frame, band, i);
+      }
+      randomPause(&rng);
+      queue.submit(buf, 0, band * QUEUE_BAND_H, QUEUE_BAND_W, QUEUE_BAND_H);
+    }
+  }
+  queue.flush();
+  bandqueue_stats_t stats = queue.getStats();
+  if (mode == BANDQUEUE_EXTERNAL)
+  {
+    stopConsumer(&consumer, thread);
+  }
+  bool ok = (output.received == QUEUE_FRAMES * QUEUE_BANDS) && (!output.order_errors) && (!output.data_errors) && (stats.sent == stats.submitted);
+  printf("band queue %s %d buffers: %lu bands, %lu order errors, %lu data errors, %lu producer waits\n",
+         (mode == BANDQUEUE_EXTERNAL) ? "thread     " : "cooperative", buffers, (unsigned long)output.received,
+         (unsigned long)output.order_errors, (unsigned long)output.data_errors, (unsigned long)stats.producer_waits);
+  return ok ? 0 : 1;
+}
+
+// draw a frame through a strip canvas, rotation 1 so every band touches
+// many primitives
+static void drawStripFrame(Arduino_Canvas_Strip *canvas)
+{
+  canvas->firstPage();
+  do
+  {
+    canvas->fillScreen(RGB565_NAVY);
+    for (int16_t i = 0; i < 40; ++i)
+    {
+      canvas->fillRect(i * 7, i * 5, 30, 20, RGB565(i * 6, 255 - i * 6, 128));
+    }
+    canvas->fillCircle(canvas->width() / 2, canvas->height() / 2, 60, RGB565_ORANGE);
+    canvas->setCursor(10, 10);
+    canvas->setTextColor(RGB565_WHITE);
+    canvas->print("band queue");
+  } while (canvas->nextPage());
+}
+
+// the strip canvas through the queue must produce the same display memory
+// as with its own band buffers
+int checkStripQueue()
+{
+  int failed = 0;
+  Arduino_Canvas_Strip plain(GRAM_W, GRAM_H, gfx, 24, false, 0, 0, 1);
+  plain.begin(GFX_SKIP_OUTPUT_BEGIN);
+  drawStripFrame(&plain);
+  uint32_t expect = hashGram(bus->getFramebuffer());
+
+  for (uint8_t mode = BANDQUEUE_COOPERATIVE; mode <= BANDQUEUE_EXTERNAL; ++mode)
+  {
+    gfx->fillScreen(RGB565_BLACK);
+    Arduino_BandQueue queue(gfx, 3);
+    Arduino_Canvas_Strip canvas(GRAM_W, GRAM_H, gfx, 24, false, 0, 0, 1);
+    queue_consumer_t consumer;
+    pthread_t thread;
+    queue.begin(GRAM_W * 24, mode);
+    canvas.setTransferQueue(&queue);
+    canvas.begin(GFX_SKIP_OUTPUT_BEGIN);
+    if (mode == BANDQUEUE_EXTERNAL)
+    {
+      startConsumer(&consumer, &thread, &queue);
+    }
+    drawStripFrame(&canvas);
+    queue.flush();
+    if (mode == BANDQUEUE_EXTERNAL)
+    {
+      stopConsumer(&consumer, thread);
+    }
+    if (hashGram(bus->getFramebuffer()) != expect)
+    {
+      printf("strip canvas band queue %s: display memory differs\n", (mode == BANDQUEUE_EXTERNAL) ? "thread" : "cooperative");
+      ++failed;
+    }
+  }
+  return failed;
+}
+
+int checkBandQueue()
+{
+  int failed = 0;
+  for (uint8_t buffers = 1; buffers <= BANDQUEUE_MAX_BUFFERS; ++buffers)
+  {
+    failed += checkBandQueueRun(buffers, BANDQUEUE_EXTERNAL);
+  }
+  failed += checkBandQueueRun(2, BANDQUEUE_COOPERATIVE);
+  failed += checkStripQueue();
+  printf("band queue: %s\n", failed ? "MISMATCH" : "ok");
+  return failed ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+  int32_t speed = 40000000;
+  uint32_t transaction_ns = 0;
+  uint8_t rotation = 0;
+  const char *golden = nullptr;
+  const char *update = nullptr;
+  const char *image_dir = nullptr;
+  bool bench_kernels = false;
+  uint32_t decode_ns = 150;
+  int opt;
+  while ((opt = getopt(argc, argv, "s:t:r:g:u:o:kj:")) != -1)
+  {
+    switch (opt)
+    {
+    case 's':
+      speed = atol(optarg);
+      break;
+    case 't':
+      transaction_ns = atol(optarg);
+      break;
+    case 'r':
+      rotation = atoi(optarg);
+      break;
+    case 'g':
+      golden = optarg;
+      break;
+    case 'u':
+      update = optarg;
+      break;
+    case 'o':
+      image_dir = optarg;
+      break;
+    case 'k':
+      bench_kernels = true;
+      break;
+    case 'j':
+      decode_ns = atol(optarg);
+      break;
+    default:
+      fprintf(stderr, "usage: %s [-s spi_hz] [-t transaction_ns] [-r rotation] [-g golden.txt] [-u golden.txt] [-o image_dir] [-k] [-j decode_ns]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  bus = new Arduino_RecordBus(GRAM_W, GRAM_H, TRACE_SIZE);
+  bus->setTransactionOverhead(transaction_ns);
+  gfx = new Arduino_ST7789(bus, GFX_NOT_DEFINED /* RST */, rotation, true /* IPS */, GRAM_W, GRAM_H);
+  if (!gfx->begin(speed))
+  {
+    fprintf(stderr, "gfx->begin() failed!\n");
+    return 2;
+  }
+  w = gfx->width();
+  h = gfx->height();
+  n = (w < h) ? w : h;
+  n1 = n - 1;
+  cx = w / 2;
+  cy = h / 2;
+  cx1 = cx - 1;
+  cy1 = cy - 1;
+  cn = (cx1 < cy1) ? cx1 : cy1;
+  cn1 = cn - 1;
+  initBitmaps();
+
+  uint32_t golden_hash[MAX_WORKLOADS] = {};
+  uint8_t workload_count = sizeof(workloads) / sizeof(workloads[0]);
+  if (golden)
+  {
+    FILE *f = fopen(golden, "r");
+    if (!f)
+    {
+      fprintf(stderr, "cannot open %s\n", golden);
+      return 2;
+    }
+    char name[64];
+    uint32_t hash;
+    while (fscanf(f, "%63s %x", name, &hash) == 2)
+    {
+      for (uint8_t i = 0; i < workload_count; ++i)
+      {
+        if (!strcmp(name, workloads[i].name))
+        {
+          golden_hash[i] = hash;
+        }
+      }
+    }
+    fclose(f);
+  }
+  FILE *update_file = update ? fopen(update, "w") : nullptr;
+
+  printf("ST7789 %dx%d rotation %d, SPI %ld Hz, %lu ns per transaction\n\n", GRAM_W, GRAM_H, rotation, (long)speed, (unsigned long)transaction_ns);
+  printf("%-20s %7s %6s %9s %10s %8s %10s %9s  %-8s\n",
+         "workload", "ops", "trans", "cmd_B", "pixel_B", "cmd/pix", "wire_us", "us/op", "hash");
+  int failed = 0;
+  uint32_t wire_us[MAX_WORKLOADS] = {};
+  for (uint8_t i = 0; i < workload_count; ++i)
+  {
+    gfx->fillScreen(RGB565_BLACK);
+    bus->reset();
+    int32_t ops = workloads[i].fn();
+    recordbus_stats_t stats = bus->getStats();
+    uint32_t us = bus->getWireTimeUs();
+    wire_us[i] = us;
+    uint32_t hash = hashGram(bus->getFramebuffer());
+    const char *result = "";
+    if (golden)
+    {
+      if (hash == golden_hash[i])
+      {
+        result = "ok";
+      }
+      else
+      {
+        result = "MISMATCH";
+        ++failed;
+      }
+    }
+    printf("%-20s %7ld %6lu %9lu %10lu %8.3f %10lu %9.2f  %08x %s\n",
+           workloads[i].name, (long)ops, (unsigned long)stats.transactions,
+           (unsigned long)stats.command_bytes, (unsigned long)stats.pixel_bytes,
+           stats.pixel_bytes ? ((double)stats.command_bytes / stats.pixel_bytes) : 0.0,
+           (unsigned long)us, (double)us / ops, hash, result);
+    if (update_file)
+    {
+      fprintf(update_file, "%s %08x\n", workloads[i].name, hash);
+    }
+    if (image_dir)
+    {
+      char path[256];
+      snprintf(path, sizeof(path), "%s/%s.ppm", image_dir, workloads[i].name);
+      if (!writePPM(path, bus->getFramebuffer()))
+      {
+        fprintf(stderr, "cannot write %s\n", path);
+      }
+    }
+  }
+  if (update_file)
+  {
+    fclose(update_file);
+  }
+
+  // replay the whole recorded session on a second emulated display
+  if (bus->isTraceOverflow())
+  {
+    printf("\nreplay: skipped, trace overflow\n");
+  }
+  else
+  {
+    Arduino_RecordBus replay_bus(GRAM_W, GRAM_H);
+    replay_bus.begin();
+    Arduino_RecordBus::replay(&replay_bus, bus->getTrace(), bus->getTraceLength());
+    bool same = !memcmp(replay_bus.getFramebuffer(), bus->getFramebuffer(), GRAM_W * GRAM_H * 2);
+    printf("\nreplay: %lu trace bytes, %s\n", (unsigned long)bus->getTraceLength(), same ? "ok" : "MISMATCH");
+    if (!same)
+    {
+      ++failed;
+    }
+  }
+
+  // full screen decode-and-show latency: the per MCU drawing waits for each
+  // transfer, the pipeline transfers band k while band k + 1 decodes
+  uint32_t blocks_us = 0, pipeline_us = 0;
+  for (uint8_t i = 0; i < workload_count; ++i)
+  {
+    if (!strcmp(workloads[i].name, "image_blocks"))
+    {
+      blocks_us = wire_us[i];
+    }
+    else if (!strcmp(workloads[i].name, "image_pipeline"))
+    {
+      pipeline_us = wire_us[i];
+    }
+  }
+  uint32_t bands = (h + 15) / 16;
+  double decode_us = (double)w * h * decode_ns / 1000;
+  double band_decode = decode_us / bands, band_wire = (double)pipeline_us / bands;
+  double overlapped_us = band_decode + (bands - 1) * ((band_decode > band_wire) ? band_decode : band_wire) + band_wire;
+  printf("\nimage latency model, %lu ns per decoded pixel, decode %.0f us\n", (unsigned long)decode_ns, decode_us);
+  printf("  image_blocks    decode then wire  %8.0f us\n", decode_us + blocks_us);
+  printf("  image_pipeline  overlapped bands  %8.0f us (%lu bands)\n", overlapped_us, (unsigned long)bands);
+
+  failed += checkImagePipeline();
+  failed += checkPanelModes();
+  failed += checkTemplate();
+  failed += checkFramePacer();
+  failed += checkBandQueue();
+  failed += checkKernels();
+  if (bench_kernels)
+  {
+    benchKernels();
+    benchTemplate();
+  }
+
+  if (golden)
+  {
+    printf("%d mismatch\n", failed);
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,14 @@
+#include <chrono>
+#include "Arduino.h"
+
+unsigned long millis()
+{
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+unsigned long micros()
+{
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
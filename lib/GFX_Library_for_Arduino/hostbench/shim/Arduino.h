@@ -0,0 +1,49 @@
+// Minimal Arduino core for building Arduino_GFX on a desktop host,
+// just enough for hostbench, not a general purpose emulation.
+
+#ifndef _HOSTBENCH_ARDUINO_H_
+#define _HOSTBENCH_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <sched.h>
+#include <string>
+
+#define PROGMEM
+#define OUTPUT 1
+#define INPUT 0
+#define HIGH 1
+#define LOW 0
+#define RISING 3
+#define DEC 10
+#define HEX 16
+
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper *)(s))
+
+inline void delay(unsigned long) {}
+inline void delayMicroseconds(unsigned int) {}
+unsigned long millis();
+unsigned long micros();
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return 0; }
+inline void yield() { sched_yield(); } // let a consumer thread run, like yield() on a RTOS
+#define digitalPinToInterrupt(p) (p)
+inline void attachInterrupt(int, void (*)(void), int) {}
+inline void detachInterrupt(int) {}
+
+class String : public std::string
+{
+public:
+  using std::string::string;
+  String(const std::string &s) : std::string(s) {}
+};
+
+#include "Print.h"
+
+#endif // _HOSTBENCH_ARDUINO_H_
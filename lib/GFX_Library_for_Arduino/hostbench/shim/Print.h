@@ -0,0 +1,55 @@
+#ifndef _HOSTBENCH_PRINT_H_
+#define _HOSTBENCH_PRINT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--)
+    {
+      n += write(*buffer++);
+    }
+    return n;
+  }
+
+  size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  size_t print(const __FlashStringHelper *s) { return print((const char *)s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long v, int base = 10)
+  {
+    char b[24];
+    snprintf(b, sizeof(b), (base == 16) ? "%lX" : "%ld", v);
+    return print(b);
+  }
+  size_t print(unsigned long v, int base = 10)
+  {
+    char b[24];
+    snprintf(b, sizeof(b), (base == 16) ? "%lX" : "%lu", v);
+    return print(b);
+  }
+  size_t print(int v, int base = 10) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = 10) { return print((unsigned long)v, base); }
+  size_t print(double v, int digits = 2)
+  {
+    char b[32];
+    snprintf(b, sizeof(b), "%.*f", digits, v);
+    return print(b);
+  }
+
+  size_t println() { return print("\r\n"); }
+  template <typename T>
+  size_t println(T v) { return print(v) + println(); }
+  template <typename T>
+  size_t println(T v, int base) { return print(v, base) + println(); }
+};
+
+#endif // _HOSTBENCH_PRINT_H_
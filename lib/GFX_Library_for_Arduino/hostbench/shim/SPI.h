@@ -0,0 +1,9 @@
+#ifndef _HOSTBENCH_SPI_H_
+#define _HOSTBENCH_SPI_H_
+
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+#endif // _HOSTBENCH_SPI_H_
@@ -3,6 +3,7 @@
  * https://github.com/adafruit/Adafruit-GFX-Library.git
  */
 #include "Arduino_DataBus.h"
+#include "gfxconvert.h"
 
 Arduino_DataBus::Arduino_DataBus() {}
 
@@ -160,9 +161,16 @@ void Arduino_DataBus::writePattern(uint8_t *data, uint8_t len, uint32_t repeat)
 
 void Arduino_DataBus::writeIndexedPixels(uint8_t *data, uint16_t *idx, uint32_t len)
 {
-  while (len--)
+  // convert in runs, buses batch writePixels() better than single write16()
+  uint16_t buf[GFX_CONVERT_BUF_PIXELS] __attribute__((aligned(4)));
+  uint32_t l;
+  while (len)
   {
-    write16(idx[*(data++)]);
+    l = (len > GFX_CONVERT_BUF_PIXELS) ? GFX_CONVERT_BUF_PIXELS : len;
+    gfx_convert_indexed_to_565(buf, data, idx, l);
+    writePixels(buf, l);
+    data += l;
+    len -= l;
   }
 }
 
@@ -0,0 +1,304 @@
+#include "Arduino_FramePacer.h"
+
+#if !defined(LITTLE_FOOT_PRINT)
+
+#if defined(ESP32) || defined(ESP8266)
+#define FRAMEPACER_ISR_ATTR IRAM_ATTR
+#else
+#define FRAMEPACER_ISR_ATTR
+#endif
+
+// attachInterrupt() takes no argument, one pacer owns the TE interrupt
+static Arduino_FramePacer *_te_pacer = nullptr;
+
+Arduino_FramePacer::Arduino_FramePacer(uint32_t frame_us, int8_t te_pin)
+    : _frame_us(frame_us), _te_pin(te_pin)
+{
+}
+
+Arduino_FramePacer::~Arduino_FramePacer()
+{
+  if (_te_pacer == this)
+  {
+    end();
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Start pacing, enable the TE output of the display and the TE pin
+    interrupt if a TE pin is given
+  @param  gfx  display to enable TE on, may be nullptr if TE is enabled by
+    the init sequence or not used
+  @return true
+*/
+/**************************************************************************/
+bool Arduino_FramePacer::begin(Arduino_GFX *gfx)
+{
+  _gfx = gfx;
+  _te_count = 0;
+  _te_period = 0;
+  _started = false;
+  _begin_set = false;
+  resetStats();
+
+  if (_te_pin != GFX_NOT_DEFINED)
+  {
+    if (_gfx)
+    {
+      _gfx->tearingEffect(true);
+    }
+    _te_pacer = this;
+    pinMode(_te_pin, INPUT);
+    attachInterrupt(digitalPinToInterrupt(_te_pin), teISR, RISING);
+  }
+  return true;
+}
+
+void Arduino_FramePacer::end()
+{
+  if (_te_pin != GFX_NOT_DEFINED)
+  {
+    detachInterrupt(digitalPinToInterrupt(_te_pin));
+    _te_pacer = nullptr;
+    if (_gfx)
+    {
+      _gfx->tearingEffect(false);
+    }
+  }
+}
+
+bool Arduino_FramePacer::frameDue()
+{
+  return frameDue(micros());
+}
+
+/**************************************************************************/
+/*!
+  @brief  Check if a new frame may start. With TE, a frame is due inside
+    the TE window after a pulse that is at least one frame time after the
+    last frame start. Without TE, a frame is due every frame time.
+  @param  now  current time in microseconds
+  @return true if the frame should start now
+*/
+/**************************************************************************/
+bool Arduino_FramePacer::frameDue(uint32_t now)
+{
+  if (!_begin_set)
+  {
+    _begin_us = now;
+    _begin_set = true;
+  }
+
+  if (isTeActive(now))
+  {
+    uint32_t count = _te_count;
+    uint32_t te_us = _te_us;
+    uint32_t te_period = _te_period;
+    if ((!count) || (count == _start_te))
+    {
+      // no pulse since the last frame start
+      return false;
+    }
+    uint32_t window = _te_window_us ? _te_window_us : (te_period ? (te_period / 4) : 1000);
+    if ((now - te_us) > window)
+    {
+      // scan already running, wait for the next pulse
+      return false;
+    }
+    if (_started && ((te_us - _start_us) + (te_period / 2) < _frame_us))
+    {
+      // frame time is a multiple of the TE period, skip this pulse
+      return false;
+    }
+    return true;
+  }
+
+  if (!_started)
+  {
+    return true;
+  }
+  return (int32_t)(now - _next_us) >= 0;
+}
+
+void Arduino_FramePacer::frameStart()
+{
+  frameStart(micros());
+}
+
+/**************************************************************************/
+/*!
+  @brief  Mark the start of a frame transfer and update the frame time
+    statistics
+  @param  now  current time in microseconds
+*/
+/**************************************************************************/
+void Arduino_FramePacer::frameStart(uint32_t now)
+{
+  if (_started)
+  {
+    uint32_t interval = now - _start_us;
+    _stats.last_frame_us = interval;
+    if ((!_stats.min_frame_us) || (interval < _stats.min_frame_us))
+    {
+      _stats.min_frame_us = interval;
+    }
+    if (interval > _stats.max_frame_us)
+    {
+      _stats.max_frame_us = interval;
+    }
+    if (_stats.avg_frame_us)
+    {
+      _stats.avg_frame_us += ((int32_t)(interval - _stats.avg_frame_us)) / 8;
+    }
+    else
+    {
+      _stats.avg_frame_us = interval;
+    }
+    if (interval >= (_frame_us + (_frame_us / 2)))
+    {
+      _stats.missed += ((interval + (_frame_us / 2)) / _frame_us) - 1;
+    }
+
+    if ((int32_t)(now - _next_us) >= (int32_t)_frame_us)
+    {
+      // more than a frame behind, restart the software clock
+      _next_us = now + _frame_us;
+    }
+    else
+    {
+      _next_us += _frame_us;
+    }
+  }
+  else
+  {
+    _next_us = now + _frame_us;
+  }
+
+  ++_stats.frames;
+  _start_us = now;
+  _start_te = _te_count;
+  _started = true;
+}
+
+void Arduino_FramePacer::frameDone()
+{
+  frameDone(micros());
+}
+
+/**************************************************************************/
+/*!
+  @brief  Mark the end of a frame transfer
+  @param  now  current time in microseconds
+*/
+/**************************************************************************/
+void Arduino_FramePacer::frameDone(uint32_t now)
+{
+  uint32_t busy = now - _start_us;
+  _stats.last_busy_us = busy;
+  if (busy > _stats.max_busy_us)
+  {
+    _stats.max_busy_us = busy;
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Wait until a frame is due, then mark its start
+*/
+/**************************************************************************/
+void Arduino_FramePacer::waitFrame()
+{
+  uint32_t now = micros();
+  while (!frameDue(now))
+  {
+    yield();
+    now = micros();
+  }
+  frameStart(now);
+}
+
+/**************************************************************************/
+/*!
+  @brief  Record a TE pulse, called by the TE pin interrupt or a simulated
+    TE source
+  @param  now  time of the pulse in microseconds
+*/
+/**************************************************************************/
+void FRAMEPACER_ISR_ATTR Arduino_FramePacer::teEdge(uint32_t now)
+{
+  if (_te_count)
+  {
+    _te_period = now - _te_us;
+  }
+  _te_us = now;
+  _te_count = _te_count + 1;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Check if frames follow the TE pulses, false without TE pin or
+    after FRAMEPACER_TE_TIMEOUT_FRAMES frame times without a pulse
+  @param  now  current time in microseconds
+  @return true if TE paces the frames
+*/
+/**************************************************************************/
+bool Arduino_FramePacer::isTeActive(uint32_t now)
+{
+  if (_te_pin == GFX_NOT_DEFINED)
+  {
+    return false;
+  }
+  uint32_t timeout = _frame_us * FRAMEPACER_TE_TIMEOUT_FRAMES;
+  if (!_te_count)
+  {
+    // give the display time for the first pulse
+    return _begin_set && ((now - _begin_us) < timeout);
+  }
+  return (now - _te_us) < timeout;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Set how long after a TE pulse a frame may still start
+  @param  us  window in microseconds, 0 for a quarter of the TE period
+*/
+/**************************************************************************/
+void Arduino_FramePacer::setTeWindow(uint32_t us)
+{
+  _te_window_us = us;
+}
+
+void Arduino_FramePacer::setFrameTime(uint32_t frame_us)
+{
+  _frame_us = frame_us;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Get frame timing since begin() or resetStats()
+  @return statistics
+*/
+/**************************************************************************/
+gfx_frame_stats_t Arduino_FramePacer::getStats()
+{
+  gfx_frame_stats_t stats = _stats;
+  stats.te_edges = _te_count;
+  stats.te_period_us = _te_period;
+  return stats;
+}
+
+void Arduino_FramePacer::resetStats()
+{
+  _stats = {};
+}
+
+void FRAMEPACER_ISR_ATTR Arduino_FramePacer::teISR()
+{
+  if (_te_pacer)
+  {
+    _te_pacer->teEdge(micros());
+  }
+}
+
+#endif // !defined(LITTLE_FOOT_PRINT)
@@ -0,0 +1,94 @@
+// Frame scheduler for flicker and tear free updates. With the display TE
+// (tearing effect) pin wired to a GPIO, a frame may start only in a short
+// window after the TE pulse that marks the start of the vertical blanking,
+// so the transfer runs behind the panel scan line instead of across it.
+// Without TE, or if TE pulses stop, frames are paced by a software clock.
+//
+// Draw into a canvas at any time and send it when a frame is due:
+//   Arduino_FramePacer *pacer = new Arduino_FramePacer(33333 /* frame_us */, TE_PIN);
+//   pacer->begin(gfx);
+//   ...
+//   pacer->waitFrame();
+//   canvas->flush();
+//   pacer->frameDone();
+//
+// The functions taking a time stamp drive the same logic from a simulated
+// clock and TE source, the others use micros().
+
+#ifndef _ARDUINO_FRAMEPACER_H_
+#define _ARDUINO_FRAMEPACER_H_
+
+#include "Arduino_DataBus.h"
+#include "Arduino_GFX.h"
+
+#if !defined(LITTLE_FOOT_PRINT)
+
+#define FRAMEPACER_TE_TIMEOUT_FRAMES 4 // fall back to software pacing after this many frame times without TE
+
+/// Frame timing since begin() or resetStats(), all times in microseconds
+typedef struct
+{
+  uint32_t frames;         ///< frames started
+  uint32_t missed;         ///< frame periods lost because a frame started late
+  uint32_t te_edges;       ///< TE pulses since begin()
+  uint32_t te_period_us;   ///< time between the last 2 TE pulses, 0 without TE
+  uint32_t last_frame_us;  ///< start to start time of the last frame
+  uint32_t min_frame_us;   ///< shortest start to start time
+  uint32_t max_frame_us;   ///< longest start to start time
+  uint32_t avg_frame_us;   ///< smoothed start to start time
+  uint32_t last_busy_us;   ///< frameStart() to frameDone() time of the last frame
+  uint32_t max_busy_us;    ///< longest frameStart() to frameDone() time
+} gfx_frame_stats_t;
+
+class Arduino_FramePacer
+{
+public:
+  Arduino_FramePacer(uint32_t frame_us = 16667, int8_t te_pin = GFX_NOT_DEFINED);
+  ~Arduino_FramePacer();
+
+  bool begin(Arduino_GFX *gfx = nullptr);
+  void end();
+
+  bool frameDue();
+  bool frameDue(uint32_t now);
+  void frameStart();
+  void frameStart(uint32_t now);
+  void frameDone();
+  void frameDone(uint32_t now);
+  void waitFrame();
+
+  void teEdge(uint32_t now);
+  bool isTeActive(uint32_t now);
+  void setTeWindow(uint32_t us);
+  void setFrameTime(uint32_t frame_us);
+
+  gfx_frame_stats_t getStats();
+  void resetStats();
+
+protected:
+  static void teISR();
+
+  Arduino_GFX *_gfx = nullptr;
+  uint32_t _frame_us;
+  int8_t _te_pin;
+  uint32_t _te_window_us = 0; // 0: a quarter of the TE period
+
+  // written by teEdge(), may run in the TE interrupt
+  volatile uint32_t _te_us = 0;     // time of the last TE pulse
+  volatile uint32_t _te_count = 0;  // TE pulses since begin()
+  volatile uint32_t _te_period = 0; // time between the last 2 TE pulses
+
+  uint32_t _begin_us = 0;       // first frameDue() time, for the TE timeout before the first pulse
+  bool _begin_set = false;      // _begin_us is set
+  uint32_t _start_te = 0;       // _te_count at the last frame start
+  uint32_t _start_us = 0;       // time of the last frame start
+  uint32_t _next_us = 0;        // next frame start time of the software pacing
+  bool _started = false;        // a frame was started since begin()
+  gfx_frame_stats_t _stats = {};
+
+private:
+};
+
+#endif // !defined(LITTLE_FOOT_PRINT)
+
+#endif // _ARDUINO_FRAMEPACER_H_
@@ -11,6 +11,34 @@ Arduino_G::Arduino_G(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h)
 {
 }
 
+/**************************************************************************/
+/*!
+   @brief    Draw a 16-bit image that is part of a larger bitmap, row by row.
+             Subclasses that can write all rows into one address window should override it.
+   @param    x       Top left corner x coordinate
+   @param    y       Top left corner y coordinate
+   @param    bitmap  16-bit color bitmap
+   @param    w       Width of the image in pixels
+   @param    h       Height of the image in pixels
+   @param    x_skip  Pixels to skip at the end of each row
+*/
+/**************************************************************************/
+void Arduino_G::draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h, int16_t x_skip)
+{
+  if (x_skip == 0)
+  {
+    draw16bitRGBBitmap(x, y, bitmap, w, h);
+  }
+  else
+  {
+    while (h--)
+    {
+      draw16bitRGBBitmap(x, y++, bitmap, w, 1);
+      bitmap += w + x_skip;
+    }
+  }
+}
+
 // utility functions
 bool gfx_draw_bitmap_to_framebuffer(
     uint16_t *from_bitmap, int16_t bitmap_w, int16_t bitmap_h,
@@ -139,7 +167,7 @@ bool gfx_draw_bitmap_to_framebuffer_rotate_1(
     {
       p = framebuffer;
       p += (x * framebuffer_h);     // shift framebuffer to y offset
-      p += (framebuffer_h - y - j); // shift framebuffer to x offset
+      p += (max_Y - y - j);         // shift framebuffer to x offset
 
       i = bitmap_w;
       while (i--)
@@ -273,3 +301,95 @@ bool gfx_draw_bitmap_to_framebuffer_rotate_3(
     return true;
   }
 }
+
+static int32_t gfx_rect_area(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+  return (int32_t)(x2 - x1 + 1) * (y2 - y1 + 1);
+}
+
+/**************************************************************************/
+/*!
+   @brief    Add a changed region, merging it with tracked regions whenever sending
+             the union costs less than GFX_DIRTY_RECT_WINDOW_COST more pixels than
+             sending them apart
+   @param    dirty   tracked regions
+   @param    x1      left, inclusive
+   @param    y1      top, inclusive
+   @param    x2      right, inclusive
+   @param    y2      bottom, inclusive
+*/
+/**************************************************************************/
+void gfx_dirty_rects_add(gfx_dirty_rects_t *dirty, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+  gfx_rect_t *r;
+  if (dirty->count)
+  {
+    // consecutive drawing usually hits the last grown region
+    r = &dirty->rect[dirty->count - 1];
+    if ((x1 >= r->x1) && (y1 >= r->y1) && (x2 <= r->x2) && (y2 <= r->y2))
+    {
+      return;
+    }
+  }
+
+  int16_t ux1, uy1, ux2, uy2;
+  uint8_t i = 0;
+  while (i < dirty->count)
+  {
+    r = &dirty->rect[i];
+    ux1 = (r->x1 < x1) ? r->x1 : x1;
+    uy1 = (r->y1 < y1) ? r->y1 : y1;
+    ux2 = (r->x2 > x2) ? r->x2 : x2;
+    uy2 = (r->y2 > y2) ? r->y2 : y2;
+    if (gfx_rect_area(ux1, uy1, ux2, uy2) <=
+        (gfx_rect_area(r->x1, r->y1, r->x2, r->y2) + gfx_rect_area(x1, y1, x2, y2) + GFX_DIRTY_RECT_WINDOW_COST))
+    {
+      // take over r, the grown region may now merge with others
+      x1 = ux1;
+      y1 = uy1;
+      x2 = ux2;
+      y2 = uy2;
+      dirty->rect[i] = dirty->rect[--dirty->count];
+      i = 0;
+    }
+    else
+    {
+      ++i;
+    }
+  }
+
+  if (dirty->count == GFX_DIRTY_RECT_MAX)
+  {
+    // no free slot, merge with the region that grows the least
+    uint8_t best = 0;
+    int32_t best_cost = INT32_MAX;
+    int32_t cost;
+    for (i = 0; i < dirty->count; ++i)
+    {
+      r = &dirty->rect[i];
+      cost = gfx_rect_area(
+                 (r->x1 < x1) ? r->x1 : x1, (r->y1 < y1) ? r->y1 : y1,
+                 (r->x2 > x2) ? r->x2 : x2, (r->y2 > y2) ? r->y2 : y2) -
+             gfx_rect_area(r->x1, r->y1, r->x2, r->y2);
+      if (cost < best_cost)
+      {
+        best_cost = cost;
+        best = i;
+      }
+    }
+    r = &dirty->rect[best];
+    x1 = (r->x1 < x1) ? r->x1 : x1;
+    y1 = (r->y1 < y1) ? r->y1 : y1;
+    x2 = (r->x2 > x2) ? r->x2 : x2;
+    y2 = (r->y2 > y2) ? r->y2 : y2;
+    dirty->rect[best] = dirty->rect[--dirty->count];
+    gfx_dirty_rects_add(dirty, x1, y1, x2, y2);
+    return;
+  }
+
+  r = &dirty->rect[dirty->count++];
+  r->x1 = x1;
+  r->y1 = y1;
+  r->x2 = x2;
+  r->y2 = y2;
+}
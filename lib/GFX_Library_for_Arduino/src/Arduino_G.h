@@ -16,6 +16,7 @@ public:
   virtual void drawIndexedBitmap(int16_t x, int16_t y, uint8_t *bitmap, uint16_t *color_index, int16_t w, int16_t h, int16_t x_skip = 0) = 0;
   virtual void draw3bitRGBBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h) = 0;
   virtual void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) = 0;
+  virtual void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h, int16_t x_skip);
   virtual void draw24bitRGBBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h) = 0;
 
 protected:
@@ -26,7 +27,51 @@ protected:
 
 #endif // _ARDUINO_G_H_
 
+#ifndef _GFX_DIRTY_RECTS_
+#define _GFX_DIRTY_RECTS_
+
+#ifndef GFX_DIRTY_RECT_MAX
+#define GFX_DIRTY_RECT_MAX 8 // dirty rectangles tracked by a canvas between flush()
+#endif
+#ifndef GFX_DIRTY_RECT_WINDOW_COST
+#define GFX_DIRTY_RECT_WINDOW_COST 128 // cost of one more address window, in pixels
+#endif
+
+/// Inclusive rectangle in raw (unrotated) framebuffer coordinates
+typedef struct
+{
+  int16_t x1;
+  int16_t y1;
+  int16_t x2;
+  int16_t y2;
+} gfx_rect_t;
+
+/// Regions of a canvas changed since last flush()
+typedef struct
+{
+  gfx_rect_t rect[GFX_DIRTY_RECT_MAX];
+  uint8_t count;
+} gfx_dirty_rects_t;
+
+#endif // _GFX_DIRTY_RECTS_
+
+#ifndef _GFX_CANVAS_ROTATION_MODE_
+#define _GFX_CANVAS_ROTATION_MODE_
+
+// Where a canvas applies its rotation, see setRotationMode()
+#define CANVAS_ROTATE_ON_DRAW 0   // framebuffer in panel orientation, every write is rotated (default)
+#define CANVAS_ROTATE_ON_FLUSH 1  // framebuffer in logical orientation, transposed once by flush()
+#define CANVAS_ROTATE_BY_OUTPUT 2 // framebuffer in logical orientation, the output is rotated instead
+
+#ifndef CANVAS_TRANSPOSE_ROWS
+#define CANVAS_TRANSPOSE_ROWS 16 // panel rows transposed per output write in CANVAS_ROTATE_ON_FLUSH
+#endif
+
+#endif // _GFX_CANVAS_ROTATION_MODE_
+
 // utility functions
+void gfx_dirty_rects_add(gfx_dirty_rects_t *dirty, int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+
 bool gfx_draw_bitmap_to_framebuffer(
     uint16_t *from_bitmap, int16_t bitmap_w, int16_t bitmap_h,
     uint16_t *framebuffer, int16_t x, int16_t y, int16_t framebuffer_w, int16_t framebuffer_h);
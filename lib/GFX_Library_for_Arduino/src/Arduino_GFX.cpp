@@ -47,6 +47,7 @@ Arduino_GFX::Arduino_GFX(int16_t w, int16_t h) : Arduino_G(w, h)
   wrap = true;
 #if !defined(ATTINY_CORE)
   gfxFont = NULL;
+  gfxAAFont = NULL;
 #if defined(U8G2_FONT_SUPPORT)
   u8g2Font = NULL;
 #endif // defined(U8G2_FONT_SUPPORT)
@@ -1256,6 +1257,60 @@ void Arduino_GFX::drawXBitmap(int16_t x, int16_t y,
   endWrite();
 }
 
+#if !defined(LITTLE_FOOT_PRINT)
+/**************************************************************************/
+/*!
+  @brief  Draw a bitmap in a GFX_CONVERT_* pixel format. The visible part of
+    each row is converted to RGB565 in runs of up to GFX_CONVERT_BUF_PIXELS
+    pixels, each run is drawn with one draw16bitRGBBitmap() call.
+  @param  x            Top left corner x coordinate
+  @param  y            Top left corner y coordinate
+  @param  format       GFX_CONVERT_* pixel format of bitmap
+  @param  bitmap       source pixels
+  @param  color_index  palette for GFX_CONVERT_INDEXED, otherwise not used
+  @param  w            Width of bitmap in pixels
+  @param  h            Height of bitmap in pixels
+  @param  x_skip       number of pixels required to skip for every bitmap row
+*/
+/**************************************************************************/
+void Arduino_GFX::drawConvertedBitmap(int16_t x, int16_t y, uint8_t format, const uint8_t *bitmap, const uint16_t *color_index, int16_t w, int16_t h, int16_t x_skip)
+{
+  int16_t xs = (x < 0) ? -x : 0;
+  int16_t xe = ((x + w - 1) > _max_x) ? (_max_x - x + 1) : w;
+  int16_t ys = (y < 0) ? -y : 0;
+  int16_t ye = ((y + h - 1) > _max_y) ? (_max_y - y + 1) : h;
+  if ((xs >= xe) || (ys >= ye))
+  {
+    return;
+  }
+
+  uint16_t buf[GFX_CONVERT_BUF_PIXELS] __attribute__((aligned(4)));
+  uint8_t bpp = gfx_convert_bytes_per_pixel(format);
+  int32_t stride = ((int32_t)w + x_skip) * bpp;
+  const uint8_t *row = bitmap + (ys * stride) + (xs * bpp);
+  const uint8_t *src;
+  int16_t len;
+  startWrite();
+  for (int16_t j = ys; j < ye; j++)
+  {
+    src = row;
+    for (int16_t i = xs; i < xe; i += len)
+    {
+      len = xe - i;
+      if (len > GFX_CONVERT_BUF_PIXELS)
+      {
+        len = GFX_CONVERT_BUF_PIXELS;
+      }
+      gfx_convert_row(format, buf, src, color_index, len);
+      draw16bitRGBBitmap(x + i, y + j, buf, len, 1);
+      src += len * bpp;
+    }
+    row += stride;
+  }
+  endWrite();
+}
+#endif // !defined(LITTLE_FOOT_PRINT)
+
 /**************************************************************************/
 /*!
   @brief  Draw a PROGMEM-resident 8-bit image (grayscale) at the specified (x,y) pos.
@@ -1269,6 +1324,9 @@ void Arduino_GFX::drawXBitmap(int16_t x, int16_t y,
 void Arduino_GFX::drawGrayscaleBitmap(int16_t x, int16_t y,
                                       const uint8_t bitmap[], int16_t w, int16_t h)
 {
+#if defined(GFX_CONVERT_PROGMEM)
+  drawConvertedBitmap(x, y, GFX_CONVERT_GRAY8, bitmap, NULL, w, h);
+#else
   uint8_t v;
   startWrite();
   for (int16_t j = 0; j < h; j++, y++)
@@ -1280,6 +1338,7 @@ void Arduino_GFX::drawGrayscaleBitmap(int16_t x, int16_t y,
     }
   }
   endWrite();
+#endif // defined(GFX_CONVERT_PROGMEM)
 }
 
 /**************************************************************************/
@@ -1295,6 +1354,9 @@ void Arduino_GFX::drawGrayscaleBitmap(int16_t x, int16_t y,
 void Arduino_GFX::drawGrayscaleBitmap(int16_t x, int16_t y,
                                       uint8_t *bitmap, int16_t w, int16_t h)
 {
+#if !defined(LITTLE_FOOT_PRINT)
+  drawConvertedBitmap(x, y, GFX_CONVERT_GRAY8, bitmap, NULL, w, h);
+#else
   uint8_t v;
   startWrite();
   for (int16_t j = 0; j < h; j++, y++)
@@ -1306,6 +1368,7 @@ void Arduino_GFX::drawGrayscaleBitmap(int16_t x, int16_t y,
     }
   }
   endWrite();
+#endif // !defined(LITTLE_FOOT_PRINT)
 }
 
 /**************************************************************************/
@@ -1409,6 +1472,9 @@ void Arduino_GFX::drawIndexedBitmap(
     int16_t x, int16_t y,
     uint8_t *bitmap, uint16_t *color_index, int16_t w, int16_t h, int16_t x_skip)
 {
+#if !defined(LITTLE_FOOT_PRINT)
+  drawConvertedBitmap(x, y, GFX_CONVERT_INDEXED, bitmap, color_index, w, h, x_skip);
+#else
   int32_t offset = 0;
   startWrite();
   for (int16_t j = 0; j < h; j++, y++)
@@ -1420,6 +1486,7 @@ void Arduino_GFX::drawIndexedBitmap(
     offset += x_skip;
   }
   endWrite();
+#endif // !defined(LITTLE_FOOT_PRINT)
 }
 
 /**************************************************************************/
@@ -1593,6 +1660,9 @@ void Arduino_GFX::draw16bitRGBBitmapWithTranColor(
 void Arduino_GFX::draw16bitBeRGBBitmap(int16_t x, int16_t y,
                                        uint16_t *bitmap, int16_t w, int16_t h)
 {
+#if !defined(LITTLE_FOOT_PRINT)
+  drawConvertedBitmap(x, y, GFX_CONVERT_RGB565BE, (uint8_t *)bitmap, NULL, w, h);
+#else
   int32_t offset = 0;
   uint16_t p;
   startWrite();
@@ -1606,6 +1676,7 @@ void Arduino_GFX::draw16bitBeRGBBitmap(int16_t x, int16_t y,
     }
   }
   endWrite();
+#endif // !defined(LITTLE_FOOT_PRINT)
 }
 
 #if !defined(LITTLE_FOOT_PRINT)
@@ -1735,6 +1806,9 @@ void Arduino_GFX::draw16bitRGBBitmapWithMask(int16_t x, int16_t y,
 void Arduino_GFX::draw24bitRGBBitmap(int16_t x, int16_t y,
                                      const uint8_t bitmap[], int16_t w, int16_t h)
 {
+#if defined(GFX_CONVERT_PROGMEM)
+  drawConvertedBitmap(x, y, GFX_CONVERT_RGB888, bitmap, NULL, w, h);
+#else
   int32_t offset = 0;
   startWrite();
   for (int16_t j = 0; j < h; j++, y++)
@@ -1746,6 +1820,7 @@ void Arduino_GFX::draw24bitRGBBitmap(int16_t x, int16_t y,
     }
   }
   endWrite();
+#endif // defined(GFX_CONVERT_PROGMEM)
 }
 
 /**************************************************************************/
@@ -1761,6 +1836,9 @@ void Arduino_GFX::draw24bitRGBBitmap(int16_t x, int16_t y,
 void Arduino_GFX::draw24bitRGBBitmap(int16_t x, int16_t y,
                                      uint8_t *bitmap, int16_t w, int16_t h)
 {
+#if !defined(LITTLE_FOOT_PRINT)
+  drawConvertedBitmap(x, y, GFX_CONVERT_RGB888, bitmap, NULL, w, h);
+#else
   int32_t offset = 0;
   startWrite();
   for (int16_t j = 0; j < h; j++, y++)
@@ -1772,6 +1850,7 @@ void Arduino_GFX::draw24bitRGBBitmap(int16_t x, int16_t y,
     }
   }
   endWrite();
+#endif // !defined(LITTLE_FOOT_PRINT)
 }
 
 /**************************************************************************/
@@ -2005,6 +2084,478 @@ void Arduino_GFX::u8g2_font_decode_len(uint8_t len, uint8_t is_foreground, uint1
   _u8g2_dx = lx;
   _u8g2_dy = ly;
 }
+
+/**************************************************************************/
+/*!
+  @brief  Find the glyph data of an encoding in the current u8g2 font
+  @param  encoding  Character code (unicode if UTF8 print enabled)
+  @return Pointer to glyph data after encoding and size bytes, NULL if not found
+  @note   With the sparse index built by setFont(), at most
+          U8G2_FONT_INDEX_STEP glyphs are scanned after a binary search.
+*/
+/**************************************************************************/
+const uint8_t *Arduino_GFX::u8g2_font_get_glyph_data(uint16_t encoding)
+{
+  const uint8_t *font = u8g2Font;
+
+  if (_u8g2_index && (_u8g2_index_font == u8g2Font))
+  {
+    // binary search the last index entry not greater than encoding
+    if (encoding < _u8g2_index[0].encoding)
+    {
+      return NULL;
+    }
+    uint16_t lo = 0, hi = _u8g2_index_cnt - 1;
+    while (lo < hi)
+    {
+      uint16_t mid = (lo + hi + 1) >> 1;
+      if (_u8g2_index[mid].encoding <= encoding)
+      {
+        lo = mid;
+      }
+      else
+      {
+        hi = mid - 1;
+      }
+    }
+    if ((encoding > 255) && (_u8g2_index[lo].encoding <= 255))
+    {
+      return NULL; // before the first unicode glyph
+    }
+
+    font += _u8g2_index[lo].offset;
+    if (encoding <= 255)
+    {
+      for (;;)
+      {
+        uint8_t size = pgm_read_byte(font + 1);
+        if (size == 0)
+          return NULL;
+        uint8_t e = pgm_read_byte(font);
+        if (e == encoding)
+          return font + 2; /* skip encoding and glyph size */
+        if (e > encoding)
+          return NULL;
+        font += size;
+      }
+    }
+#ifdef U8G2_WITH_UNICODE
+    for (;;)
+    {
+      uint16_t e = u8g2_font_get_word(font, 0);
+      if (e == 0)
+        return NULL;
+      if (e == encoding)
+        return font + 3; /* skip encoding and glyph size */
+      if (e > encoding)
+        return NULL;
+      font += pgm_read_byte(font + 2);
+    }
+#endif
+    return NULL;
+  }
+
+  // extract from u8g2_font_get_glyph_data()
+  font += 23; // U8G2_FONT_DATA_STRUCT_SIZE
+  if (encoding <= 255)
+  {
+    if (encoding >= 'a')
+    {
+      font += _u8g2_start_pos_lower_a;
+    }
+    else if (encoding >= 'A')
+    {
+      font += _u8g2_start_pos_upper_A;
+    }
+
+    for (;;)
+    {
+      if (pgm_read_byte(font + 1) == 0)
+        break;
+      if (pgm_read_byte(font) == encoding)
+      {
+        return font + 2; /* skip encoding and glyph size */
+      }
+      font += pgm_read_byte(font + 1);
+    }
+  }
+#ifdef U8G2_WITH_UNICODE
+  else
+  {
+    uint16_t e;
+    font += _u8g2_start_pos_unicode;
+    const uint8_t *unicode_lookup_table = font;
+
+    /* issue 596: search for the glyph start in the unicode lookup table */
+    do
+    {
+      font += u8g2_font_get_word(unicode_lookup_table, 0);
+      e = u8g2_font_get_word(unicode_lookup_table, 2);
+      unicode_lookup_table += 4;
+    } while (e < encoding);
+
+    for (;;)
+    {
+      e = u8g2_font_get_word(font, 0);
+
+      if (e == 0)
+        break;
+
+      if (e == encoding)
+      {
+        return font + 3; /* skip encoding and glyph size */
+      }
+      font += pgm_read_byte(font + 2);
+    }
+  }
+#endif
+  return NULL;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Build a sparse glyph index of the current u8g2 font, one entry
+          per U8G2_FONT_INDEX_STEP glyphs of each section.
+          Without enough memory the linear search is used.
+*/
+/**************************************************************************/
+void Arduino_GFX::u8g2_font_build_index()
+{
+  free(_u8g2_index);
+  _u8g2_index = NULL;
+  _u8g2_index_cnt = 0;
+  _u8g2_index_font = u8g2Font;
+#if (U8G2_FONT_INDEX_STEP > 0)
+  uint16_t cnt = 0;
+  for (uint8_t pass = 0; pass < 2; ++pass)
+  {
+    uint16_t n = 0, i = 0;
+    const uint8_t *font = u8g2Font + 23; // U8G2_FONT_DATA_STRUCT_SIZE
+    uint8_t size;
+    while ((size = pgm_read_byte(font + 1)) != 0)
+    {
+      if ((i++ % U8G2_FONT_INDEX_STEP) == 0)
+      {
+        if (pass)
+        {
+          _u8g2_index[n].encoding = pgm_read_byte(font);
+          _u8g2_index[n].offset = font - u8g2Font;
+        }
+        ++n;
+      }
+      font += size;
+    }
+#ifdef U8G2_WITH_UNICODE
+    // glyphs start after the unicode lookup table, last table entry has encoding 0xFFFF
+    const uint8_t *unicode_lookup_table = u8g2Font + 23 + _u8g2_start_pos_unicode;
+    font = unicode_lookup_table + u8g2_font_get_word(unicode_lookup_table, 0);
+    i = 0;
+    while (u8g2_font_get_word(font, 0) != 0)
+    {
+      if ((i++ % U8G2_FONT_INDEX_STEP) == 0)
+      {
+        if (pass)
+        {
+          _u8g2_index[n].encoding = u8g2_font_get_word(font, 0);
+          _u8g2_index[n].offset = font - u8g2Font;
+        }
+        ++n;
+      }
+      font += pgm_read_byte(font + 2);
+    }
+#endif
+    if (pass == 0)
+    {
+      if (n == 0)
+      {
+        return;
+      }
+      _u8g2_index = (u8g2_font_index_t *)malloc(n * sizeof(u8g2_font_index_t));
+      if (!_u8g2_index)
+      {
+        return;
+      }
+      cnt = n;
+    }
+  }
+  _u8g2_index_cnt = cnt;
+#endif // (U8G2_FONT_INDEX_STEP > 0)
+}
+
+// LSB first bit reader over u8g2 glyph data, 32-bit buffered
+typedef struct
+{
+  const uint8_t *ptr;
+  uint32_t buf;
+  uint8_t cnt;
+} gfx_u8g2_bit_reader_t;
+
+GFX_INLINE static uint8_t gfx_u8g2_get_bits(gfx_u8g2_bit_reader_t *r, uint8_t cnt)
+{
+  while (r->cnt < cnt)
+  {
+    r->buf |= (uint32_t)pgm_read_byte(r->ptr++) << r->cnt;
+    r->cnt += 8;
+  }
+  uint8_t val = r->buf & ((1U << cnt) - 1);
+  r->buf >>= cnt;
+  r->cnt -= cnt;
+  return val;
+}
+
+// set bits [x, x + len) of a MSB first bitmap row
+GFX_INLINE static void gfx_set_bit_span(uint8_t *row, uint8_t x, uint8_t len)
+{
+  while (len)
+  {
+    uint8_t *b = row + (x >> 3);
+    uint8_t shift = x & 7;
+    uint8_t n = 8 - shift;
+    if (n > len)
+    {
+      n = len;
+    }
+    *b |= (uint8_t)(0xFF << (8 - n)) >> shift;
+    x += n;
+    len -= n;
+  }
+}
+
+// end of the run of is_set bits starting at x of a MSB first bitmap row
+GFX_INLINE static uint8_t gfx_bit_run_end(const uint8_t *row, uint8_t x, uint8_t w, bool is_set)
+{
+  uint8_t fill = is_set ? 0xFF : 0x00;
+  while (x < w)
+  {
+    uint8_t b = row[x >> 3];
+    if (((x & 7) == 0) && (b == fill))
+    {
+      x += 8; // whole byte in the run
+    }
+    else if (((b & (0x80 >> (x & 7))) != 0) == is_set)
+    {
+      ++x;
+    }
+    else
+    {
+      break;
+    }
+  }
+  return (x > w) ? w : x;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Locate and decode a glyph of the current u8g2 font. Glyph metrics
+          are stored in _u8g2_char_*. The RLE body is decoded once into a
+          1-bit bitmap slot of a small LRU cache (U8G2_GLYPH_CACHE_SIZE).
+          If the cache is unavailable, _u8g2_decode_ptr is left at the body
+          for the streaming decoder.
+  @param  encoding  Character code
+  @return false if glyph not found
+*/
+/**************************************************************************/
+bool Arduino_GFX::u8g2_font_decode_glyph(uint16_t encoding)
+{
+  _u8g2_decode_ptr = 0;
+  _u8g2_glyph_bits = NULL;
+
+  uint8_t slot = 0;
+  for (uint8_t i = 0; i < U8G2_GLYPH_CACHE_SIZE; ++i)
+  {
+    u8g2_glyph_cache_t *e = &_u8g2_glyph_cache[i];
+    if (e->last_used && (e->encoding == encoding))
+    {
+      _u8g2_char_width = e->width;
+      _u8g2_char_height = e->height;
+      _u8g2_char_x = e->x;
+      _u8g2_char_y = e->y;
+      _u8g2_delta_x = e->delta_x;
+      e->last_used = ++_u8g2_glyph_cache_clock;
+      _u8g2_glyph_bits = _u8g2_glyph_cache_bits + (i * _u8g2_glyph_cache_slot_size);
+      return true;
+    }
+    if (e->last_used < _u8g2_glyph_cache[slot].last_used)
+    {
+      slot = i;
+    }
+  }
+
+  const uint8_t *glyph_data = u8g2_font_get_glyph_data(encoding);
+  if (!glyph_data)
+  {
+    return false;
+  }
+
+  // u8g2_font_decode_glyph
+  _u8g2_decode_ptr = glyph_data;
+  _u8g2_decode_bit_pos = 0;
+
+  _u8g2_char_width = u8g2_font_decode_get_unsigned_bits(_u8g2_bits_per_char_width);
+  _u8g2_char_height = u8g2_font_decode_get_unsigned_bits(_u8g2_bits_per_char_height);
+  _u8g2_char_x = u8g2_font_decode_get_signed_bits(_u8g2_bits_per_char_x);
+  _u8g2_char_y = u8g2_font_decode_get_signed_bits(_u8g2_bits_per_char_y);
+  _u8g2_delta_x = u8g2_font_decode_get_signed_bits(_u8g2_bits_per_delta_x);
+  // log_d("_encoding: %d, _u8g2_char_width: %d, _u8g2_char_height: %d, _u8g2_char_x: %d, _u8g2_char_y: %d, _u8g2_delta_x: %d",
+  //       encoding, _u8g2_char_width, _u8g2_char_height, _u8g2_char_x, _u8g2_char_y, _u8g2_delta_x);
+
+  uint8_t w = _u8g2_char_width, h = _u8g2_char_height;
+  uint8_t stride = (w + 7) >> 3;
+  if ((!_u8g2_glyph_cache_bits) || ((stride * h) > _u8g2_glyph_cache_slot_size))
+  {
+    return true; // streaming decode in drawChar()
+  }
+
+  uint8_t *bits = _u8g2_glyph_cache_bits + (slot * _u8g2_glyph_cache_slot_size);
+  memset(bits, 0, stride * h);
+  if ((w > 0) && (h > 0))
+  {
+    gfx_u8g2_bit_reader_t r;
+    r.ptr = _u8g2_decode_ptr + 1;
+    r.buf = pgm_read_byte(_u8g2_decode_ptr) >> _u8g2_decode_bit_pos;
+    r.cnt = 8 - _u8g2_decode_bit_pos;
+
+    uint8_t lx = 0, ly = 0;
+    for (;;)
+    {
+      uint8_t a = gfx_u8g2_get_bits(&r, _u8g2_bits_per_0);
+      uint8_t b = gfx_u8g2_get_bits(&r, _u8g2_bits_per_1);
+      do
+      {
+        // skip a background pixels
+        uint16_t nx = lx + a;
+        while (nx >= w)
+        {
+          nx -= w;
+          ly++;
+        }
+        lx = nx;
+        // set b foreground pixels, wrapping at the right edge
+        uint8_t cnt = b;
+        while (cnt)
+        {
+          uint8_t current = w - lx;
+          if (cnt < current)
+          {
+            current = cnt;
+          }
+          if (ly < h)
+          {
+            gfx_set_bit_span(bits + (ly * stride), lx, current);
+          }
+          cnt -= current;
+          lx += current;
+          if (lx >= w)
+          {
+            lx = 0;
+            ly++;
+          }
+        }
+      } while (gfx_u8g2_get_bits(&r, 1) != 0);
+
+      if (ly >= h)
+        break;
+    }
+  }
+
+  u8g2_glyph_cache_t *e = &_u8g2_glyph_cache[slot];
+  e->encoding = encoding;
+  e->width = w;
+  e->height = h;
+  e->x = _u8g2_char_x;
+  e->y = _u8g2_char_y;
+  e->delta_x = _u8g2_delta_x;
+  e->last_used = ++_u8g2_glyph_cache_clock;
+  _u8g2_glyph_bits = bits;
+  _u8g2_decode_ptr = 0;
+  return true;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Draw the decoded glyph bitmap at _u8g2_target_x/y, same color runs
+          of each row are merged into one fill
+  @param  color   16-bit 5-6-5 Color to draw chraracter with
+  @param  bg      16-bit 5-6-5 Color to fill background with (if same as color, no background)
+*/
+/**************************************************************************/
+void Arduino_GFX::u8g2_draw_glyph_bits(uint16_t color, uint16_t bg)
+{
+  uint8_t w = _u8g2_char_width, h = _u8g2_char_height;
+  uint8_t stride = (w + 7) >> 3;
+  const uint8_t *row = _u8g2_glyph_bits;
+
+  if (
+      (bg != color) && (textsize_x == 1) && (textsize_y == 1) &&
+      (_u8g2_target_x >= _min_text_x) && (_u8g2_target_y >= _min_text_y) &&
+      ((_u8g2_target_x + w - 1) <= _max_text_x) && ((_u8g2_target_y + h - 1) <= _max_text_y))
+  {
+    // opaque glyph fully inside text bound, output with one address window
+    uint16_t len = (uint16_t)w * h;
+    if (len > _glyphBufSize)
+    {
+      free(_glyphBuf);
+      _glyphBuf = (uint16_t *)malloc(len * 2);
+      _glyphBufSize = _glyphBuf ? len : 0;
+    }
+    if (_glyphBuf)
+    {
+      uint16_t *p = _glyphBuf;
+      for (uint8_t yy = 0; yy < h; ++yy, row += stride)
+      {
+        for (uint8_t xx = 0; xx < w; ++xx)
+        {
+          *p++ = (row[xx >> 3] & (0x80 >> (xx & 7))) ? color : bg;
+        }
+      }
+      draw16bitRGBBitmap(_u8g2_target_x, _u8g2_target_y, _glyphBuf, w, h);
+      return;
+    }
+  }
+
+  startWrite();
+  int16_t y = _u8g2_target_y;
+  for (uint8_t yy = 0; yy < h; ++yy, row += stride, y += textsize_y)
+  {
+    if ((y + textsize_y - 1) > _max_text_y)
+    {
+      break;
+    }
+    uint8_t xx = 0;
+    while (xx < w)
+    {
+      bool is_foreground = row[xx >> 3] & (0x80 >> (xx & 7));
+      uint8_t end = gfx_bit_run_end(row, xx + 1, w, is_foreground);
+      if (is_foreground || (bg != color))
+      {
+        int16_t x = _u8g2_target_x + (xx * textsize_x);
+        int16_t curW = (end - xx) * textsize_x;
+        if (textsize_x == 1 && textsize_y == 1)
+        {
+          if (x <= _max_text_x)
+          {
+            if ((x + curW - 1) > _max_text_x)
+            {
+              curW = _max_text_x - x + 1;
+            }
+            writeFillRect(x, y, curW, 1, is_foreground ? color : bg);
+          }
+        }
+        else if ((x + textsize_x - 1) <= _max_text_x)
+        {
+          while ((x + curW - 1) > _max_text_x)
+          {
+            curW -= textsize_x;
+          }
+          writeFillRect(x, y, curW - text_pixel_margin,
+                        textsize_y - text_pixel_margin, is_foreground ? color : bg);
+        }
+      }
+      xx = end;
+    }
+  }
+  endWrite();
+}
 #endif // defined(U8G2_FONT_SUPPORT)
 
 // TEXT- AND CHARACTER-HANDLING FUNCTIONS ----------------------------------
@@ -2026,7 +2577,11 @@ void Arduino_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
   int16_t block_w, block_h, curX, curY, curW, curH;
 
 #if !defined(ATTINY_CORE)
-  if (gfxFont) // custom font
+  if (gfxAAFont) // anti-aliased font
+  {
+    drawAAChar(x, y, c, color, bg);
+  }
+  else if (gfxFont) // custom font
   {
     // Character is assumed previously filtered by write() to eliminate
     // newlines, returns, non-printable characters, etc.  Calling
@@ -2094,6 +2649,9 @@ void Arduino_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
       {
         if (curY <= _max_text_y)
         {
+          // write horizontal runs of set bits as one span, so the output
+          // can send them with a single address window
+          int16_t runX = 0, runW = 0;
           curX = x + xo;
           for (xx = 0; xx < w; ++xx, ++curX, bits <<= 1)
           {
@@ -2101,14 +2659,24 @@ void Arduino_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
             {
               bits = pgm_read_byte(&bitmap[bo++]);
             }
-            if (curX <= _max_text_x)
+            if ((curX <= _max_text_x) && (bits & 0x80))
             {
-              if (bits & 0x80)
+              if (!runW)
               {
-                writePixelPreclipped(curX, curY, color);
+                runX = curX;
               }
+              ++runW;
+            }
+            else if (runW)
+            {
+              writeFillRectPreclipped(runX, curY, runW, 1, color);
+              runW = 0;
             }
           }
+          if (runW)
+          {
+            writeFillRectPreclipped(runX, curY, runW, 1, color);
+          }
         }
       }
     }
@@ -2150,7 +2718,12 @@ void Arduino_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
       return;
     }
 
-    if ((_u8g2_decode_ptr) && (_u8g2_char_width > 0))
+    if ((_u8g2_glyph_bits) && (_u8g2_char_width > 0))
+    {
+      _u8g2_target_x = x + (_u8g2_char_x * textsize_x);
+      u8g2_draw_glyph_bits(color, bg);
+    }
+    else if ((_u8g2_decode_ptr) && (_u8g2_char_width > 0))
     {
       uint8_t a, b;
 
@@ -2291,41 +2864,68 @@ void Arduino_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
 size_t Arduino_GFX::write(uint8_t c)
 {
 #if !defined(ATTINY_CORE)
-  if (gfxFont) // custom font
+  if (gfxAAFont) // anti-aliased font
   {
     if (c == '\n') // Newline
     {
       cursor_x = _min_text_x; // Reset x to zero, advance y by one line
-      cursor_y += (int16_t)textsize_y * pgm_read_byte(&gfxFont->yAdvance);
+      cursor_y += (int16_t)textsize_y * pgm_read_byte(&gfxAAFont->yAdvance);
     }
     else if (c != '\r') // Not a carriage return; is normal char
     {
-      uint16_t first = pgm_read_word(&gfxFont->first),
-               last = pgm_read_word(&gfxFont->last);
+      uint16_t first = pgm_read_word(&gfxAAFont->first),
+               last = pgm_read_word(&gfxAAFont->last);
       if ((c >= first) && (c <= last)) // Char present in this font?
       {
-        GFXglyph *glyph = pgm_read_glyph_ptr(gfxFont, c - first);
+        GFXAAglyph *glyph = pgm_read_aa_glyph_ptr(gfxAAFont, c - first);
         uint8_t gw = pgm_read_byte(&glyph->width),
                 xa = pgm_read_byte(&glyph->xAdvance);
         int8_t xo = pgm_read_sbyte(&glyph->xOffset);
         if (wrap && ((cursor_x + ((xo + gw) * textsize_x) - 1) > _max_text_x))
         {
           cursor_x = _min_text_x; // Reset x to zero, advance y by one line
-          cursor_y += (int16_t)textsize_y * pgm_read_byte(&gfxFont->yAdvance);
+          cursor_y += (int16_t)textsize_y * pgm_read_byte(&gfxAAFont->yAdvance);
         }
         drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor);
         cursor_x += (int16_t)textsize_x * xa;
       }
     }
   }
-  else // not gfxFont
-#endif // !defined(ATTINY_CORE)
-#if defined(U8G2_FONT_SUPPORT)
-      if (u8g2Font)
+  else if (gfxFont) // custom font
   {
-    _u8g2_decode_ptr = 0;
-
-    if (_enableUTF8Print)
+    if (c == '\n') // Newline
+    {
+      cursor_x = _min_text_x; // Reset x to zero, advance y by one line
+      cursor_y += (int16_t)textsize_y * pgm_read_byte(&gfxFont->yAdvance);
+    }
+    else if (c != '\r') // Not a carriage return; is normal char
+    {
+      uint16_t first = pgm_read_word(&gfxFont->first),
+               last = pgm_read_word(&gfxFont->last);
+      if ((c >= first) && (c <= last)) // Char present in this font?
+      {
+        GFXglyph *glyph = pgm_read_glyph_ptr(gfxFont, c - first);
+        uint8_t gw = pgm_read_byte(&glyph->width),
+                xa = pgm_read_byte(&glyph->xAdvance);
+        int8_t xo = pgm_read_sbyte(&glyph->xOffset);
+        if (wrap && ((cursor_x + ((xo + gw) * textsize_x) - 1) > _max_text_x))
+        {
+          cursor_x = _min_text_x; // Reset x to zero, advance y by one line
+          cursor_y += (int16_t)textsize_y * pgm_read_byte(&gfxFont->yAdvance);
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor);
+        cursor_x += (int16_t)textsize_x * xa;
+      }
+    }
+  }
+  else // not gfxFont
+#endif // !defined(ATTINY_CORE)
+#if defined(U8G2_FONT_SUPPORT)
+      if (u8g2Font)
+  {
+    _u8g2_decode_ptr = 0;
+
+    if (_enableUTF8Print)
     {
       if (_utf8_state == 0)
       {
@@ -2379,79 +2979,8 @@ size_t Arduino_GFX::write(uint8_t c)
       }
       else if (_encoding != '\r')
       { // Ignore carriage returns
-        uint8_t *font = u8g2Font;
-        const uint8_t *glyph_data = 0;
-
-        // extract from u8g2_font_get_glyph_data()
-        font += 23; // U8G2_FONT_DATA_STRUCT_SIZE
-        if (_encoding <= 255)
+        if (u8g2_font_decode_glyph(_encoding))
         {
-          if (_encoding >= 'a')
-          {
-            font += _u8g2_start_pos_lower_a;
-          }
-          else if (_encoding >= 'A')
-          {
-            font += _u8g2_start_pos_upper_A;
-          }
-
-          for (;;)
-          {
-            if (pgm_read_byte(font + 1) == 0)
-              break;
-            if (pgm_read_byte(font) == _encoding)
-            {
-              glyph_data = font + 2; /* skip encoding and glyph size */
-            }
-            font += pgm_read_byte(font + 1);
-          }
-        }
-#ifdef U8G2_WITH_UNICODE
-        else
-        {
-          uint16_t e;
-          font += _u8g2_start_pos_unicode;
-          const uint8_t *unicode_lookup_table = font;
-
-          /* issue 596: search for the glyph start in the unicode lookup table */
-          do
-          {
-            font += u8g2_font_get_word(unicode_lookup_table, 0);
-            e = u8g2_font_get_word(unicode_lookup_table, 2);
-            unicode_lookup_table += 4;
-          } while (e < _encoding);
-
-          for (;;)
-          {
-            e = u8g2_font_get_word(font, 0);
-
-            if (e == 0)
-              break;
-
-            if (e == _encoding)
-            {
-              glyph_data = font + 3; /* skip encoding and glyph size */
-              break;
-            }
-            font += pgm_read_byte(font + 2);
-          }
-        }
-#endif
-
-        if (glyph_data)
-        {
-          // u8g2_font_decode_glyph
-          _u8g2_decode_ptr = glyph_data;
-          _u8g2_decode_bit_pos = 0;
-
-          _u8g2_char_width = u8g2_font_decode_get_unsigned_bits(_u8g2_bits_per_char_width);
-          _u8g2_char_height = u8g2_font_decode_get_unsigned_bits(_u8g2_bits_per_char_height);
-          _u8g2_char_x = u8g2_font_decode_get_signed_bits(_u8g2_bits_per_char_x);
-          _u8g2_char_y = u8g2_font_decode_get_signed_bits(_u8g2_bits_per_char_y);
-          _u8g2_delta_x = u8g2_font_decode_get_signed_bits(_u8g2_bits_per_delta_x);
-          // log_d("c: %c, _encoding: %d, _u8g2_char_width: %d, _u8g2_char_height: %d, _u8g2_char_x: %d, _u8g2_char_y: %d, _u8g2_delta_x: %d",
-          //       c, _encoding, _u8g2_char_width, _u8g2_char_height, _u8g2_char_x, _u8g2_char_y, _u8g2_delta_x);
-
           if (_u8g2_char_width > 0)
           {
             if (wrap && ((cursor_x + (textsize_x * _u8g2_char_width) - 1) > _max_text_x))
@@ -2571,11 +3100,265 @@ void Arduino_GFX::setRotation(uint8_t r)
 void Arduino_GFX::setFont(const GFXfont *f)
 {
   gfxFont = (GFXfont *)f;
+  gfxAAFont = NULL;
 #if defined(U8G2_FONT_SUPPORT)
   u8g2Font = NULL;
 #endif // defined(U8G2_FONT_SUPPORT)
 }
 
+/**************************************************************************/
+/*!
+  @brief  Set an anti-aliased font to display when print()ing
+  @param  f   The GFXAAfont object, if NULL use built in 6x8 font
+*/
+/**************************************************************************/
+void Arduino_GFX::setAAFont(const GFXAAfont *f)
+{
+  gfxAAFont = (GFXAAfont *)f;
+  gfxFont = NULL;
+#if defined(U8G2_FONT_SUPPORT)
+  u8g2Font = NULL;
+#endif // defined(U8G2_FONT_SUPPORT)
+}
+
+/**************************************************************************/
+/*!
+  @brief  Prepare the 16 level color ramp between background and foreground
+  @param  color   16-bit 5-6-5 Color of alpha level 15
+  @param  bg      16-bit 5-6-5 Color of alpha level 0
+*/
+/**************************************************************************/
+void Arduino_GFX::updateAARamp(uint16_t color, uint16_t bg)
+{
+  if (_aaRampValid && (color == _aaRampColor) && (bg == _aaRampBg))
+  {
+    return;
+  }
+
+  uint8_t fr = color >> 11, fg = (color >> 5) & 0x3F, fb = color & 0x1F;
+  uint8_t br = bg >> 11, bgg = (bg >> 5) & 0x3F, bb = bg & 0x1F;
+  for (uint8_t a = 0; a < 16; ++a)
+  {
+    uint8_t ia = 15 - a;
+    uint16_t r = ((fr * a) + (br * ia) + 7) / 15,
+             g = ((fg * a) + (bgg * ia) + 7) / 15,
+             b = ((fb * a) + (bb * ia) + 7) / 15;
+    _aaRamp[a] = (r << 11) | (g << 5) | b;
+  }
+  _aaRampColor = color;
+  _aaRampBg = bg;
+  _aaRampValid = true;
+}
+
+// Sequential reader of GFXAAfont glyph alpha values, see gfxfont_aa.h
+typedef struct
+{
+  const uint8_t *ptr;
+  uint8_t compressed;
+  uint8_t packet;
+  uint8_t run;
+  uint8_t nibble;
+  uint8_t cur;
+} gfx_aa_decoder_t;
+
+GFX_INLINE static uint8_t gfx_aa_next_alpha(gfx_aa_decoder_t *d)
+{
+  if (d->compressed)
+  {
+    if (d->run == 0)
+    {
+      uint8_t b = pgm_read_byte(d->ptr++);
+      d->packet = b & 0xC0;
+      d->run = (b & 0x3F) + 1;
+      d->nibble = 0; // literal nibbles restart at a byte boundary
+    }
+    --d->run;
+    if (d->packet == GFXAA_PACKET_TRANSPARENT)
+    {
+      return 0;
+    }
+    if (d->packet == GFXAA_PACKET_OPAQUE)
+    {
+      return 15;
+    }
+  }
+  if (!(d->nibble++ & 1))
+  {
+    d->cur = pgm_read_byte(d->ptr++);
+    return d->cur >> 4;
+  }
+  return d->cur & 0x0F;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Draw a single character of the current anti-aliased font
+  @param  x       Bottom left corner x coordinate
+  @param  y       Bottom left corner y coordinate
+  @param  c       The 8-bit font-indexed character (likely ascii)
+  @param  color   16-bit 5-6-5 Color to draw chraracter with
+  @param  bg      16-bit 5-6-5 Color to blend with (if same as color, no background)
+  @note   With a background color every glyph is blended into a RAM buffer and
+          sent with a single draw16bitRGBBitmap(), i.e. one address window on
+          TFT. Without background color, pixels with alpha >= 8 are drawn as
+          horizontal spans of the foreground color.
+*/
+/**************************************************************************/
+void Arduino_GFX::drawAAChar(int16_t x, int16_t y, unsigned char c,
+                             uint16_t color, uint16_t bg)
+{
+  c -= pgm_read_byte(&gfxAAFont->first);
+  GFXAAglyph *glyph = pgm_read_aa_glyph_ptr(gfxAAFont, c);
+
+  uint8_t w = pgm_read_byte(&glyph->width),
+          h = pgm_read_byte(&glyph->height),
+          xAdvance = pgm_read_byte(&glyph->xAdvance),
+          yAdvance = pgm_read_byte(&gfxAAFont->yAdvance),
+          baseline = yAdvance * 2 / 3; // same as GFXfont
+  int16_t xo = pgm_read_sbyte(&glyph->xOffset),
+          yo = pgm_read_sbyte(&glyph->yOffset);
+
+  if (xAdvance < w)
+  {
+    xAdvance = w;
+  }
+
+  int16_t block_w = xAdvance * textsize_x,
+          block_h = yAdvance * textsize_y,
+          block_y = y - (baseline * textsize_y);
+  if (
+      (x > _max_text_x) ||                    // Clip right
+      (block_y > _max_text_y) ||              // Clip bottom
+      ((x + block_w - 1) < _min_text_x) ||    // Clip left
+      ((block_y + block_h - 1) < _min_text_y) // Clip top
+  )
+  {
+    return;
+  }
+
+  gfx_aa_decoder_t d = {
+      pgm_read_aa_bitmap_ptr(gfxAAFont) + pgm_read_aa_bitmap_offset(glyph),
+      pgm_read_byte(&gfxAAFont->compressed), 0, 0, 0, 0};
+  int16_t gx = x + (xo * textsize_x),
+          gy = y + (yo * textsize_y),
+          gx2 = gx + (w * textsize_x) - 1,
+          gy2 = gy + (h * textsize_y) - 1;
+  bool opaque = (bg != color);
+
+  startWrite();
+  if (opaque)
+  {
+    updateAARamp(color, bg);
+
+    // fill the character cell around the glyph box, the glyph box itself is blended later
+    int16_t cx2 = x + block_w - 1,
+            cy2 = block_y + block_h - 1;
+    if (cx2 > _max_text_x)
+    {
+      cx2 = _max_text_x;
+    }
+    if (cy2 > _max_text_y)
+    {
+      cy2 = _max_text_y;
+    }
+    int16_t ix1 = (gx > x) ? gx : x,
+            iy1 = (gy > block_y) ? gy : block_y,
+            ix2 = (gx2 < cx2) ? gx2 : cx2,
+            iy2 = (gy2 < cy2) ? gy2 : cy2;
+    if ((ix1 > ix2) || (iy1 > iy2)) // glyph box outside cell (e.g. space)
+    {
+      writeFillRect(x, block_y, cx2 - x + 1, cy2 - block_y + 1, bg);
+    }
+    else
+    {
+      if (iy1 > block_y) // top
+      {
+        writeFillRect(x, block_y, cx2 - x + 1, iy1 - block_y, bg);
+      }
+      if (cy2 > iy2) // bottom
+      {
+        writeFillRect(x, iy2 + 1, cx2 - x + 1, cy2 - iy2, bg);
+      }
+      if (ix1 > x) // left
+      {
+        writeFillRect(x, iy1, ix1 - x, iy2 - iy1 + 1, bg);
+      }
+      if (cx2 > ix2) // right
+      {
+        writeFillRect(ix2 + 1, iy1, cx2 - ix2, iy2 - iy1 + 1, bg);
+      }
+    }
+
+    if (
+        (textsize_x == 1) && (textsize_y == 1) &&
+        (gx >= _min_text_x) && (gy >= _min_text_y) &&
+        (gx2 <= _max_text_x) && (gy2 <= _max_text_y))
+    {
+      uint16_t len = (uint16_t)w * h;
+      if (len > _glyphBufSize)
+      {
+        free(_glyphBuf);
+        _glyphBuf = (uint16_t *)malloc(len * 2);
+        _glyphBufSize = _glyphBuf ? len : 0;
+      }
+      if (_glyphBuf)
+      {
+        uint16_t *p = _glyphBuf;
+        while (len--)
+        {
+          *p++ = _aaRamp[gfx_aa_next_alpha(&d)];
+        }
+        endWrite();
+        draw16bitRGBBitmap(gx, gy, _glyphBuf, w, h);
+        return;
+      }
+    }
+  }
+
+  // span by span, alpha runs share one fill
+  int16_t curY = gy;
+  for (uint8_t yy = 0; yy < h; ++yy, curY += textsize_y)
+  {
+    bool rowVisible = (curY + textsize_y - 1) <= _max_text_y;
+    int16_t spanX = gx;
+    uint8_t spanA = 0, spanLen = 0;
+    for (uint8_t xx = 0; xx <= w; ++xx)
+    {
+      uint8_t a = 0xFF; // end of row sentinel
+      if (xx < w)
+      {
+        a = gfx_aa_next_alpha(&d);
+        if (!opaque)
+        {
+          a = (a >= 8) ? 15 : 0;
+        }
+        if ((spanLen == 0) || (a == spanA))
+        {
+          spanA = a;
+          ++spanLen;
+          continue;
+        }
+      }
+      if (rowVisible && (spanLen > 0) && (opaque || spanA))
+      {
+        int16_t spanW = spanLen * textsize_x;
+        if ((spanX + spanW - 1) > _max_text_x)
+        {
+          spanW = _max_text_x - spanX + 1;
+        }
+        if (spanW > 0)
+        {
+          writeFillRect(spanX, curY, spanW, textsize_y, opaque ? _aaRamp[spanA] : color);
+        }
+      }
+      spanX += spanLen * textsize_x;
+      spanA = a;
+      spanLen = 1;
+    }
+  }
+  endWrite();
+}
+
 /**************************************************************************/
 /*!
   @brief  flush framebuffer to output (for Canvas or NeoPixel sub-class)
@@ -2590,6 +3373,7 @@ void Arduino_GFX::flush(bool force_flush)
 void Arduino_GFX::setFont(const uint8_t *font)
 {
   gfxFont = NULL;
+  gfxAAFont = NULL;
   u8g2Font = (uint8_t *)font;
 
   // extract from u8g2_read_font_info()
@@ -2633,6 +3417,23 @@ void Arduino_GFX::setFont(const uint8_t *font)
   _u8g2_start_pos_unicode = u8g2_font_get_word(font, 21);
 #endif
   _u8g2_first_char = pgm_read_byte(font + 23);
+
+  _u8g2_glyph_bits = NULL;
+  if (_u8g2_index_font != font)
+  {
+    u8g2_font_build_index();
+
+    // decoded glyph cache, each slot fit the font bounding box
+    uint16_t slot_size = (((uint8_t)_u8g2_max_char_width + 7) >> 3) * (uint8_t)_u8g2_max_char_height;
+    if (slot_size > _u8g2_glyph_cache_slot_size)
+    {
+      free(_u8g2_glyph_cache_bits);
+      _u8g2_glyph_cache_bits = (uint8_t *)malloc(slot_size * U8G2_GLYPH_CACHE_SIZE);
+      _u8g2_glyph_cache_slot_size = _u8g2_glyph_cache_bits ? slot_size : 0;
+    }
+    memset(_u8g2_glyph_cache, 0, sizeof(_u8g2_glyph_cache));
+    _u8g2_glyph_cache_clock = 0;
+  }
   // log_d("_u8g2_start_pos_upper_A: %d, _u8g2_start_pos_lower_a: %d, _u8g2_start_pos_unicode: %d, _u8g2_first_char: %d",
   //       _u8g2_start_pos_upper_A, _u8g2_start_pos_lower_a, _u8g2_start_pos_unicode, _u8g2_first_char);
 }
@@ -2654,13 +3455,73 @@ void Arduino_GFX::setUTF8Print(bool isEnable)
   @param  miny    Minimum clipping value for Y
   @param  maxx    Maximum clipping value for X
   @param  maxy    Maximum clipping value for Y
+  @param  draw_x  Optional pointer to receive the drawChar() x of the glyph
+  @param  draw_y  Optional pointer to receive the drawChar() y of the glyph
+  @return true if a glyph is placed, false for control characters, partial UTF8 sequence or missing glyph
 */
 /**************************************************************************/
-void Arduino_GFX::charBounds(char c, int16_t *x, int16_t *y,
-                             int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy)
+bool Arduino_GFX::charBounds(char c, int16_t *x, int16_t *y,
+                             int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy,
+                             int16_t *draw_x, int16_t *draw_y)
 {
+  bool placed = false;
+
 #if !defined(ATTINY_CORE)
-  if (gfxFont) // custom font
+  if (gfxAAFont) // anti-aliased font
+  {
+    if (c == '\n') // Newline
+    {
+      *x = _min_text_x; // Reset x to zero, advance y by one line
+      *y += (int16_t)textsize_y * (uint8_t)pgm_read_byte(&gfxAAFont->yAdvance);
+    }
+    else if (c != '\r') // Not a carriage return; is normal char
+    {
+      uint16_t first = pgm_read_word(&gfxAAFont->first),
+               last = pgm_read_word(&gfxAAFont->last);
+      if (((uint8_t)c >= first) && ((uint8_t)c <= last)) // Char present in this font?
+      {
+        GFXAAglyph *glyph = pgm_read_aa_glyph_ptr(gfxAAFont, (uint8_t)c - first);
+        uint8_t gw = pgm_read_byte(&glyph->width),
+                gh = pgm_read_byte(&glyph->height),
+                xa = pgm_read_byte(&glyph->xAdvance);
+        int8_t xo = pgm_read_sbyte(&glyph->xOffset),
+               yo = pgm_read_sbyte(&glyph->yOffset);
+        if (wrap && ((*x + ((xo + gw) * textsize_x) - 1) > _max_text_x))
+        {
+          *x = _min_text_x; // Reset x to zero, advance y by one line
+          *y += (int16_t)textsize_y * (uint8_t)pgm_read_byte(&gfxAAFont->yAdvance);
+        }
+        if (draw_x)
+        {
+          *draw_x = *x;
+          *draw_y = *y;
+        }
+        placed = true;
+        int16_t x1 = *x + ((int16_t)xo * textsize_x),
+                y1 = *y + ((int16_t)yo * textsize_y),
+                x2 = x1 + ((int16_t)gw * textsize_x) - 1,
+                y2 = y1 + ((int16_t)gh * textsize_y) - 1;
+        if (x1 < *minx)
+        {
+          *minx = x1;
+        }
+        if (y1 < *miny)
+        {
+          *miny = y1;
+        }
+        if (x2 > *maxx)
+        {
+          *maxx = x2;
+        }
+        if (y2 > *maxy)
+        {
+          *maxy = y2;
+        }
+        *x += (int16_t)textsize_x * xa;
+      }
+    }
+  }
+  else if (gfxFont) // custom font
   {
     if (c == '\n') // Newline
     {
@@ -2684,6 +3545,12 @@ void Arduino_GFX::charBounds(char c, int16_t *x, int16_t *y,
           *x = _min_text_x; // Reset x to zero, advance y by one line
           *y += (int16_t)textsize_y * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
         }
+        if (draw_x)
+        {
+          *draw_x = *x;
+          *draw_y = *y;
+        }
+        placed = true;
         int16_t x1 = *x + ((int16_t)xo * textsize_x),
                 y1 = *y + ((int16_t)yo * textsize_y),
                 x2 = x1 + ((int16_t)gw * textsize_x) - 1,
@@ -2769,68 +3636,12 @@ void Arduino_GFX::charBounds(char c, int16_t *x, int16_t *y,
       }
       else if (_encoding != '\r')
       { // Ignore carriage returns
-        uint8_t *font = u8g2Font;
-        const uint8_t *glyph_data = 0;
-
-        // extract from u8g2_font_get_glyph_data()
-        font += 23; // U8G2_FONT_DATA_STRUCT_SIZE
-        if (_encoding <= 255)
-        {
-          if (_encoding >= 'a')
-          {
-            font += _u8g2_start_pos_lower_a;
-          }
-          else if (_encoding >= 'A')
-          {
-            font += _u8g2_start_pos_upper_A;
-          }
-
-          for (;;)
-          {
-            if (pgm_read_byte(font + 1) == 0)
-              break;
-            if (pgm_read_byte(font) == _encoding)
-            {
-              glyph_data = font + 2; /* skip encoding and glyph size */
-            }
-            font += pgm_read_byte(font + 1);
-          }
-        }
-#ifdef U8G2_WITH_UNICODE
-        else
-        {
-          uint16_t e;
-          font += _u8g2_start_pos_unicode;
-          const uint8_t *unicode_lookup_table = font;
-
-          /* issue 596: search for the glyph start in the unicode lookup table */
-          do
-          {
-            font += u8g2_font_get_word(unicode_lookup_table, 0);
-            e = u8g2_font_get_word(unicode_lookup_table, 2);
-            unicode_lookup_table += 4;
-          } while (e < _encoding);
-
-          for (;;)
-          {
-            e = u8g2_font_get_word(font, 0);
-
-            if (e == 0)
-              break;
-
-            if (e == _encoding)
-            {
-              glyph_data = font + 3; /* skip encoding and glyph size */
-              break;
-            }
-            font += pgm_read_byte(font + 2);
-          }
-        }
-#endif
+        const uint8_t *glyph_data = u8g2_font_get_glyph_data(_encoding);
 
         if (glyph_data)
         {
           // u8g2_font_decode_glyph
+          _u8g2_glyph_bits = NULL;
           _u8g2_decode_ptr = glyph_data;
           _u8g2_decode_bit_pos = 0;
 
@@ -2851,6 +3662,12 @@ void Arduino_GFX::charBounds(char c, int16_t *x, int16_t *y,
             }
           }
 
+          if (draw_x)
+          {
+            *draw_x = *x;
+            *draw_y = *y;
+          }
+          placed = true;
           int16_t x1 = *x + ((int16_t)_u8g2_char_x * textsize_x),
                   y1 = *y - (((int16_t)_u8g2_char_height + _u8g2_char_y) * textsize_y),
                   x2 = x1 + ((int16_t)_u8g2_char_width * textsize_x) - 1,
@@ -2892,6 +3709,12 @@ void Arduino_GFX::charBounds(char c, int16_t *x, int16_t *y,
         *x = _min_text_x;     // Reset x to zero,
         *y += textsize_y * 8; // advance y one line
       }
+      if (draw_x)
+      {
+        *draw_x = *x;
+        *draw_y = *y;
+      }
+      placed = true;
       int16_t x2 = *x + textsize_x * 6 - 1; // Lower-right pixel of char
       int16_t y2 = *y + textsize_y * 8 - 1;
       if (x2 > *maxx)
@@ -2913,6 +3736,47 @@ void Arduino_GFX::charBounds(char c, int16_t *x, int16_t *y,
       *x += textsize_x * 6; // Advance x one char
     }
   }
+  return placed;
+}
+
+// FNV-1a hash, seed with GFX_FNV1A_SEED
+#define GFX_FNV1A_SEED 2166136261UL
+GFX_INLINE static uint32_t gfx_fnv1a(uint32_t hash, const void *data, size_t len)
+{
+  const uint8_t *p = (const uint8_t *)data;
+  while (len--)
+  {
+    hash ^= *p++;
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Pointer of the current font, whatever the font type
+  @return Current font, NULL for the built in 6x8 font
+*/
+/**************************************************************************/
+const void *Arduino_GFX::currentFont()
+{
+#if !defined(ATTINY_CORE)
+  if (gfxAAFont)
+  {
+    return gfxAAFont;
+  }
+  if (gfxFont)
+  {
+    return gfxFont;
+  }
+#endif // !defined(ATTINY_CORE)
+#if defined(U8G2_FONT_SUPPORT)
+  if (u8g2Font)
+  {
+    return u8g2Font;
+  }
+#endif // defined(U8G2_FONT_SUPPORT)
+  return NULL;
 }
 
 /**************************************************************************/
@@ -2932,6 +3796,46 @@ void Arduino_GFX::getTextBounds(const char *str, int16_t x, int16_t y,
 {
   uint8_t c; // Current character
 
+#if !defined(ATTINY_CORE) && (GFX_TEXT_BOUNDS_CACHE_SIZE > 0)
+  // the result only depends on the string and the text state below
+  struct
+  {
+    const void *font;
+    int16_t x, y, min_text_x, min_text_y, max_text_x, max_text_y;
+    uint8_t textsize_x, textsize_y;
+    bool wrap, utf8;
+  } state;
+  memset(&state, 0, sizeof(state)); // hash padding bytes deterministically
+  state.font = currentFont();
+  state.x = x;
+  state.y = y;
+  state.min_text_x = _min_text_x;
+  state.min_text_y = _min_text_y;
+  state.max_text_x = _max_text_x;
+  state.max_text_y = _max_text_y;
+  state.textsize_x = textsize_x;
+  state.textsize_y = textsize_y;
+  state.wrap = wrap;
+#if defined(U8G2_FONT_SUPPORT)
+  state.utf8 = _enableUTF8Print;
+#endif // defined(U8G2_FONT_SUPPORT)
+  size_t len = strlen(str);
+  uint32_t key = gfx_fnv1a(gfx_fnv1a(GFX_FNV1A_SEED, &state, sizeof(state)), str, len);
+
+  for (uint8_t i = 0; i < GFX_TEXT_BOUNDS_CACHE_SIZE; ++i)
+  {
+    gfx_text_bounds_cache_t *e = &_textBoundsCache[i];
+    if (e->used && (e->key == key) && (e->len == len))
+    {
+      *x1 = e->x1;
+      *y1 = e->y1;
+      *w = e->w;
+      *h = e->h;
+      return;
+    }
+  }
+#endif // !defined(ATTINY_CORE) && (GFX_TEXT_BOUNDS_CACHE_SIZE > 0)
+
   *x1 = x;
   *y1 = y;
   *w = *h = 0;
@@ -2953,8 +3857,213 @@ void Arduino_GFX::getTextBounds(const char *str, int16_t x, int16_t y,
     *y1 = miny;
     *h = maxy - miny + 1;
   }
+
+#if !defined(ATTINY_CORE) && (GFX_TEXT_BOUNDS_CACHE_SIZE > 0)
+  gfx_text_bounds_cache_t *e = &_textBoundsCache[_textBoundsCacheNext];
+  _textBoundsCacheNext = (_textBoundsCacheNext + 1) % GFX_TEXT_BOUNDS_CACHE_SIZE;
+  e->key = key;
+  e->len = len;
+  e->x1 = *x1;
+  e->y1 = *y1;
+  e->w = *w;
+  e->h = *h;
+  e->used = true;
+#endif // !defined(ATTINY_CORE) && (GFX_TEXT_BOUNDS_CACHE_SIZE > 0)
 }
 
+
+#if !defined(ATTINY_CORE)
+/**************************************************************************/
+/*!
+  @brief  Measure a string once and keep the position of every glyph, so it
+          can be drawn later by drawTextLayout() without measuring again.
+          Lines break at '\n' and, if text wrap is on, at the text bound.
+  @param  layout  Layout to fill
+  @param  str     The ascii (or UTF8 for u8g2 font) string to layout, not referenced after return
+  @param  x       Anchor X, left edge of each line, center or right edge depends on align
+  @param  y       Anchor Y, first line baseline (cursor Y), or top, middle or bottom of the text box
+  @param  align   GFX_TEXT_ALIGN_LEFT / CENTER / RIGHT or-ed with GFX_TEXT_ALIGN_BASELINE / TOP / MIDDLE / BOTTOM
+  @return false if the string has more than GFX_TEXT_LAYOUT_MAX_GLYPHS glyphs,
+          only the first GFX_TEXT_LAYOUT_MAX_GLYPHS glyphs are kept
+  @note   Draw the layout with the same font and text size.
+*/
+/**************************************************************************/
+bool Arduino_GFX::layoutText(gfx_text_layout_t *layout, const char *str, int16_t x, int16_t y, uint8_t align)
+{
+  uint8_t c, h_align = align & 0x0F;
+  int16_t cx = (h_align == GFX_TEXT_ALIGN_LEFT) ? x : _min_text_x, cy = y;
+  int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -0x7FFF, maxy = -0x7FFF;
+  int16_t line_minx = 0x7FFF, line_maxx = -0x7FFF;
+  uint8_t line_start = 0;
+
+  layout->glyph_cnt = 0;
+  layout->lines = 0;
+  layout->truncated = false;
+
+  for (;;)
+  {
+    int16_t draw_x, draw_y;
+    int16_t gminx = 0x7FFF, gminy = 0x7FFF, gmaxx = -0x7FFF, gmaxy = -0x7FFF;
+    bool placed = false;
+    c = *str++;
+    if (c)
+    {
+      placed = charBounds(c, &cx, &cy, &gminx, &gminy, &gmaxx, &gmaxy, &draw_x, &draw_y);
+      if (placed && (layout->glyph_cnt >= GFX_TEXT_LAYOUT_MAX_GLYPHS))
+      {
+        layout->truncated = true;
+        placed = false;
+        c = 0;
+      }
+    }
+
+    // finish the current line at end of string or when the glyph is on a new line
+    uint8_t cnt = layout->glyph_cnt;
+    if ((cnt > line_start) && ((!c) || (placed && (draw_y != layout->glyph_y[cnt - 1]))))
+    {
+      int16_t dx = 0;
+      if (h_align == GFX_TEXT_ALIGN_CENTER)
+      {
+        dx = x - ((line_maxx - line_minx + 1) / 2) - line_minx;
+      }
+      else if (h_align == GFX_TEXT_ALIGN_RIGHT)
+      {
+        dx = x - line_maxx;
+      }
+      for (uint8_t i = line_start; i < cnt; ++i)
+      {
+        layout->glyph_x[i] += dx;
+      }
+      if ((line_minx + dx) < minx)
+      {
+        minx = line_minx + dx;
+      }
+      if ((line_maxx + dx) > maxx)
+      {
+        maxx = line_maxx + dx;
+      }
+      layout->lines++;
+      line_start = cnt;
+      line_minx = 0x7FFF;
+      line_maxx = -0x7FFF;
+    }
+    if (!c)
+    {
+      break;
+    }
+
+    if (placed)
+    {
+      layout->glyph_x[cnt] = draw_x;
+      layout->glyph_y[cnt] = draw_y;
+#if defined(U8G2_FONT_SUPPORT)
+      layout->encoding[cnt] = u8g2Font ? _encoding : c;
+#else
+      layout->encoding[cnt] = c;
+#endif // defined(U8G2_FONT_SUPPORT)
+      layout->glyph_cnt++;
+      if (gmaxx >= gminx)
+      {
+        if (gminx < line_minx)
+        {
+          line_minx = gminx;
+        }
+        if (gmaxx > line_maxx)
+        {
+          line_maxx = gmaxx;
+        }
+      }
+      if (gmaxy >= gminy)
+      {
+        if (gminy < miny)
+        {
+          miny = gminy;
+        }
+        if (gmaxy > maxy)
+        {
+          maxy = gmaxy;
+        }
+      }
+    }
+  }
+
+  int16_t dy = 0;
+  if (maxy >= miny)
+  {
+    uint8_t v_align = align & 0xF0;
+    if (v_align == GFX_TEXT_ALIGN_TOP)
+    {
+      dy = y - miny;
+    }
+    else if (v_align == GFX_TEXT_ALIGN_MIDDLE)
+    {
+      dy = y - ((maxy - miny + 1) / 2) - miny;
+    }
+    else if (v_align == GFX_TEXT_ALIGN_BOTTOM)
+    {
+      dy = y - maxy;
+    }
+    for (uint8_t i = 0; i < layout->glyph_cnt; ++i)
+    {
+      layout->glyph_y[i] += dy;
+    }
+  }
+
+  layout->x1 = x;
+  layout->y1 = y;
+  layout->w = layout->h = 0;
+  if (maxx >= minx)
+  {
+    layout->x1 = minx;
+    layout->w = maxx - minx + 1;
+  }
+  if (maxy >= miny)
+  {
+    layout->y1 = miny + dy;
+    layout->h = maxy - miny + 1;
+  }
+  layout->clip_w = layout->clip_h = 0;
+
+  return !layout->truncated;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Draw a layout prepared by layoutText(), glyphs are drawn at their
+          stored positions without any measuring or wrapping
+  @param  layout  Layout to draw
+  @param  color   16-bit 5-6-5 Color to draw text with
+  @param  bg      16-bit 5-6-5 Color to fill background with (if same as color, no background)
+  @note   If layout clip_w and clip_h are set, text bound is limited to the
+          clip rect while drawing.
+*/
+/**************************************************************************/
+void Arduino_GFX::drawTextLayout(const gfx_text_layout_t *layout, uint16_t color, uint16_t bg)
+{
+  int16_t min_text_x = _min_text_x, min_text_y = _min_text_y,
+          max_text_x = _max_text_x, max_text_y = _max_text_y;
+  if (layout->clip_w && layout->clip_h)
+  {
+    setTextBound(layout->clip_x, layout->clip_y, layout->clip_w, layout->clip_h);
+  }
+
+  for (uint8_t i = 0; i < layout->glyph_cnt; ++i)
+  {
+#if defined(U8G2_FONT_SUPPORT)
+    if ((!u8g2Font) || u8g2_font_decode_glyph(layout->encoding[i]))
+#endif // defined(U8G2_FONT_SUPPORT)
+    {
+      drawChar(layout->glyph_x[i], layout->glyph_y[i], (unsigned char)layout->encoding[i], color, bg);
+    }
+  }
+
+  _min_text_x = min_text_x;
+  _min_text_y = min_text_y;
+  _max_text_x = max_text_x;
+  _max_text_y = max_text_y;
+}
+#endif // !defined(ATTINY_CORE)
+
 /**************************************************************************/
 /*!
   @brief  Helper to determine size of a string with current font/size. Pass string and a cursor position, returns UL corner and W,H.
@@ -3043,6 +4152,77 @@ void Arduino_GFX::displayOff()
 {
 }
 
+/**************************************************************************/
+/*!
+  @brief  Split the panel into a fixed top, a hardware scrolled middle and a
+    fixed bottom area, rows count along the panel height in rotation 0
+  @param  top_fixed     rows at the top that do not scroll
+  @param  bottom_fixed  rows at the bottom that do not scroll
+  @return false if not supported by the display
+*/
+/**************************************************************************/
+bool Arduino_GFX::setScrollArea(uint16_t, uint16_t)
+{
+  return false;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Show the scroll area starting from one of its rows, the rows
+    above it wrap around to the bottom of the area
+  @param  line  row of the scroll area shown first, 0 is no scroll
+*/
+/**************************************************************************/
+void Arduino_GFX::scrollTo(uint16_t)
+{
+}
+
+/**************************************************************************/
+/*!
+  @brief  Partial display mode, only the given rows are driven, the rest of
+    the panel is blank, rows count along the panel height in rotation 0
+  @param  y  first displayed row
+  @param  h  displayed row count
+  @return false if not supported by the display
+*/
+/**************************************************************************/
+bool Arduino_GFX::partialDisplay(uint16_t, uint16_t)
+{
+  return false;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Leave partial display mode
+*/
+/**************************************************************************/
+void Arduino_GFX::normalDisplay()
+{
+}
+
+/**************************************************************************/
+/*!
+  @brief  Idle mode, reduced 8 color depth for less panel power
+  @param  i  True to enter idle mode, false for full color
+*/
+/**************************************************************************/
+void Arduino_GFX::idleDisplay(bool)
+{
+}
+
+/**************************************************************************/
+/*!
+  @brief  Tearing effect output, the display pulses its TE pin at the start
+    of each vertical blanking, see Arduino_FramePacer
+  @param  te  True to enable the TE signal, false to disable
+  @return false if not supported by the display
+*/
+/**************************************************************************/
+bool Arduino_GFX::tearingEffect(bool)
+{
+  return false;
+}
+
 /**************************************************************************/
 /*!
   @brief  Enable Round Mode For Round Display
@@ -11,7 +11,9 @@
 
 #if !defined(ATTINY_CORE)
 #include "gfxfont.h"
+#include "gfxfont_aa.h"
 #endif // !defined(ATTINY_CORE)
+#include "gfxconvert.h"
 
 #ifndef DEGTORAD
 #define DEGTORAD 0.017453292519943295769236907684886F
@@ -27,6 +29,30 @@
 #include "font/u8g2_font_unifont_t_chinese.h"
 #include "font/u8g2_font_unifont_t_chinese4.h"
 #include "font/u8g2_font_unifont_t_cjk.h"
+
+#ifndef U8G2_FONT_INDEX_STEP
+#define U8G2_FONT_INDEX_STEP 32 // glyphs per sparse glyph index entry, 0 to disable the index
+#endif
+#ifndef U8G2_GLYPH_CACHE_SIZE
+#define U8G2_GLYPH_CACHE_SIZE 8 // decoded glyphs kept in RAM, at least 1
+#endif
+
+typedef struct
+{
+  uint32_t offset; // glyph position from font start
+  uint16_t encoding;
+} u8g2_font_index_t;
+
+typedef struct
+{
+  uint32_t last_used; // 0 for empty slot
+  uint16_t encoding;
+  uint8_t width;
+  uint8_t height;
+  int8_t x;
+  int8_t y;
+  int8_t delta_x;
+} u8g2_glyph_cache_t;
 #endif
 
 #define RGB565(r, g, b) ((((r) & 0xF8) << 8) | (((g) & 0xFC) << 3) | ((b) >> 3))
@@ -138,6 +164,51 @@
 #endif
 
 #if !defined(ATTINY_CORE)
+#define GFX_TEXT_ALIGN_LEFT 0x00     ///< x is the left edge (cursor X) of every line
+#define GFX_TEXT_ALIGN_CENTER 0x01   ///< x is the horizontal center of every line
+#define GFX_TEXT_ALIGN_RIGHT 0x02    ///< x is the right edge of every line
+#define GFX_TEXT_ALIGN_BASELINE 0x00 ///< y is the cursor Y of the first line
+#define GFX_TEXT_ALIGN_TOP 0x10      ///< y is the top of the text box
+#define GFX_TEXT_ALIGN_MIDDLE 0x20   ///< y is the vertical center of the text box
+#define GFX_TEXT_ALIGN_BOTTOM 0x40   ///< y is the bottom of the text box
+
+#ifndef GFX_TEXT_LAYOUT_MAX_GLYPHS
+#define GFX_TEXT_LAYOUT_MAX_GLYPHS 32
+#endif
+#ifndef GFX_TEXT_BOUNDS_CACHE_SIZE
+#define GFX_TEXT_BOUNDS_CACHE_SIZE 8 // memoized getTextBounds() results, 0 to disable
+#endif
+
+/// Measured text, filled by layoutText() and drawn by drawTextLayout()
+typedef struct
+{
+  int16_t x1;                                    ///< Text box top left X
+  int16_t y1;                                    ///< Text box top left Y
+  uint16_t w;                                    ///< Text box width
+  uint16_t h;                                    ///< Text box height
+  int16_t clip_x;                                ///< Optional clip rect applied by drawTextLayout()
+  int16_t clip_y;                                ///< Optional clip rect applied by drawTextLayout()
+  uint16_t clip_w;                               ///< Optional clip rect width, 0 for no clip
+  uint16_t clip_h;                               ///< Optional clip rect height, 0 for no clip
+  uint8_t lines;                                 ///< Number of lines
+  uint8_t glyph_cnt;                             ///< Number of glyphs stored
+  bool truncated;                                ///< String has more than GFX_TEXT_LAYOUT_MAX_GLYPHS glyphs
+  uint16_t encoding[GFX_TEXT_LAYOUT_MAX_GLYPHS]; ///< Glyph character code
+  int16_t glyph_x[GFX_TEXT_LAYOUT_MAX_GLYPHS];   ///< Glyph drawChar() X
+  int16_t glyph_y[GFX_TEXT_LAYOUT_MAX_GLYPHS];   ///< Glyph drawChar() Y
+} gfx_text_layout_t;
+
+typedef struct
+{
+  uint32_t key; // hash of string and text state
+  uint16_t len;
+  int16_t x1;
+  int16_t y1;
+  uint16_t w;
+  uint16_t h;
+  bool used;
+} gfx_text_bounds_cache_t;
+
 GFX_INLINE static GFXglyph *pgm_read_glyph_ptr(const GFXfont *gfxFont, uint8_t c)
 {
 #ifdef __AVR__
@@ -161,6 +232,34 @@ GFX_INLINE static uint8_t *pgm_read_bitmap_ptr(const GFXfont *gfxFont)
   return gfxFont->bitmap;
 #endif //__AVR__
 }
+
+GFX_INLINE static GFXAAglyph *pgm_read_aa_glyph_ptr(const GFXAAfont *gfxAAFont, uint8_t c)
+{
+#ifdef __AVR__
+  return &(((GFXAAglyph *)pgm_read_pointer(&gfxAAFont->glyph))[c]);
+#else
+  return gfxAAFont->glyph + c;
+#endif //__AVR__
+}
+
+GFX_INLINE static uint8_t *pgm_read_aa_bitmap_ptr(const GFXAAfont *gfxAAFont)
+{
+#ifdef __AVR__
+  return (uint8_t *)pgm_read_pointer(&gfxAAFont->bitmap);
+#else
+  return gfxAAFont->bitmap;
+#endif //__AVR__
+}
+
+GFX_INLINE static uint32_t pgm_read_aa_bitmap_offset(const GFXAAglyph *glyph)
+{
+#ifdef __AVR__
+  return pgm_read_dword(&glyph->bitmapOffset);
+#else
+  // pgm_read_dword() reads an unsigned long, 8 bytes on 64-bit hosts
+  return glyph->bitmapOffset;
+#endif //__AVR__
+}
 #endif // !defined(ATTINY_CORE)
 
 /// A generic graphics superclass that can handle all sorts of drawing. At a minimum you can subclass and provide drawPixel(). At a maximum you can do a ton of overriding to optimize. Used for any/all Adafruit displays!
@@ -194,6 +293,12 @@ public:
   virtual void invertDisplay(bool i);
   virtual void displayOn();
   virtual void displayOff();
+  virtual bool setScrollArea(uint16_t top_fixed, uint16_t bottom_fixed);
+  virtual void scrollTo(uint16_t line);
+  virtual bool partialDisplay(uint16_t y, uint16_t h);
+  virtual void normalDisplay();
+  virtual void idleDisplay(bool i);
+  virtual bool tearingEffect(bool te);
   bool enableRoundMode();
 
   // BASIC DRAW API
@@ -229,9 +334,14 @@ public:
   void setTextSize(uint8_t s);
   void setTextSize(uint8_t sx, uint8_t sy);
   void setTextSize(uint8_t sx, uint8_t sy, uint8_t pixel_margin);
+#if !defined(ATTINY_CORE)
+  bool layoutText(gfx_text_layout_t *layout, const char *str, int16_t x, int16_t y, uint8_t align = GFX_TEXT_ALIGN_LEFT);
+  void drawTextLayout(const gfx_text_layout_t *layout, uint16_t color, uint16_t bg);
+#endif // !defined(ATTINY_CORE)
 
 #if !defined(ATTINY_CORE)
   void setFont(const GFXfont *f = NULL);
+  void setAAFont(const GFXAAfont *f);
 #if defined(U8G2_FONT_SUPPORT)
   void setFont(const uint8_t *font);
   void setUTF8Print(bool isEnable);
@@ -239,6 +349,7 @@ public:
   uint8_t u8g2_font_decode_get_unsigned_bits(uint8_t cnt);
   int8_t u8g2_font_decode_get_signed_bits(uint8_t cnt);
   void u8g2_font_decode_len(uint8_t len, uint8_t is_foreground, uint16_t color, uint16_t bg);
+  const uint8_t *u8g2_font_get_glyph_data(uint16_t encoding);
 #endif // defined(U8G2_FONT_SUPPORT)
   virtual void flush(bool force_flush = false);
 #endif // !defined(ATTINY_CORE)
@@ -410,7 +521,20 @@ public:
   }
 
 protected:
-  void charBounds(char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy);
+#if !defined(ATTINY_CORE)
+  void drawAAChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg);
+  void updateAARamp(uint16_t color, uint16_t bg);
+#endif // !defined(ATTINY_CORE)
+#if defined(U8G2_FONT_SUPPORT)
+  void u8g2_font_build_index();
+  bool u8g2_font_decode_glyph(uint16_t encoding);
+  void u8g2_draw_glyph_bits(uint16_t color, uint16_t bg);
+#endif // defined(U8G2_FONT_SUPPORT)
+#if !defined(LITTLE_FOOT_PRINT)
+  void drawConvertedBitmap(int16_t x, int16_t y, uint8_t format, const uint8_t *bitmap, const uint16_t *color_index, int16_t w, int16_t h, int16_t x_skip = 0);
+#endif // !defined(LITTLE_FOOT_PRINT)
+  bool charBounds(char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy, int16_t *draw_x = NULL, int16_t *draw_y = NULL);
+  const void *currentFont();
   int16_t
       _width,  ///< Display width as modified by current rotation
       _height, ///< Display height as modified by current rotation
@@ -433,8 +557,19 @@ protected:
   bool
       wrap; ///< If set, 'wrap' text at right edge of display
 #if !defined(ATTINY_CORE)
-  GFXfont *gfxFont; ///< Pointer to special font
-#endif              // !defined(ATTINY_CORE)
+  GFXfont *gfxFont;     ///< Pointer to special font
+  GFXAAfont *gfxAAFont; ///< Pointer to anti-aliased font
+  uint16_t *_glyphBuf = NULL;   ///< Glyph pixels for single window output, allocated on first use
+  uint16_t _glyphBufSize = 0;   ///< _glyphBuf capacity in pixels
+  uint16_t _aaRamp[16];         ///< Color for each alpha level of the last (color, bg) pair
+  uint16_t _aaRampColor = 0;
+  uint16_t _aaRampBg = 0;
+  bool _aaRampValid = false;
+#if (GFX_TEXT_BOUNDS_CACHE_SIZE > 0)
+  gfx_text_bounds_cache_t _textBoundsCache[GFX_TEXT_BOUNDS_CACHE_SIZE] = {};
+  uint8_t _textBoundsCacheNext = 0;
+#endif // (GFX_TEXT_BOUNDS_CACHE_SIZE > 0)
+#endif // !defined(ATTINY_CORE)
 
 #if defined(U8G2_FONT_SUPPORT)
   uint8_t *u8g2Font;
@@ -470,6 +605,15 @@ protected:
 
   const uint8_t *_u8g2_decode_ptr;
   uint8_t _u8g2_decode_bit_pos;
+
+  const uint8_t *_u8g2_index_font = NULL; ///< Font of _u8g2_index and _u8g2_glyph_cache
+  u8g2_font_index_t *_u8g2_index = NULL;
+  uint16_t _u8g2_index_cnt = 0;
+  u8g2_glyph_cache_t _u8g2_glyph_cache[U8G2_GLYPH_CACHE_SIZE];
+  uint32_t _u8g2_glyph_cache_clock = 0;
+  uint8_t *_u8g2_glyph_cache_bits = NULL; ///< U8G2_GLYPH_CACHE_SIZE slots of 1-bit glyph bitmap
+  uint16_t _u8g2_glyph_cache_slot_size = 0;
+  const uint8_t *_u8g2_glyph_bits = NULL; ///< Decoded bitmap of current glyph
 #endif // defined(U8G2_FONT_SUPPORT)
 
 #if defined(LITTLE_FOOT_PRINT)
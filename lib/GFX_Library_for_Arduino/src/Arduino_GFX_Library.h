@@ -28,6 +28,7 @@
 #include "databus/Arduino_HWSPI.h"
 #include "databus/Arduino_mbedSPI.h"
 #include "databus/Arduino_NRFXSPI.h"
+#include "databus/Arduino_RecordBus.h"
 #include "databus/Arduino_RPiPicoPAR8.h"
 #include "databus/Arduino_RPiPicoPAR16.h"
 #include "databus/Arduino_RPiPicoSPI.h"
@@ -46,6 +47,9 @@
 #include "canvas/Arduino_Canvas_Indexed.h"
 #include "canvas/Arduino_Canvas_3bit.h"
 #include "canvas/Arduino_Canvas_Mono.h"
+#include "canvas/Arduino_Canvas_Strip.h"
+#include "canvas/Arduino_BandQueue.h"
+#include "canvas/Arduino_ImagePipeline.h"
 #include "display/Arduino_ILI9488_3bit.h"
 #endif // !defined(LITTLE_FOOT_PRINT)
 
@@ -97,6 +101,8 @@
 #include "display/Arduino_ST77916.h"
 #include "display/Arduino_ST7796.h"
 #include "display/Arduino_WEA2012.h"
+#include "Arduino_TFT_T.h"
+#include "Arduino_FramePacer.h"
 
 #if defined(ARDUINO_ARCH_SAMD) && defined(SEEED_GROVE_UI_WIRELESS)
 #define DISPLAY_DEV_KIT
@@ -42,9 +42,19 @@ bool Arduino_TFT::begin(int32_t speed)
   return true;
 }
 
+/**************************************************************************/
+/*!
+  @brief  Start a display-writing routine. Calls may nest, the bus stays
+    selected until the outermost endWrite(), so a sketch can wrap many
+    drawing calls in one startWrite() / endWrite() pair to batch them.
+*/
+/**************************************************************************/
 void Arduino_TFT::startWrite()
 {
-  _bus->beginWrite();
+  if (_writeDepth++ == 0)
+  {
+    _bus->beginWrite();
+  }
 }
 
 void Arduino_TFT::writePixelPreclipped(int16_t x, int16_t y, uint16_t color)
@@ -129,9 +139,21 @@ void Arduino_TFT::writeFillRectPreclipped(
   writeRepeat(color, (uint32_t)w * h);
 }
 
+/**************************************************************************/
+/*!
+  @brief  End a display-writing routine, see startWrite()
+*/
+/**************************************************************************/
 void Arduino_TFT::endWrite()
 {
-  _bus->endWrite();
+  if (_writeDepth)
+  {
+    if (--_writeDepth == 0)
+    {
+      _windowStreaming = false;
+      _bus->endWrite();
+    }
+  }
 }
 
 void Arduino_TFT::setAddrWindow(int16_t x0, int16_t y0, uint16_t w,
@@ -140,10 +162,47 @@ void Arduino_TFT::setAddrWindow(int16_t x0, int16_t y0, uint16_t w,
   startWrite();
 
   writeAddrWindow(x0, y0, w, h);
+  // caller writes any number of pixels
+  _windowStreaming = false;
 
   endWrite();
 }
 
+/**************************************************************************/
+/*!
+  @brief  Address window coalescing for writeAddrWindow() implementations.
+    Inside a write batch, a write of the rows right below the last write with
+    the same x and width continues the open RAMWR and needs no command at
+    all. Otherwise the window is opened down to the bottom of the display so
+    that the following rows can continue it, callers still write exactly
+    w * h pixels.
+  @param  x  Top left corner x coordinate
+  @param  y  Top left corner y coordinate
+  @param  w  Width in pixels
+  @param  h  Height in pixels, may be extended to the bottom of the display
+  @return true if the open window continues and no command should be sent
+*/
+/**************************************************************************/
+bool Arduino_TFT::coalesceAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t *h)
+{
+  if (!_writeDepth)
+  {
+    return false;
+  }
+  if (_windowStreaming && (x == _currentX) && (w == _currentW) && (y == _streamY))
+  {
+    _streamY += *h;
+    return true;
+  }
+  _windowStreaming = true;
+  _streamY = y + *h;
+  if (*h < (_height - y))
+  {
+    *h = _height - y;
+  }
+  return false;
+}
+
 void Arduino_TFT::setRotation(uint8_t r)
 {
   Arduino_GFX::setRotation(r);
@@ -174,6 +233,7 @@ void Arduino_TFT::setRotation(uint8_t r)
   _currentY = 0xFFFF;
   _currentW = 0xFFFF;
   _currentH = 0xFFFF;
+  _windowStreaming = false;
 }
 
 void Arduino_TFT::writeColor(uint16_t color)
@@ -181,6 +241,123 @@ void Arduino_TFT::writeColor(uint16_t color)
   _bus->write16(color);
 }
 
+/**************************************************************************/
+/*!
+  @brief  Define the hardware scroll area with VSCRDEF, the frame memory
+    rows above and below the panel count as fixed area
+  @param  top_fixed     rows at the top that do not scroll
+  @param  bottom_fixed  rows at the bottom that do not scroll
+  @return false if the controller is not supported or no row is left to
+    scroll
+*/
+/**************************************************************************/
+bool Arduino_TFT::setScrollArea(uint16_t top_fixed, uint16_t bottom_fixed)
+{
+  if ((!_gramHeight) || ((uint32_t)top_fixed + bottom_fixed >= (uint32_t)HEIGHT))
+  {
+    return false;
+  }
+  _scrollTop = ROW_OFFSET1 + top_fixed;
+  _scrollHeight = HEIGHT - top_fixed - bottom_fixed;
+
+  _windowStreaming = false;
+  startWrite();
+  _bus->writeCommand(TFT_VSCRDEF);
+  _bus->write16(_scrollTop);
+  _bus->write16(_scrollHeight);
+  _bus->write16(_gramHeight - _scrollTop - _scrollHeight);
+  endWrite();
+  return true;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Set the first shown row of the scroll area with VSCSAD, one
+    command instead of redrawing the area
+  @param  line  row of the scroll area shown first, wraps at the area height
+*/
+/**************************************************************************/
+void Arduino_TFT::scrollTo(uint16_t line)
+{
+  if (!_scrollHeight)
+  {
+    return;
+  }
+  _windowStreaming = false;
+  startWrite();
+  _bus->writeC8D16(TFT_VSCSAD, _scrollTop + (line % _scrollHeight));
+  endWrite();
+}
+
+/**************************************************************************/
+/*!
+  @brief  Enter partial display mode with PTLAR and PTLON
+  @param  y  first displayed row
+  @param  h  displayed row count
+  @return false if the controller is not supported or the rows are out of
+    the panel
+*/
+/**************************************************************************/
+bool Arduino_TFT::partialDisplay(uint16_t y, uint16_t h)
+{
+  if ((!_gramHeight) || (!h) || ((uint32_t)y + h > (uint32_t)HEIGHT))
+  {
+    return false;
+  }
+  y += ROW_OFFSET1;
+
+  _windowStreaming = false;
+  startWrite();
+  _bus->writeC8D16D16(TFT_PTLAR, y, y + h - 1);
+  _bus->writeCommand(TFT_PTLON);
+  endWrite();
+  return true;
+}
+
+void Arduino_TFT::normalDisplay()
+{
+  if (!_gramHeight)
+  {
+    return;
+  }
+  _windowStreaming = false;
+  startWrite();
+  _bus->writeCommand(TFT_NORON);
+  endWrite();
+}
+
+void Arduino_TFT::idleDisplay(bool i)
+{
+  if (!_gramHeight)
+  {
+    return;
+  }
+  _windowStreaming = false;
+  startWrite();
+  _bus->writeCommand(i ? TFT_IDMON : TFT_IDMOFF);
+  endWrite();
+}
+
+bool Arduino_TFT::tearingEffect(bool te)
+{
+  if (!_gramHeight)
+  {
+    return false;
+  }
+  _windowStreaming = false;
+  startWrite();
+  if (te)
+  {
+    _bus->writeC8D8(TFT_TEON, 0x00); // V-blanking only
+  }
+  else
+  {
+    _bus->writeCommand(TFT_TEOFF);
+  }
+  endWrite();
+  return true;
+}
+
 // TFT optimization code, too big for ATMEL family
 #if !defined(LITTLE_FOOT_PRINT)
 
@@ -196,6 +373,7 @@ void Arduino_TFT::writePixels(uint16_t *data, uint32_t len)
 
 void Arduino_TFT::pushColor(uint16_t color)
 {
+  _windowStreaming = false;
   _bus->beginWrite();
   writeColor(color);
   _bus->endWrite();
@@ -265,6 +443,46 @@ void Arduino_TFT::writeIndexedPixelsDouble(uint8_t *bitmap, uint16_t *color_inde
   _bus->writeIndexedPixelsDouble(bitmap, color_index, len);
 }
 
+/**************************************************************************/
+/*!
+  @brief  Send a bitmap in a GFX_CONVERT_* pixel format to the open address
+    window, converted to RGB565 in runs of up to GFX_CONVERT_BUF_PIXELS
+    pixels with one writePixels() call per run
+  @param  format       GFX_CONVERT_* pixel format of bitmap
+  @param  bitmap       source pixels
+  @param  color_index  palette for GFX_CONVERT_INDEXED, otherwise not used
+  @param  w            Width of bitmap in pixels
+  @param  h            Height of bitmap in pixels
+  @param  x_skip       number of pixels required to skip for every bitmap row
+*/
+/**************************************************************************/
+void Arduino_TFT::writeConvertedPixels(uint8_t format, const uint8_t *bitmap, const uint16_t *color_index, int16_t w, int16_t h, int16_t x_skip)
+{
+  uint16_t buf[GFX_CONVERT_BUF_PIXELS] __attribute__((aligned(4)));
+  uint8_t bpp = gfx_convert_bytes_per_pixel(format);
+  uint32_t row_len = w;
+  if (x_skip == 0)
+  {
+    // rows are contiguous, convert them as one run
+    row_len *= h;
+    h = 1;
+  }
+  uint32_t len, remain;
+  while (h--)
+  {
+    remain = row_len;
+    while (remain)
+    {
+      len = (remain > GFX_CONVERT_BUF_PIXELS) ? GFX_CONVERT_BUF_PIXELS : remain;
+      gfx_convert_row(format, buf, bitmap, color_index, len);
+      _bus->writePixels(buf, len);
+      bitmap += len * bpp;
+      remain -= len;
+    }
+    bitmap += x_skip * bpp;
+  }
+}
+
 void Arduino_TFT::drawYCbCrBitmap(int16_t x, int16_t y, uint8_t *yData, uint8_t *cbData, uint8_t *crData, int16_t w, int16_t h)
 {
   startWrite();
@@ -386,15 +604,19 @@ void Arduino_TFT::drawGrayscaleBitmap(
   }
   else
   {
-    uint32_t len = (uint32_t)w * h;
-    uint8_t v;
     startWrite();
     writeAddrWindow(x, y, w, h);
+#if defined(GFX_CONVERT_PROGMEM)
+    writeConvertedPixels(GFX_CONVERT_GRAY8, bitmap, NULL, w, h);
+#else
+    uint32_t len = (uint32_t)w * h;
+    uint8_t v;
     for (uint32_t i = 0; i < len; i++)
     {
       v = pgm_read_byte(&bitmap[i]);
       _bus->write16(color565(v, v, v));
     }
+#endif // defined(GFX_CONVERT_PROGMEM)
     endWrite();
   }
 }
@@ -423,15 +645,9 @@ void Arduino_TFT::drawGrayscaleBitmap(
   }
   else
   {
-    uint32_t len = (uint32_t)w * h;
-    uint8_t v;
     startWrite();
     writeAddrWindow(x, y, w, h);
-    while (len--)
-    {
-      v = *(bitmap++);
-      _bus->write16(color565(v, v, v));
-    }
+    writeConvertedPixels(GFX_CONVERT_GRAY8, bitmap, NULL, w, h);
     endWrite();
   }
 }
@@ -649,6 +865,37 @@ void Arduino_TFT::draw16bitRGBBitmap(
   }
 }
 
+void Arduino_TFT::draw16bitRGBBitmap(
+    int16_t x, int16_t y,
+    uint16_t *bitmap, int16_t w, int16_t h, int16_t x_skip)
+{
+  if (
+      _isRoundMode ||           // Round clip
+      (x < 0) ||                // Clip left
+      (y < 0) ||                // Clip top
+      ((x + w - 1) > _max_x) || // Clip right
+      ((y + h - 1) > _max_y)    // Clip bottom
+  )
+  {
+    Arduino_G::draw16bitRGBBitmap(x, y, bitmap, w, h, x_skip);
+  }
+  else if (x_skip == 0)
+  {
+    draw16bitRGBBitmap(x, y, bitmap, w, h);
+  }
+  else
+  {
+    startWrite();
+    writeAddrWindow(x, y, w, h);
+    while (h--)
+    {
+      _bus->writePixels(bitmap, w);
+      bitmap += w + x_skip;
+    }
+    endWrite();
+  }
+}
+
 void Arduino_TFT::draw16bitBeRGBBitmap(
     int16_t x, int16_t y,
     uint16_t *bitmap, int16_t w, int16_t h)
@@ -760,15 +1007,19 @@ void Arduino_TFT::draw24bitRGBBitmap(
   }
   else
   {
-    uint32_t len = (uint32_t)w * h;
-    uint32_t offset = 0;
     startWrite();
     writeAddrWindow(x, y, w, h);
+#if defined(GFX_CONVERT_PROGMEM)
+    writeConvertedPixels(GFX_CONVERT_RGB888, bitmap, NULL, w, h);
+#else
+    uint32_t len = (uint32_t)w * h;
+    uint32_t offset = 0;
     while (len--)
     {
       _bus->write16(color565(pgm_read_byte(&bitmap[offset]), pgm_read_byte(&bitmap[offset + 1]), pgm_read_byte(&bitmap[offset + 2])));
       offset += 3;
     }
+#endif // defined(GFX_CONVERT_PROGMEM)
     endWrite();
   }
 }
@@ -797,15 +1048,9 @@ void Arduino_TFT::draw24bitRGBBitmap(
   }
   else
   {
-    uint32_t len = (uint32_t)w * h;
-    uint32_t offset = 0;
     startWrite();
     writeAddrWindow(x, y, w, h);
-    while (len--)
-    {
-      _bus->write16(color565(bitmap[offset], bitmap[offset + 1], bitmap[offset + 2]));
-      offset += 3;
-    }
+    writeConvertedPixels(GFX_CONVERT_RGB888, bitmap, NULL, w, h);
     endWrite();
   }
 }
@@ -951,6 +1196,8 @@ void Arduino_TFT::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color
       {
         for (yy = 0; yy < h; yy++)
         {
+          // size 1 pixels are written as horizontal runs, one address window each
+          int16_t runW = 0;
           for (xx = 0; xx < w; xx++)
           {
             if (!(bit++ & 7))
@@ -961,7 +1208,7 @@ void Arduino_TFT::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color
             {
               if (textsize_x == 1 && textsize_y == 1)
               {
-                writePixelPreclipped(x + xo + xx, y + yo + yy, color);
+                ++runW;
               }
               else
               {
@@ -969,8 +1216,17 @@ void Arduino_TFT::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color
                                         textsize_x - text_pixel_margin, textsize_y - text_pixel_margin, color);
               }
             }
+            else if (runW)
+            {
+              writeFillRectPreclipped(x + xo + xx - runW, y + yo + yy, runW, 1, color);
+              runW = 0;
+            }
             bits <<= 1;
           }
+          if (runW)
+          {
+            writeFillRectPreclipped(x + xo + w - runW, y + yo + yy, runW, 1, color);
+          }
         }
       }
       endWrite();
@@ -8,6 +8,17 @@
 #include "Arduino_DataBus.h"
 #include "Arduino_GFX.h"
 
+// MIPI DCS commands shared by most TFT controllers
+#define TFT_PTLON 0x12
+#define TFT_NORON 0x13
+#define TFT_PTLAR 0x30
+#define TFT_VSCRDEF 0x33
+#define TFT_TEOFF 0x34
+#define TFT_TEON 0x35
+#define TFT_VSCSAD 0x37
+#define TFT_IDMOFF 0x38
+#define TFT_IDMON 0x39
+
 class Arduino_TFT : public Arduino_GFX
 {
 public:
@@ -33,6 +44,13 @@ public:
   void setAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t h);
   virtual void writeColor(uint16_t color);
 
+  bool setScrollArea(uint16_t top_fixed, uint16_t bottom_fixed) override;
+  void scrollTo(uint16_t line) override;
+  bool partialDisplay(uint16_t y, uint16_t h) override;
+  void normalDisplay() override;
+  void idleDisplay(bool i) override;
+  bool tearingEffect(bool te) override;
+
 // TFT optimization code, too big for ATMEL family
 #if !defined(LITTLE_FOOT_PRINT)
   virtual void writePixels(uint16_t *data, uint32_t size);
@@ -53,6 +71,7 @@ public:
   void draw16bitRGBBitmapWithMask(int16_t x, int16_t y, uint16_t *bitmap, uint8_t *mask, int16_t w, int16_t h) override;
   void draw16bitRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w, int16_t h) override;
   void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
+  void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h, int16_t x_skip) override;
   void draw16bitBeRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
   void draw16bitBeRGBBitmapR1(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
   void draw24bitRGBBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h) override;
@@ -62,6 +81,10 @@ public:
 
 protected:
   virtual void tftInit() = 0;
+  bool coalesceAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t *h);
+#if !defined(LITTLE_FOOT_PRINT)
+  void writeConvertedPixels(uint8_t format, const uint8_t *bitmap, const uint16_t *color_index, int16_t w, int16_t h, int16_t x_skip = 0);
+#endif // !defined(LITTLE_FOOT_PRINT)
 
   Arduino_DataBus *_bus;
   int8_t _rst;
@@ -71,7 +94,13 @@ protected:
   uint8_t _xStart, _yStart;
   int16_t _currentX, _currentY;
   uint16_t _currentW, _currentH;
+  uint8_t _writeDepth = 0;       // nested startWrite() count, the bus is released by the outermost endWrite()
+  bool _windowStreaming = false; // RAMWR still open, next write may continue it
+  int16_t _streamY;              // next row of the open window
   int8_t _override_datamode = GFX_NOT_DEFINED;
+  uint16_t _gramHeight = 0;      // frame memory rows, set by subclasses supporting the DCS scroll and partial commands
+  uint16_t _scrollTop = 0;       // first frame memory row of the scroll area
+  uint16_t _scrollHeight = 0;    // scroll area rows, 0 if not set
 
 private:
 };
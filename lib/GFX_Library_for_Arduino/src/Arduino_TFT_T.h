@@ -0,0 +1,222 @@
+// Compile-time specialized TFT front end. Arduino_TFT_T<Panel, Bus> is a
+// Panel::Display (e.g. Arduino_ST7789) whose drawing primitives call the
+// concrete Bus class directly instead of through the Arduino_DataBus
+// virtual functions, with the panel commands, size and offsets taken from
+// Panel as compile-time constants. The compiler can then inline the address
+// window, the bus writes and, for a bus class defined in a header, the pin
+// toggles.
+//
+// The object is still an Arduino_GFX: init, rotation and the control API
+// come from Panel::Display, and code holding an Arduino_GFX pointer reaches
+// the same specialized primitives through the usual virtual functions.
+// Declare the object with its own type to also skip the virtual calls of
+// drawPixel(), drawFastHLine(), drawFastVLine() and fillRect():
+//
+//   Arduino_ESP32SPI *bus = new Arduino_ESP32SPI(DC, CS, SCK, MOSI);
+//   Arduino_TFT_T<ST7789Traits, Arduino_ESP32SPI> *gfx =
+//       new Arduino_TFT_T<ST7789Traits, Arduino_ESP32SPI>(bus, RST, 0 /* rotation */);
+
+#ifndef _ARDUINO_TFT_T_H_
+#define _ARDUINO_TFT_T_H_
+
+#include "Arduino_DataBus.h"
+#include "Arduino_TFT.h"
+
+#if !defined(LITTLE_FOOT_PRINT)
+
+template <class Panel, class Bus>
+class Arduino_TFT_T final : public Panel::Display
+{
+public:
+  Arduino_TFT_T(Bus *bus, int8_t rst = GFX_NOT_DEFINED, uint8_t r = 0)
+      : Panel::Display(bus, rst, r, Panel::IPS, Panel::WIDTH, Panel::HEIGHT,
+                       Panel::COL_OFFSET1, Panel::ROW_OFFSET1, Panel::COL_OFFSET2, Panel::ROW_OFFSET2),
+        _tbus(bus)
+  {
+  }
+
+  void startWrite() override
+  {
+    if (this->_writeDepth++ == 0)
+    {
+      _tbus->Bus::beginWrite();
+    }
+  }
+
+  void endWrite() override
+  {
+    if (this->_writeDepth)
+    {
+      if (--this->_writeDepth == 0)
+      {
+        this->_windowStreaming = false;
+        _tbus->Bus::endWrite();
+      }
+    }
+  }
+
+  void writeAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t h) override
+  {
+    addrWindow(x, y, w, h);
+  }
+
+  void writePixelPreclipped(int16_t x, int16_t y, uint16_t color) override
+  {
+    addrWindow(x, y, 1, 1);
+    _tbus->Bus::write16(color);
+  }
+
+  void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override
+  {
+#ifdef ESP8266
+    yield();
+#endif
+    addrWindow(x, y, w, h);
+    _tbus->Bus::writeRepeat(color, (uint32_t)w * h);
+  }
+
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override
+  {
+    clipFillRect(x, y, w, 1, color);
+  }
+
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override
+  {
+    clipFillRect(x, y, 1, h, color);
+  }
+
+  void writeRepeat(uint16_t color, uint32_t len) override
+  {
+    _tbus->Bus::writeRepeat(color, len);
+  }
+
+  void writeColor(uint16_t color) override
+  {
+    _tbus->Bus::write16(color);
+  }
+
+  void writePixels(uint16_t *data, uint32_t len) override
+  {
+    _tbus->Bus::writePixels(data, len);
+  }
+
+  // same as the Arduino_GFX versions, without the virtual calls
+  void drawPixel(int16_t x, int16_t y, uint16_t color)
+  {
+    startWrite();
+    if (this->_isRoundMode)
+    {
+      this->writePixel(x, y, color);
+    }
+    else if (_ordered_in_range(x, 0, this->_max_x) && _ordered_in_range(y, 0, this->_max_y))
+    {
+      writePixelPreclipped(x, y, color);
+    }
+    endWrite();
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+  {
+    startWrite();
+    clipFillRect(x, y, w, 1, color);
+    endWrite();
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+  {
+    startWrite();
+    clipFillRect(x, y, 1, h, color);
+    endWrite();
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    startWrite();
+    clipFillRect(x, y, w, h, color);
+    endWrite();
+  }
+
+protected:
+  GFX_INLINE void addrWindow(int16_t x, int16_t y, uint16_t w, uint16_t h)
+  {
+    if (this->coalesceAddrWindow(x, y, w, &h))
+    {
+      return;
+    }
+
+    if ((x != this->_currentX) || (w != this->_currentW))
+    {
+      this->_currentX = x;
+      this->_currentW = w;
+      if (Panel::COL_OFFSET1 || Panel::ROW_OFFSET1 || Panel::COL_OFFSET2 || Panel::ROW_OFFSET2)
+      {
+        x += this->_xStart;
+      }
+      _tbus->Bus::writeC8D16D16(Panel::CASET, x, x + w - 1);
+    }
+
+    if ((y != this->_currentY) || (h != this->_currentH))
+    {
+      this->_currentY = y;
+      this->_currentH = h;
+      if (Panel::COL_OFFSET1 || Panel::ROW_OFFSET1 || Panel::COL_OFFSET2 || Panel::ROW_OFFSET2)
+      {
+        y += this->_yStart;
+      }
+      _tbus->Bus::writeC8D16D16(Panel::RASET, y, y + h - 1);
+    }
+
+    _tbus->Bus::writeCommand(Panel::RAMWR);
+  }
+
+  // clip like Arduino_GFX::writeFillRect(), negative w or h extend to the
+  // left or top
+  GFX_INLINE void clipFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+  {
+    if ((!w) || (!h))
+    {
+      return;
+    }
+    if (w < 0)
+    {
+      x += w + 1;
+      w = -w;
+    }
+    if (h < 0)
+    {
+      y += h + 1;
+      h = -h;
+    }
+    int16_t x2 = x + w - 1;
+    int16_t y2 = y + h - 1;
+    if ((x > this->_max_x) || (y > this->_max_y) || (x2 < 0) || (y2 < 0))
+    {
+      return;
+    }
+    if (x < 0)
+    {
+      x = 0;
+    }
+    if (y < 0)
+    {
+      y = 0;
+    }
+    if (x2 > this->_max_x)
+    {
+      x2 = this->_max_x;
+    }
+    if (y2 > this->_max_y)
+    {
+      y2 = this->_max_y;
+    }
+    writeFillRectPreclipped(x, y, x2 - x + 1, y2 - y + 1, color);
+  }
+
+  Bus *_tbus; // same object as _bus, typed for direct calls
+
+private:
+};
+
+#endif // !defined(LITTLE_FOOT_PRINT)
+
+#endif // _ARDUINO_TFT_T_H_
@@ -0,0 +1,278 @@
+#include "../Arduino_DataBus.h"
+#if !defined(LITTLE_FOOT_PRINT)
+
+#include "Arduino_BandQueue.h"
+
+// ring indexes are shared between the cores, the release store publishes
+// the slot written before it, the acquire load makes it visible
+GFX_INLINE static uint32_t bandqueue_load(const uint32_t *p)
+{
+  return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+GFX_INLINE static void bandqueue_store(uint32_t *p, uint32_t v)
+{
+  __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+Arduino_BandQueue::Arduino_BandQueue(Arduino_G *output, uint8_t buffers)
+    : _output(output)
+{
+  if (buffers < 1)
+  {
+    buffers = 1;
+  }
+  else if (buffers > BANDQUEUE_MAX_BUFFERS)
+  {
+    buffers = BANDQUEUE_MAX_BUFFERS;
+  }
+  _buffers = buffers;
+}
+
+Arduino_BandQueue::~Arduino_BandQueue()
+{
+  end();
+  for (uint8_t i = 0; i < BANDQUEUE_MAX_BUFFERS; ++i)
+  {
+    if (_buf[i])
+    {
+      free(_buf[i]);
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Allocate the band buffers and start the consumer
+  @param  buf_pixels  size of each band buffer in pixels
+  @param  mode        BANDQUEUE_AUTO, BANDQUEUE_COOPERATIVE or
+    BANDQUEUE_EXTERNAL
+  @param  core        core of the transfer task, should not be the drawing
+    core, e.g. 0 when drawing in the Arduino loop() on core 1
+  @return false if the buffers or the transfer task cannot be allocated
+*/
+/**************************************************************************/
+bool Arduino_BandQueue::begin(uint32_t buf_pixels, uint8_t mode, int8_t core)
+{
+  end();
+  if (buf_pixels > _buf_pixels)
+  {
+    for (uint8_t i = 0; i < BANDQUEUE_MAX_BUFFERS; ++i)
+    {
+      if (_buf[i])
+      {
+        free(_buf[i]);
+        _buf[i] = nullptr;
+      }
+    }
+  }
+  for (uint8_t i = 0; i < _buffers; ++i)
+  {
+    if (!_buf[i])
+    {
+#if defined(ESP32)
+      _buf[i] = (uint16_t *)aligned_alloc(16, buf_pixels * 2);
+#else
+      _buf[i] = (uint16_t *)malloc(buf_pixels * 2);
+#endif
+      if (!_buf[i])
+      {
+        return false;
+      }
+    }
+    _free[i] = _buf[i];
+  }
+  _buf_pixels = buf_pixels;
+  _ready_head = 0;
+  _ready_tail = 0;
+  _free_head = _buffers;
+  _free_tail = 0;
+  _submitted = 0;
+  _producer_waits = 0;
+  _sent = 0;
+
+  if (mode == BANDQUEUE_AUTO)
+  {
+#if defined(BANDQUEUE_TASK)
+    TaskHandle_t task;
+    _running = true;
+    if (xTaskCreatePinnedToCore(transferTask, "gfx_bandqueue", BANDQUEUE_TASK_STACK, this, BANDQUEUE_TASK_PRIORITY, &task, core) != pdPASS)
+    {
+      _running = false;
+      return false;
+    }
+    _task = task;
+    _mode = BANDQUEUE_AUTO;
+#else
+    UNUSED(core);
+    _mode = BANDQUEUE_COOPERATIVE;
+#endif
+  }
+  else
+  {
+    UNUSED(core);
+    _mode = mode;
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Send all queued bands and stop the transfer task
+*/
+/**************************************************************************/
+void Arduino_BandQueue::end()
+{
+  if (_buf_pixels)
+  {
+    flush();
+  }
+#if defined(BANDQUEUE_TASK)
+  if (_task)
+  {
+    _running = false;
+    xTaskNotifyGive(_task);
+    while (_task)
+    {
+      vTaskDelay(1);
+    }
+  }
+#endif
+}
+
+/**************************************************************************/
+/*!
+  @brief  Take a free band buffer, waits until the consumer returns one
+  @return buffer of getBufferPixels() pixels
+*/
+/**************************************************************************/
+uint16_t *Arduino_BandQueue::acquire()
+{
+  if (_free_tail == bandqueue_load(&_free_head))
+  {
+    ++_producer_waits;
+    while (_free_tail == bandqueue_load(&_free_head))
+    {
+      if (_mode == BANDQUEUE_COOPERATIVE)
+      {
+        pump();
+      }
+      else
+      {
+        yield();
+      }
+    }
+  }
+  uint16_t *buf = _free[_free_tail % _buffers];
+  ++_free_tail;
+  return buf;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Queue a rendered band, the buffer belongs to the queue until a
+    later acquire() returns it
+  @param  buf  buffer from acquire()
+  @param  x    output x position
+  @param  y    output y position
+  @param  w    band width, w * h must fit in the buffer
+  @param  h    band height
+*/
+/**************************************************************************/
+void Arduino_BandQueue::submit(uint16_t *buf, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  // never overflows, there are only _buffers buffers to queue
+  band_t *band = &_ready[_ready_head % _buffers];
+  band->buf = buf;
+  band->x = x;
+  band->y = y;
+  band->w = w;
+  band->h = h;
+  bandqueue_store(&_ready_head, _ready_head + 1);
+  ++_submitted;
+#if defined(BANDQUEUE_TASK)
+  if (_task)
+  {
+    xTaskNotifyGive(_task);
+  }
+#endif
+}
+
+/**************************************************************************/
+/*!
+  @brief  Wait until every submitted band is sent
+*/
+/**************************************************************************/
+void Arduino_BandQueue::flush()
+{
+  while (bandqueue_load(&_sent) != _submitted)
+  {
+    if (_mode == BANDQUEUE_COOPERATIVE)
+    {
+      pump();
+    }
+    else
+    {
+      yield();
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Consumer step, send the oldest queued band and return its buffer
+  @return false if no band was queued
+*/
+/**************************************************************************/
+bool Arduino_BandQueue::pump()
+{
+  if (_ready_tail == bandqueue_load(&_ready_head))
+  {
+    return false;
+  }
+  band_t band = _ready[_ready_tail % _buffers];
+  ++_ready_tail;
+  _output->draw16bitRGBBitmap(band.x, band.y, band.buf, band.w, band.h);
+
+  _free[_free_head % _buffers] = band.buf;
+  bandqueue_store(&_free_head, _free_head + 1);
+  bandqueue_store(&_sent, _sent + 1);
+  return true;
+}
+
+uint32_t Arduino_BandQueue::getBufferPixels()
+{
+  return _buf_pixels;
+}
+
+uint8_t Arduino_BandQueue::getMode()
+{
+  return _mode;
+}
+
+bandqueue_stats_t Arduino_BandQueue::getStats()
+{
+  bandqueue_stats_t stats;
+  stats.submitted = _submitted;
+  stats.sent = bandqueue_load(&_sent);
+  stats.producer_waits = _producer_waits;
+  return stats;
+}
+
+#if defined(BANDQUEUE_TASK)
+void Arduino_BandQueue::transferTask(void *param)
+{
+  Arduino_BandQueue *queue = (Arduino_BandQueue *)param;
+  while (queue->_running)
+  {
+    if (!queue->pump())
+    {
+      ulTaskNotifyTake(pdTRUE, 1);
+    }
+  }
+  queue->_task = nullptr;
+  vTaskDelete(nullptr);
+}
+#endif
+
+#endif // !defined(LITTLE_FOOT_PRINT)
@@ -0,0 +1,100 @@
+#include "../Arduino_DataBus.h"
+#if !defined(LITTLE_FOOT_PRINT)
+
+#ifndef _ARDUINO_BANDQUEUE_H_
+#define _ARDUINO_BANDQUEUE_H_
+
+#include "../Arduino_G.h"
+
+#define BANDQUEUE_MAX_BUFFERS 4
+
+// who sends the queued bands to the output, see begin()
+#define BANDQUEUE_AUTO 0        // transfer task on the other core if there is one, otherwise cooperative
+#define BANDQUEUE_COOPERATIVE 1 // acquire() and flush() send queued bands on the caller's core
+#define BANDQUEUE_EXTERNAL 2    // the sketch calls pump() from its own task or thread
+
+#if defined(ESP32) && (portNUM_PROCESSORS > 1)
+#define BANDQUEUE_TASK
+#ifndef BANDQUEUE_TASK_STACK
+#define BANDQUEUE_TASK_STACK 4096
+#endif
+#ifndef BANDQUEUE_TASK_PRIORITY
+#define BANDQUEUE_TASK_PRIORITY 2
+#endif
+#endif
+
+/// Band traffic since begin()
+typedef struct
+{
+  uint32_t submitted;      ///< bands queued by submit()
+  uint32_t sent;           ///< bands sent to the output
+  uint32_t producer_waits; ///< acquire() calls that found no free buffer
+} bandqueue_stats_t;
+
+// Render / transfer split for band rendering. The producer (the drawing
+// code) takes a free buffer with acquire(), renders a band into it and
+// queues it with submit(). The consumer sends queued bands to the output in
+// order with pump() and returns their buffers. Buffers pass between both
+// sides through 2 single producer / single consumer rings, so neither side
+// takes a lock.
+//
+// On a dual core ESP32 a transfer task pinned to the other core is the
+// consumer, rendering of the next band runs while the last one is sent.
+// On a single core target the producer sends queued bands itself whenever
+// it needs a free buffer. Only the consumer may use the output.
+class Arduino_BandQueue
+{
+public:
+  Arduino_BandQueue(Arduino_G *output, uint8_t buffers = 2);
+  ~Arduino_BandQueue();
+
+  bool begin(uint32_t buf_pixels, uint8_t mode = BANDQUEUE_AUTO, int8_t core = 0);
+  void end();
+
+  uint16_t *acquire();
+  void submit(uint16_t *buf, int16_t x, int16_t y, int16_t w, int16_t h);
+  void flush();
+  bool pump();
+
+  uint32_t getBufferPixels();
+  uint8_t getMode();
+  bandqueue_stats_t getStats();
+
+protected:
+  typedef struct
+  {
+    uint16_t *buf;
+    int16_t x, y, w, h;
+  } band_t;
+
+  Arduino_G *_output;
+  uint8_t _buffers;
+  uint8_t _mode = BANDQUEUE_COOPERATIVE;
+  uint32_t _buf_pixels = 0;
+  uint16_t *_buf[BANDQUEUE_MAX_BUFFERS] = {};
+
+  // ready ring, written by the producer, read by the consumer
+  band_t _ready[BANDQUEUE_MAX_BUFFERS];
+  uint32_t _ready_head = 0; // released by the producer
+  uint32_t _ready_tail = 0; // consumer only
+  // free ring, written by the consumer, read by the producer
+  uint16_t *_free[BANDQUEUE_MAX_BUFFERS];
+  uint32_t _free_head = 0; // released by the consumer
+  uint32_t _free_tail = 0; // producer only
+
+  uint32_t _submitted = 0;      // producer only
+  uint32_t _producer_waits = 0; // producer only
+  uint32_t _sent = 0;           // released by the consumer
+
+#if defined(BANDQUEUE_TASK)
+  static void transferTask(void *param);
+  TaskHandle_t volatile _task = nullptr; // cleared by the task when it stops
+  volatile bool _running = false;
+#endif
+
+private:
+};
+
+#endif // _ARDUINO_BANDQUEUE_H_
+
+#endif // !defined(LITTLE_FOOT_PRINT)
@@ -8,8 +8,6 @@ Arduino_Canvas::Arduino_Canvas(
     int16_t w, int16_t h, Arduino_G *output, int16_t output_x, int16_t output_y, uint8_t r)
     : Arduino_GFX(w, h), _output(output), _output_x(output_x), _output_y(output_y)
 {
-  MAX_X = WIDTH - 1;
-  MAX_Y = HEIGHT - 1;
   setRotation(r);
 }
 
@@ -19,6 +17,26 @@ Arduino_Canvas::~Arduino_Canvas()
   {
     free(_framebuffer);
   }
+  if (_transposeBuf)
+  {
+    free(_transposeBuf);
+  }
+}
+
+GFX_INLINE void Arduino_Canvas::addDirty(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+  if (_dirtyTracking)
+  {
+    if (_dirty.count)
+    {
+      gfx_rect_t *r = &_dirty.rect[_dirty.count - 1];
+      if ((x1 >= r->x1) && (y1 >= r->y1) && (x2 <= r->x2) && (y2 <= r->y2))
+      {
+        return;
+      }
+    }
+    gfx_dirty_rects_add(&_dirty, x1, y1, x2, y2);
+  }
 }
 
 bool Arduino_Canvas::begin(int32_t speed)
@@ -45,42 +63,40 @@ bool Arduino_Canvas::begin(int32_t speed)
       return false;
     }
   }
+  addDirty(0, 0, MAX_X, MAX_Y);
 
   return true;
 }
 
 void Arduino_Canvas::writePixelPreclipped(int16_t x, int16_t y, uint16_t color)
 {
-
-  uint16_t *fb = _framebuffer;
-  switch (_rotation)
+  int16_t rx, ry;
+  switch (_fb_rotation)
   {
   case 1:
-    fb += (int32_t)x * _height;
-    fb += _max_y - y;
-    *fb = color;
+    rx = _max_y - y;
+    ry = x;
     break;
   case 2:
-    fb += (int32_t)(_max_y - y) * _width;
-    fb += _max_x - x;
-    *fb = color;
+    rx = _max_x - x;
+    ry = _max_y - y;
     break;
   case 3:
-    fb += (int32_t)(_max_x - x) * _height;
-    fb += y;
-    *fb = color;
+    rx = y;
+    ry = _max_x - x;
     break;
   default: // case 0:
-    fb += (int32_t)y * _width;
-    fb += x;
-    *fb = color;
+    rx = x;
+    ry = y;
   }
+  addDirty(rx, ry, rx, ry);
+  _framebuffer[((int32_t)ry * _fb_width) + rx] = color;
 }
 
 void Arduino_Canvas::writeFastVLine(int16_t x, int16_t y,
                                     int16_t h, uint16_t color)
 {
-  switch (_rotation)
+  switch (_fb_rotation)
   {
   case 1:
     writeFastHLineCore(_height - y - h, x, h, color);
@@ -123,11 +139,12 @@ void Arduino_Canvas::writeFastVLineCore(int16_t x, int16_t y,
           h = MAX_Y - y + 1;
         } // Clip bottom
 
-        uint16_t *fb = _framebuffer + ((int32_t)y * WIDTH) + x;
+        addDirty(x, y, x, y + h - 1);
+        uint16_t *fb = _framebuffer + ((int32_t)y * _fb_width) + x;
         while (h--)
         {
           *fb = color;
-          fb += WIDTH;
+          fb += _fb_width;
         }
       }
     }
@@ -138,7 +155,7 @@ void Arduino_Canvas::writeFastHLine(int16_t x, int16_t y,
                                     int16_t w, uint16_t color)
 {
   // log_i("writeFastHLine(x: %d, y: %d, w: %d)", x, y, w);
-  switch (_rotation)
+  switch (_fb_rotation)
   {
   case 1:
     writeFastVLineCore(_max_y - y, x, w, color);
@@ -181,7 +198,8 @@ void Arduino_Canvas::writeFastHLineCore(int16_t x, int16_t y,
           w = MAX_X - x + 1;
         } // Clip right
 
-        uint16_t *fb = _framebuffer + ((int32_t)y * WIDTH) + x;
+        addDirty(x, y, x + w - 1, y);
+        uint16_t *fb = _framebuffer + ((int32_t)y * _fb_width) + x;
         while (w--)
         {
           *(fb++) = color;
@@ -195,25 +213,25 @@ void Arduino_Canvas::writeFillRectPreclipped(int16_t x, int16_t y,
                                              int16_t w, int16_t h, uint16_t color)
 {
   // log_i("writeFillRectPreclipped(x: %d, y: %d, w: %d, h: %d)", x, y, w, h);
-  if (_rotation > 0)
+  if (_fb_rotation > 0)
   {
     int16_t t = x;
-    switch (_rotation)
+    switch (_fb_rotation)
     {
     case 1:
-      x = WIDTH - y - h;
+      x = _fb_width - y - h;
       y = t;
       t = w;
       w = h;
       h = t;
       break;
     case 2:
-      x = WIDTH - x - w;
-      y = HEIGHT - y - h;
+      x = _fb_width - x - w;
+      y = _fb_height - y - h;
       break;
     case 3:
       x = y;
-      y = HEIGHT - t - w;
+      y = _fb_height - t - w;
       t = w;
       w = h;
       h = t;
@@ -221,8 +239,9 @@ void Arduino_Canvas::writeFillRectPreclipped(int16_t x, int16_t y,
     }
   }
   // log_i("adjusted writeFillRectPreclipped(x: %d, y: %d, w: %d, h: %d)", x, y, w, h);
+  addDirty(x, y, x + w - 1, y + h - 1);
   uint16_t *row = _framebuffer;
-  row += y * WIDTH;
+  row += y * _fb_width;
   row += x;
   for (int j = 0; j < h; j++)
   {
@@ -230,7 +249,7 @@ void Arduino_Canvas::writeFillRectPreclipped(int16_t x, int16_t y,
     {
       row[i] = color;
     }
-    row += WIDTH;
+    row += _fb_width;
   }
 }
 
@@ -238,7 +257,7 @@ void Arduino_Canvas::drawIndexedBitmap(
     int16_t x, int16_t y,
     uint8_t *bitmap, uint16_t *color_index, int16_t w, int16_t h, int16_t x_skip)
 {
-  if (_rotation > 0)
+  if (_fb_rotation > 0)
   {
     Arduino_GFX::drawIndexedBitmap(x, y, bitmap, color_index, w, h, x_skip);
   }
@@ -277,6 +296,7 @@ void Arduino_Canvas::drawIndexedBitmap(
         w += x;
         x = 0;
       }
+      addDirty(x, y, x + w - 1, y + h - 1);
       uint16_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -311,7 +331,7 @@ void Arduino_Canvas::drawIndexedBitmap(
     int16_t x, int16_t y,
     uint8_t *bitmap, uint16_t *color_index, uint8_t chroma_key, int16_t w, int16_t h, int16_t x_skip)
 {
-  if (_rotation > 0)
+  if (_fb_rotation > 0)
   {
     Arduino_GFX::drawIndexedBitmap(x, y, bitmap, color_index, chroma_key, w, h, x_skip);
   }
@@ -350,6 +370,7 @@ void Arduino_Canvas::drawIndexedBitmap(
         w += x;
         x = 0;
       }
+      addDirty(x, y, x + w - 1, y + h - 1);
       uint16_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -409,7 +430,8 @@ void Arduino_Canvas::drawIndexedBitmap(
 void Arduino_Canvas::draw16bitRGBBitmap(int16_t x, int16_t y,
                                         uint16_t *bitmap, int16_t w, int16_t h)
 {
-  switch (_rotation)
+  markDirty(x, y, w, h);
+  switch (_fb_rotation)
   {
   case 1:
     gfx_draw_bitmap_to_framebuffer_rotate_1(bitmap, w, h, _framebuffer, x, y, _width, _height);
@@ -429,7 +451,7 @@ void Arduino_Canvas::draw16bitRGBBitmapWithTranColor(
     int16_t x, int16_t y,
     uint16_t *bitmap, uint16_t transparent_color, int16_t w, int16_t h)
 {
-  if (_rotation > 0)
+  if (_fb_rotation > 0)
   {
     Arduino_GFX::draw16bitRGBBitmapWithTranColor(x, y, bitmap, transparent_color, w, h);
   }
@@ -469,6 +491,7 @@ void Arduino_Canvas::draw16bitRGBBitmapWithTranColor(
         w += x;
         x = 0;
       }
+      addDirty(x, y, x + w - 1, y + h - 1);
       uint16_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -516,7 +539,7 @@ void Arduino_Canvas::draw16bitRGBBitmapWithTranColor(
 void Arduino_Canvas::draw16bitBeRGBBitmap(int16_t x, int16_t y,
                                           uint16_t *bitmap, int16_t w, int16_t h)
 {
-  if (_rotation > 0)
+  if (_fb_rotation > 0)
   {
     Arduino_GFX::draw16bitBeRGBBitmap(x, y, bitmap, w, h);
   }
@@ -556,6 +579,7 @@ void Arduino_Canvas::draw16bitBeRGBBitmap(int16_t x, int16_t y,
         w += x;
         x = 0;
       }
+      addDirty(x, y, x + w - 1, y + h - 1);
       uint16_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -574,11 +598,152 @@ void Arduino_Canvas::draw16bitBeRGBBitmap(int16_t x, int16_t y,
   }
 }
 
+/**************************************************************************/
+/*!
+  @brief  Send changed regions to the output, or the whole framebuffer if
+    dirty tracking is disabled
+  @param  force_flush  send the whole framebuffer
+*/
+/**************************************************************************/
 void Arduino_Canvas::flush(bool force_flush)
 {
   if (_output)
   {
-    _output->draw16bitRGBBitmap(_output_x, _output_y, _framebuffer, WIDTH, HEIGHT);
+    bool transpose = (_rotation_mode == CANVAS_ROTATE_ON_FLUSH) && (_rotation > 0);
+    if (force_flush || (!_dirtyTracking))
+    {
+      if (transpose)
+      {
+        flushTransposed(0, 0, MAX_X, MAX_Y);
+      }
+      else
+      {
+        _output->draw16bitRGBBitmap(_output_x, _output_y, _framebuffer, _fb_width, _fb_height);
+      }
+    }
+    else
+    {
+      gfx_rect_t *r = _dirty.rect;
+      for (uint8_t i = 0; i < _dirty.count; ++i, ++r)
+      {
+        if (transpose)
+        {
+          flushTransposed(r->x1, r->y1, r->x2, r->y2);
+        }
+        else
+        {
+          int16_t w = r->x2 - r->x1 + 1;
+          _output->draw16bitRGBBitmap(
+              _output_x + r->x1, _output_y + r->y1,
+              _framebuffer + ((int32_t)r->y1 * _fb_width) + r->x1,
+              w, r->y2 - r->y1 + 1, _fb_width - w);
+        }
+      }
+    }
+  }
+  _dirty.count = 0;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Rotate a region of the logical framebuffer to panel orientation
+    and send it, CANVAS_TRANSPOSE_ROWS panel rows per output write. Each
+    block reads short contiguous runs of framebuffer rows so both sides stay
+    in cache.
+  @param  x1  Left edge, logical coordinates
+  @param  y1  Top edge, logical coordinates
+  @param  x2  Right edge, logical coordinates
+  @param  y2  Bottom edge, logical coordinates
+*/
+/**************************************************************************/
+void Arduino_Canvas::flushTransposed(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+  if (!_transposeBuf)
+  {
+    // a panel row is never wider than WIDTH
+    _transposeBuf = (uint16_t *)malloc(WIDTH * CANVAS_TRANSPOSE_ROWS * 2);
+    if (!_transposeBuf)
+    {
+      return;
+    }
+  }
+
+  // region in panel coordinates
+  int16_t rx1, ry1, rx2, ry2;
+  switch (_rotation)
+  {
+  case 1:
+    rx1 = _max_y - y2;
+    rx2 = _max_y - y1;
+    ry1 = x1;
+    ry2 = x2;
+    break;
+  case 2:
+    rx1 = _max_x - x2;
+    rx2 = _max_x - x1;
+    ry1 = _max_y - y2;
+    ry2 = _max_y - y1;
+    break;
+  default: // case 3:
+    rx1 = y1;
+    rx2 = y2;
+    ry1 = _max_x - x2;
+    ry2 = _max_x - x1;
+  }
+  int16_t rw = rx2 - rx1 + 1;
+
+  for (int16_t ry = ry1; ry <= ry2; ry += CANVAS_TRANSPOSE_ROWS)
+  {
+    int16_t rows = ry2 - ry + 1;
+    if (rows > CANVAS_TRANSPOSE_ROWS)
+    {
+      rows = CANVAS_TRANSPOSE_ROWS;
+    }
+    uint16_t *d;
+    uint16_t *s;
+    switch (_rotation)
+    {
+    case 1:
+      // panel (rx, ry) = logical (ry, _max_y - rx), panel rows are logical columns
+      d = _transposeBuf;
+      for (int16_t rx = rx1; rx <= rx2; ++rx)
+      {
+        s = _framebuffer + ((int32_t)(_max_y - rx) * _fb_width) + ry;
+        uint16_t *dd = d++;
+        for (int16_t j = 0; j < rows; ++j)
+        {
+          *dd = *s++;
+          dd += rw;
+        }
+      }
+      break;
+    case 2:
+      // panel (rx, ry) = logical (_max_x - rx, _max_y - ry), rows reversed
+      d = _transposeBuf;
+      for (int16_t j = 0; j < rows; ++j)
+      {
+        s = _framebuffer + ((int32_t)(_max_y - ry - j) * _fb_width) + (_max_x - rx1);
+        for (int16_t i = 0; i < rw; ++i)
+        {
+          *d++ = *s--;
+        }
+      }
+      break;
+    default: // case 3:
+      // panel (rx, ry) = logical (_max_x - ry, rx), panel rows are logical columns
+      d = _transposeBuf;
+      for (int16_t rx = rx1; rx <= rx2; ++rx)
+      {
+        s = _framebuffer + ((int32_t)rx * _fb_width) + (_max_x - ry);
+        uint16_t *dd = d++;
+        for (int16_t j = 0; j < rows; ++j)
+        {
+          *dd = *s--;
+          dd += rw;
+        }
+      }
+    }
+    _output->draw16bitRGBBitmap(_output_x + rx1, _output_y + ry, _transposeBuf, rw, rows);
   }
 }
 
@@ -586,11 +751,11 @@ void Arduino_Canvas::flushQuad(bool force_flush)
 {
   int16_t y = _output_y;
   uint16_t *row1 = _framebuffer;
-  uint16_t *row2 = _framebuffer + WIDTH;
+  uint16_t *row2 = _framebuffer + _fb_width;
   if (_output)
   {
-    int16_t hQuad = HEIGHT / 2;
-    int16_t wQuad = WIDTH / 2;
+    int16_t hQuad = _fb_height / 2;
+    int16_t wQuad = _fb_width / 2;
     if (!_rowBuf)
     {
       _rowBuf = (uint16_t *)malloc(wQuad * 2);
@@ -607,15 +772,144 @@ void Arduino_Canvas::flushQuad(bool force_flush)
         _rowBuf[i] = p;
       }
       _output->draw16bitRGBBitmap(_output_x, _output_y + y++, _rowBuf, wQuad, 1);
-      row1 += WIDTH;
-      row2 += WIDTH;
+      row1 += _fb_width;
+      row2 += _fb_width;
     }
   }
 }
 
+/**************************************************************************/
+/*!
+  @brief  Set rotation of the canvas. With CANVAS_ROTATE_ON_DRAW the
+    framebuffer content keeps its panel orientation, with the other modes the
+    framebuffer is reinterpreted in the new orientation, so redraw the whole
+    canvas after changing rotation.
+  @param  r  rotation, 0 to 3
+*/
+/**************************************************************************/
+void Arduino_Canvas::setRotation(uint8_t r)
+{
+  Arduino_GFX::setRotation(r);
+  if ((_rotation_mode == CANVAS_ROTATE_ON_DRAW) || (_rotation > 3))
+  {
+    _fb_rotation = _rotation;
+    _fb_width = WIDTH;
+    _fb_height = HEIGHT;
+  }
+  else
+  {
+    // framebuffer in logical orientation, write functions run the rotation 0 path
+    _fb_rotation = 0;
+    _fb_width = _width;
+    _fb_height = _height;
+  }
+  MAX_X = _fb_width - 1;
+  MAX_Y = _fb_height - 1;
+  _dirty.count = 0;
+  addDirty(0, 0, MAX_X, MAX_Y);
+}
+
+/**************************************************************************/
+/*!
+  @brief  Choose where rotation is applied. CANVAS_ROTATE_ON_DRAW (default)
+    rotates every pixel written. CANVAS_ROTATE_ON_FLUSH keeps the framebuffer
+    in logical orientation so drawing always runs the fast row-major path,
+    and flush() transposes the changed regions once. CANVAS_ROTATE_BY_OUTPUT
+    also keeps the logical orientation but flush() sends it as is, the sketch
+    rotates the output instead, e.g. output->setRotation() so the panel
+    MADCTL does the work. Call before drawing, the framebuffer content is not
+    converted.
+  @param  mode  CANVAS_ROTATE_ON_DRAW, CANVAS_ROTATE_ON_FLUSH or CANVAS_ROTATE_BY_OUTPUT
+*/
+/**************************************************************************/
+void Arduino_Canvas::setRotationMode(uint8_t mode)
+{
+  _rotation_mode = mode;
+  setRotation(_rotation);
+}
+
+/**************************************************************************/
+/*!
+  @brief  Get the framebuffer. Writes through this pointer are not tracked,
+    so dirty tracking is disabled and flush() sends the whole framebuffer
+    again, until setDirtyTracking(true) is called.
+  @return framebuffer
+*/
+/**************************************************************************/
 uint16_t *Arduino_Canvas::getFramebuffer()
 {
+  _dirtyTracking = false;
   return _framebuffer;
 }
 
+/**************************************************************************/
+/*!
+  @brief  Enable or disable dirty region tracking. When enabled, flush() only
+    sends the regions changed by drawing functions and markDirty().
+  @param  enable  true to track changed regions
+*/
+/**************************************************************************/
+void Arduino_Canvas::setDirtyTracking(bool enable)
+{
+  if (enable && (!_dirtyTracking))
+  {
+    // unknown changes while disabled
+    _dirtyTracking = true;
+    addDirty(0, 0, MAX_X, MAX_Y);
+  }
+  else
+  {
+    _dirtyTracking = enable;
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Mark a region as changed, e.g. after writing to the framebuffer directly
+  @param  x  Top left corner x coordinate
+  @param  y  Top left corner y coordinate
+  @param  w  Width in pixels
+  @param  h  Height in pixels
+*/
+/**************************************************************************/
+void Arduino_Canvas::markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int16_t x2 = x + w - 1;
+  int16_t y2 = y + h - 1;
+  if ((w <= 0) || (h <= 0) || (x > _max_x) || (y > _max_y) || (x2 < 0) || (y2 < 0))
+  {
+    return;
+  }
+  if (x < 0)
+  {
+    x = 0;
+  }
+  if (y < 0)
+  {
+    y = 0;
+  }
+  if (x2 > _max_x)
+  {
+    x2 = _max_x;
+  }
+  if (y2 > _max_y)
+  {
+    y2 = _max_y;
+  }
+  switch (_fb_rotation)
+  {
+  case 1:
+    addDirty(_max_y - y2, x, _max_y - y, x2);
+    break;
+  case 2:
+    addDirty(_max_x - x2, _max_y - y2, _max_x - x, _max_y - y);
+    break;
+  case 3:
+    addDirty(y, _max_x - x2, y2, _max_x - x);
+    break;
+  default: // case 0:
+    addDirty(x, y, x2, y2);
+  }
+}
+
 #endif // !defined(LITTLE_FOOT_PRINT)
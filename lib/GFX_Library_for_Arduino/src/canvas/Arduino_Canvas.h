@@ -26,17 +26,33 @@ public:
   void draw16bitBeRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
   void flush(bool force_flush = false) override;
   void flushQuad(bool force_flush = false);
+  void setRotation(uint8_t r) override;
+  void setRotationMode(uint8_t mode);
 
   uint16_t *getFramebuffer();
+  void setDirtyTracking(bool enable);
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
 
 protected:
+  void addDirty(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+  void flushTransposed(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+
   uint16_t *_framebuffer = nullptr;
   Arduino_G *_output = nullptr;
   int16_t _output_x, _output_y;
   int16_t MAX_X, MAX_Y;
 
+  uint8_t _rotation_mode = CANVAS_ROTATE_ON_DRAW;
+  uint8_t _fb_rotation = 0;      // rotation applied by write functions
+  int16_t _fb_width, _fb_height; // framebuffer layout, raw or logical size
+
+  gfx_dirty_rects_t _dirty = {};
+  bool _dirtyTracking = true;
+
   // for flushQuad() only
   uint16_t *_rowBuf = nullptr;
+  // for CANVAS_ROTATE_ON_FLUSH only
+  uint16_t *_transposeBuf = nullptr;
 
 private:
 };
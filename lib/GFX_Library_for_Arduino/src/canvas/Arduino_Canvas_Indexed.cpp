@@ -7,8 +7,6 @@
 Arduino_Canvas_Indexed::Arduino_Canvas_Indexed(int16_t w, int16_t h, Arduino_G *output, int16_t output_x, int16_t output_y, uint8_t r, uint8_t mask_level)
     : Arduino_GFX(w, h), _output(output), _output_x(output_x), _output_y(output_y)
 {
-  MAX_X = WIDTH - 1;
-  MAX_Y = HEIGHT - 1;
   setRotation(r);
 
   if (mask_level >= MAXMASKLEVEL)
@@ -17,6 +15,7 @@ Arduino_Canvas_Indexed::Arduino_Canvas_Indexed(int16_t w, int16_t h, Arduino_G *
   }
   _current_mask_level = mask_level;
   _color_mask = mask_level_list[_current_mask_level];
+  memset(_color_hash, COLOR_HASH_EMPTY, sizeof(_color_hash));
 }
 
 Arduino_Canvas_Indexed::~Arduino_Canvas_Indexed()
@@ -25,6 +24,30 @@ Arduino_Canvas_Indexed::~Arduino_Canvas_Indexed()
   {
     free(_framebuffer);
   }
+  if (_transposeBuf)
+  {
+    free(_transposeBuf);
+  }
+  if (_nearest_cube)
+  {
+    free(_nearest_cube);
+  }
+}
+
+GFX_INLINE void Arduino_Canvas_Indexed::addDirty(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+  if (_dirtyTracking)
+  {
+    if (_dirty.count)
+    {
+      gfx_rect_t *r = &_dirty.rect[_dirty.count - 1];
+      if ((x1 >= r->x1) && (y1 >= r->y1) && (x2 <= r->x2) && (y2 <= r->y2))
+      {
+        return;
+      }
+    }
+    gfx_dirty_rects_add(&_dirty, x1, y1, x2, y2);
+  }
 }
 
 bool Arduino_Canvas_Indexed::begin(int32_t speed)
@@ -57,6 +80,7 @@ bool Arduino_Canvas_Indexed::begin(int32_t speed)
       return false;
     }
   }
+  addDirty(0, 0, MAX_X, MAX_Y);
 
   return true;
 }
@@ -73,29 +97,27 @@ void Arduino_Canvas_Indexed::writePixelPreclipped(int16_t x, int16_t y, uint16_t
     idx = get_color_index(color);
   }
 
-  uint8_t *fb = _framebuffer;
-  switch (_rotation)
+  int16_t rx, ry;
+  switch (_fb_rotation)
   {
   case 1:
-    fb += (int32_t)x * _height;
-    fb += _max_y - y;
-    *fb = idx;
+    rx = _max_y - y;
+    ry = x;
     break;
   case 2:
-    fb += (int32_t)(_max_y - y) * _width;
-    fb += _max_x - x;
-    *fb = idx;
+    rx = _max_x - x;
+    ry = _max_y - y;
     break;
   case 3:
-    fb += (int32_t)(_max_x - x) * _height;
-    fb += y;
-    *fb = idx;
+    rx = y;
+    ry = _max_x - x;
     break;
   default: // case 0:
-    fb += (int32_t)y * _width;
-    fb += x;
-    *fb = idx;
+    rx = x;
+    ry = y;
   }
+  addDirty(rx, ry, rx, ry);
+  _framebuffer[((int32_t)ry * _fb_width) + rx] = idx;
 }
 
 void Arduino_Canvas_Indexed::writeFastVLine(int16_t x, int16_t y,
@@ -111,7 +133,7 @@ void Arduino_Canvas_Indexed::writeFastVLine(int16_t x, int16_t y,
     idx = get_color_index(color);
   }
 
-  switch (_rotation)
+  switch (_fb_rotation)
   {
   case 1:
     writeFastHLineCore(_height - y - h, x, h, idx);
@@ -153,11 +175,12 @@ void Arduino_Canvas_Indexed::writeFastVLineCore(int16_t x, int16_t y,
           h = MAX_Y - y + 1;
         } // Clip bottom
 
-        uint8_t *fb = _framebuffer + ((int32_t)y * WIDTH) + x;
+        addDirty(x, y, x, y + h - 1);
+        uint8_t *fb = _framebuffer + ((int32_t)y * _fb_width) + x;
         while (h--)
         {
           *fb = idx;
-          fb += WIDTH;
+          fb += _fb_width;
         }
       }
     }
@@ -177,7 +200,7 @@ void Arduino_Canvas_Indexed::writeFastHLine(int16_t x, int16_t y,
     idx = get_color_index(color);
   }
 
-  switch (_rotation)
+  switch (_fb_rotation)
   {
   case 1:
     writeFastVLineCore(_max_y - y, x, w, idx);
@@ -219,7 +242,8 @@ void Arduino_Canvas_Indexed::writeFastHLineCore(int16_t x, int16_t y,
           w = MAX_X - x + 1;
         } // Clip right
 
-        uint8_t *fb = _framebuffer + ((int32_t)y * WIDTH) + x;
+        addDirty(x, y, x + w - 1, y);
+        uint8_t *fb = _framebuffer + ((int32_t)y * _fb_width) + x;
         while (w--)
         {
           *(fb++) = idx;
@@ -242,25 +266,25 @@ void Arduino_Canvas_Indexed::writeFillRectPreclipped(int16_t x, int16_t y,
     idx = get_color_index(color);
   }
 
-  if (_rotation > 0)
+  if (_fb_rotation > 0)
   {
     int16_t t = x;
-    switch (_rotation)
+    switch (_fb_rotation)
     {
     case 1:
-      x = WIDTH - y - h;
+      x = _fb_width - y - h;
       y = t;
       t = w;
       w = h;
       h = t;
       break;
     case 2:
-      x = WIDTH - x - w;
-      y = HEIGHT - y - h;
+      x = _fb_width - x - w;
+      y = _fb_height - y - h;
       break;
     case 3:
       x = y;
-      y = HEIGHT - t - w;
+      y = _fb_height - t - w;
       t = w;
       w = h;
       h = t;
@@ -268,8 +292,9 @@ void Arduino_Canvas_Indexed::writeFillRectPreclipped(int16_t x, int16_t y,
     }
   }
   // log_i("adjusted writeFillRectPreclipped(x: %d, y: %d, w: %d, h: %d)", x, y, w, h);
+  addDirty(x, y, x + w - 1, y + h - 1);
   uint8_t *row = _framebuffer;
-  row += y * WIDTH;
+  row += y * _fb_width;
   row += x;
   for (int j = 0; j < h; j++)
   {
@@ -277,7 +302,7 @@ void Arduino_Canvas_Indexed::writeFillRectPreclipped(int16_t x, int16_t y,
     {
       row[i] = idx;
     }
-    row += WIDTH;
+    row += _fb_width;
   }
 }
 
@@ -285,7 +310,7 @@ void Arduino_Canvas_Indexed::drawIndexedBitmap(
     int16_t x, int16_t y,
     uint8_t *bitmap, uint16_t *color_index, int16_t w, int16_t h, int16_t x_skip)
 {
-  if (_rotation > 0)
+  if (_fb_rotation > 0)
   {
     if (!_isDirectUseColorIndex)
     {
@@ -339,6 +364,7 @@ void Arduino_Canvas_Indexed::drawIndexedBitmap(
         w += x;
         x = 0;
       }
+      addDirty(x, y, x + w - 1, y + h - 1);
       uint8_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -385,7 +411,7 @@ void Arduino_Canvas_Indexed::drawIndexedBitmap(
     int16_t x, int16_t y,
     uint8_t *bitmap, uint16_t *color_index, uint8_t chroma_key, int16_t w, int16_t h, int16_t x_skip)
 {
-  if (_rotation > 0)
+  if (_fb_rotation > 0)
   {
     if (!_isDirectUseColorIndex)
     {
@@ -444,6 +470,7 @@ void Arduino_Canvas_Indexed::drawIndexedBitmap(
         w += x;
         x = 0;
       }
+      addDirty(x, y, x + w - 1, y + h - 1);
       uint8_t *row = _framebuffer;
       row += y * _width;
       row += x;
@@ -484,19 +511,271 @@ void Arduino_Canvas_Indexed::drawIndexedBitmap(
   }
 }
 
+/**************************************************************************/
+/*!
+  @brief  Send changed regions to the output, or the whole framebuffer if
+    dirty tracking is disabled
+  @param  force_flush  send the whole framebuffer
+*/
+/**************************************************************************/
 void Arduino_Canvas_Indexed::flush(bool force_flush)
 {
   if (_output)
   {
-    _output->drawIndexedBitmap(_output_x, _output_y, _framebuffer, _color_index, WIDTH, HEIGHT);
+    bool transpose = (_rotation_mode == CANVAS_ROTATE_ON_FLUSH) && (_rotation > 0);
+    if (force_flush || (!_dirtyTracking))
+    {
+      if (transpose)
+      {
+        flushTransposed(0, 0, MAX_X, MAX_Y);
+      }
+      else
+      {
+        _output->drawIndexedBitmap(_output_x, _output_y, _framebuffer, _color_index, _fb_width, _fb_height);
+      }
+    }
+    else
+    {
+      gfx_rect_t *r = _dirty.rect;
+      for (uint8_t i = 0; i < _dirty.count; ++i, ++r)
+      {
+        if (transpose)
+        {
+          flushTransposed(r->x1, r->y1, r->x2, r->y2);
+        }
+        else
+        {
+          int16_t w = r->x2 - r->x1 + 1;
+          _output->drawIndexedBitmap(
+              _output_x + r->x1, _output_y + r->y1,
+              _framebuffer + ((int32_t)r->y1 * _fb_width) + r->x1, _color_index,
+              w, r->y2 - r->y1 + 1, _fb_width - w);
+        }
+      }
+    }
+  }
+  _dirty.count = 0;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Rotate a region of the logical framebuffer to panel orientation,
+    expand it to 16-bit colors and send it, CANVAS_TRANSPOSE_ROWS panel rows
+    per output write
+  @param  x1  Left edge, logical coordinates
+  @param  y1  Top edge, logical coordinates
+  @param  x2  Right edge, logical coordinates
+  @param  y2  Bottom edge, logical coordinates
+*/
+/**************************************************************************/
+void Arduino_Canvas_Indexed::flushTransposed(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+  if (!_transposeBuf)
+  {
+    _transposeBuf = (uint16_t *)malloc(WIDTH * CANVAS_TRANSPOSE_ROWS * 2);
+    if (!_transposeBuf)
+    {
+      return;
+    }
+  }
+
+  int16_t rx1, ry1, rx2, ry2;
+  switch (_rotation)
+  {
+  case 1:
+    rx1 = _max_y - y2;
+    rx2 = _max_y - y1;
+    ry1 = x1;
+    ry2 = x2;
+    break;
+  case 2:
+    rx1 = _max_x - x2;
+    rx2 = _max_x - x1;
+    ry1 = _max_y - y2;
+    ry2 = _max_y - y1;
+    break;
+  default: // case 3:
+    rx1 = y1;
+    rx2 = y2;
+    ry1 = _max_x - x2;
+    ry2 = _max_x - x1;
+  }
+  int16_t rw = rx2 - rx1 + 1;
+
+  for (int16_t ry = ry1; ry <= ry2; ry += CANVAS_TRANSPOSE_ROWS)
+  {
+    int16_t rows = ry2 - ry + 1;
+    if (rows > CANVAS_TRANSPOSE_ROWS)
+    {
+      rows = CANVAS_TRANSPOSE_ROWS;
+    }
+    uint16_t *d = _transposeBuf;
+    uint8_t *s;
+    switch (_rotation)
+    {
+    case 1:
+      for (int16_t rx = rx1; rx <= rx2; ++rx)
+      {
+        s = _framebuffer + ((int32_t)(_max_y - rx) * _fb_width) + ry;
+        uint16_t *dd = d++;
+        for (int16_t j = 0; j < rows; ++j)
+        {
+          *dd = _color_index[*s++];
+          dd += rw;
+        }
+      }
+      break;
+    case 2:
+      for (int16_t j = 0; j < rows; ++j)
+      {
+        s = _framebuffer + ((int32_t)(_max_y - ry - j) * _fb_width) + (_max_x - rx1);
+        for (int16_t i = 0; i < rw; ++i)
+        {
+          *d++ = _color_index[*s--];
+        }
+      }
+      break;
+    default: // case 3:
+      for (int16_t rx = rx1; rx <= rx2; ++rx)
+      {
+        s = _framebuffer + ((int32_t)rx * _fb_width) + (_max_x - ry);
+        uint16_t *dd = d++;
+        for (int16_t j = 0; j < rows; ++j)
+        {
+          *dd = _color_index[*s--];
+          dd += rw;
+        }
+      }
+    }
+    _output->draw16bitRGBBitmap(_output_x + rx1, _output_y + ry, _transposeBuf, rw, rows);
   }
 }
 
+/**************************************************************************/
+/*!
+  @brief  Set rotation of the canvas. With CANVAS_ROTATE_ON_DRAW the
+    framebuffer content keeps its panel orientation, with the other modes it
+    is reinterpreted in the new orientation, so redraw the whole canvas.
+  @param  r  rotation, 0 to 3
+*/
+/**************************************************************************/
+void Arduino_Canvas_Indexed::setRotation(uint8_t r)
+{
+  Arduino_GFX::setRotation(r);
+  if ((_rotation_mode == CANVAS_ROTATE_ON_DRAW) || (_rotation > 3))
+  {
+    _fb_rotation = _rotation;
+    _fb_width = WIDTH;
+    _fb_height = HEIGHT;
+  }
+  else
+  {
+    _fb_rotation = 0;
+    _fb_width = _width;
+    _fb_height = _height;
+  }
+  MAX_X = _fb_width - 1;
+  MAX_Y = _fb_height - 1;
+  _dirty.count = 0;
+  addDirty(0, 0, MAX_X, MAX_Y);
+}
+
+/**************************************************************************/
+/*!
+  @brief  Choose where rotation is applied, see Arduino_Canvas::setRotationMode()
+  @param  mode  CANVAS_ROTATE_ON_DRAW, CANVAS_ROTATE_ON_FLUSH or CANVAS_ROTATE_BY_OUTPUT
+*/
+/**************************************************************************/
+void Arduino_Canvas_Indexed::setRotationMode(uint8_t mode)
+{
+  _rotation_mode = mode;
+  setRotation(_rotation);
+}
+
+/**************************************************************************/
+/*!
+  @brief  Get the framebuffer. Writes through this pointer are not tracked,
+    so dirty tracking is disabled and flush() sends the whole framebuffer
+    again, until setDirtyTracking(true) is called.
+  @return framebuffer
+*/
+/**************************************************************************/
 uint8_t *Arduino_Canvas_Indexed::getFramebuffer()
 {
+  _dirtyTracking = false;
   return _framebuffer;
 }
 
+/**************************************************************************/
+/*!
+  @brief  Enable or disable dirty region tracking. When enabled, flush() only
+    sends the regions changed by drawing functions and markDirty().
+  @param  enable  true to track changed regions
+*/
+/**************************************************************************/
+void Arduino_Canvas_Indexed::setDirtyTracking(bool enable)
+{
+  if (enable && (!_dirtyTracking))
+  {
+    // unknown changes while disabled
+    _dirtyTracking = true;
+    addDirty(0, 0, MAX_X, MAX_Y);
+  }
+  else
+  {
+    _dirtyTracking = enable;
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Mark a region as changed, e.g. after writing to the framebuffer directly
+  @param  x  Top left corner x coordinate
+  @param  y  Top left corner y coordinate
+  @param  w  Width in pixels
+  @param  h  Height in pixels
+*/
+/**************************************************************************/
+void Arduino_Canvas_Indexed::markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int16_t x2 = x + w - 1;
+  int16_t y2 = y + h - 1;
+  if ((w <= 0) || (h <= 0) || (x > _max_x) || (y > _max_y) || (x2 < 0) || (y2 < 0))
+  {
+    return;
+  }
+  if (x < 0)
+  {
+    x = 0;
+  }
+  if (y < 0)
+  {
+    y = 0;
+  }
+  if (x2 > _max_x)
+  {
+    x2 = _max_x;
+  }
+  if (y2 > _max_y)
+  {
+    y2 = _max_y;
+  }
+  switch (_fb_rotation)
+  {
+  case 1:
+    addDirty(_max_y - y2, x, _max_y - y, x2);
+    break;
+  case 2:
+    addDirty(_max_x - x2, _max_y - y2, _max_x - x, _max_y - y);
+    break;
+  case 3:
+    addDirty(y, _max_x - x2, y2, _max_x - x);
+    break;
+  default: // case 0:
+    addDirty(x, y, x2, y2);
+  }
+}
+
 uint16_t *Arduino_Canvas_Indexed::getColorIndex()
 {
   return _color_index;
@@ -507,21 +786,71 @@ void Arduino_Canvas_Indexed::setDirectUseColorIndex(bool isEnable)
   _isDirectUseColorIndex = isEnable;
 }
 
+/**************************************************************************/
+/*!
+  @brief  Map new colors to the nearest palette color once the palette is
+    full, instead of raising the mask level
+  @param  isEnable  true to use nearest color
+*/
+/**************************************************************************/
+void Arduino_Canvas_Indexed::setNearestColor(bool isEnable)
+{
+  _isNearestColor = isEnable;
+}
+
+GFX_INLINE static uint16_t gfx_color_hash(uint16_t color)
+{
+  // Fibonacci hashing, top 9 bits for COLOR_HASH_SIZE 512
+  return (uint16_t)(color * 40503u) >> 7;
+}
+
+static uint8_t gfx_nearest_palette_index(uint16_t *palette, uint8_t size, uint16_t color)
+{
+  int16_t r = (color >> 8) & 0xF8;
+  int16_t g = (color >> 3) & 0xFC;
+  int16_t b = (color << 3) & 0xF8;
+  uint8_t nearest = 0;
+  uint32_t nearest_dist = UINT32_MAX;
+  for (uint8_t i = 0; i < size; i++)
+  {
+    int16_t dr = r - ((palette[i] >> 8) & 0xF8);
+    int16_t dg = g - ((palette[i] >> 3) & 0xFC);
+    int16_t db = b - ((palette[i] << 3) & 0xF8);
+    uint32_t dist = (int32_t)dr * dr + (int32_t)dg * dg + (int32_t)db * db;
+    if (dist < nearest_dist)
+    {
+      nearest_dist = dist;
+      nearest = i;
+    }
+  }
+  return nearest;
+}
+
 uint8_t Arduino_Canvas_Indexed::get_color_index(uint16_t color)
 {
   color &= _color_mask;
-  for (uint8_t i = 0; i < _indexed_size; i++)
+  uint16_t h = gfx_color_hash(color);
+  uint8_t i;
+  while ((i = _color_hash[h]) != COLOR_HASH_EMPTY)
   {
     if (_color_index[i] == color)
     {
       return i;
     }
+    h = (h + 1) & (COLOR_HASH_SIZE - 1);
   }
   if (_indexed_size == (COLOR_IDX_SIZE - 1)) // overflowed
   {
+    if (_isNearestColor || ((_current_mask_level + 1) >= MAXMASKLEVEL))
+    {
+      return get_nearest_color_index(color);
+    }
     raise_mask_level();
+    return get_color_index(color);
   }
   _color_index[_indexed_size] = color;
+  _color_hash[h] = _indexed_size;
+  _nearest_cube_valid = false;
   // print("color_index[");
   // print(_indexed_size);
   // print("] = ");
@@ -529,6 +858,38 @@ uint8_t Arduino_Canvas_Indexed::get_color_index(uint16_t color)
   return _indexed_size++;
 }
 
+/**************************************************************************/
+/*!
+  @brief  Get the palette index nearest to a color. The answers for a
+    4-4-4 bit RGB cube are precomputed on first use after the palette
+    changed, falls back to a linear search if the cube cannot be allocated.
+  @param  color  16-bit 5-6-5 color
+  @return palette index
+*/
+/**************************************************************************/
+uint8_t Arduino_Canvas_Indexed::get_nearest_color_index(uint16_t color)
+{
+  if (!_nearest_cube_valid)
+  {
+    if (!_nearest_cube)
+    {
+      _nearest_cube = (uint8_t *)malloc(NEAREST_CUBE_SIZE);
+    }
+    if (!_nearest_cube)
+    {
+      return gfx_nearest_palette_index(_color_index, _indexed_size, color);
+    }
+    for (uint16_t c = 0; c < NEAREST_CUBE_SIZE; c++)
+    {
+      // center of the cube cell
+      uint16_t cell = ((c & 0xF00) << 4) | 0x0800 | ((c & 0x0F0) << 3) | 0x0040 | ((c & 0x00F) << 1) | 0x0001;
+      _nearest_cube[c] = gfx_nearest_palette_index(_color_index, _indexed_size, cell);
+    }
+    _nearest_cube_valid = true;
+  }
+  return _nearest_cube[((color >> 4) & 0xF00) | ((color >> 3) & 0x0F0) | ((color >> 1) & 0x00F)];
+}
+
 GFX_INLINE uint16_t Arduino_Canvas_Indexed::get_index_color(uint8_t idx)
 {
   return _color_index[idx];
@@ -540,23 +901,25 @@ void Arduino_Canvas_Indexed::raise_mask_level()
   {
     int32_t buffer_size = _width * _height;
     uint8_t old_indexed_size = _indexed_size;
-    uint8_t new_color;
+    uint8_t new_color[COLOR_IDX_SIZE];
     _indexed_size = 0;
     _color_mask = mask_level_list[++_current_mask_level];
+    memset(_color_hash, COLOR_HASH_EMPTY, sizeof(_color_hash));
+    _nearest_cube_valid = false;
     // print("Raised mask level: ");
     // println(_current_mask_level);
 
-    // update _framebuffer color index, it is a time consuming job
-    for (uint8_t old_color = 0; old_color < old_indexed_size; old_color++)
+    // new index never exceeds old index, so _color_index can be rebuilt in place
+    for (uint16_t old_color = 0; old_color < COLOR_IDX_SIZE; old_color++)
     {
-      new_color = get_color_index(_color_index[old_color]);
-      for (int32_t i = 0; i < buffer_size; i++)
-      {
-        if (_framebuffer[i] == old_color)
-        {
-          _framebuffer[i] = new_color;
-        }
-      }
+      new_color[old_color] = (old_color < old_indexed_size) ? get_color_index(_color_index[old_color]) : old_color;
+    }
+
+    // update _framebuffer color index
+    addDirty(0, 0, MAX_X, MAX_Y);
+    for (int32_t i = 0; i < buffer_size; i++)
+    {
+      _framebuffer[i] = new_color[_framebuffer[i]];
     }
   }
 }
@@ -7,6 +7,9 @@
 #include "../Arduino_GFX.h"
 
 #define COLOR_IDX_SIZE 256
+#define COLOR_HASH_SIZE 512    // open addressing color to index table, power of 2 and over 2x COLOR_IDX_SIZE
+#define COLOR_HASH_EMPTY 0xFF  // palette index 255 is never used
+#define NEAREST_CUBE_SIZE 4096 // 4-4-4 bit RGB cube of nearest palette index
 
 class Arduino_Canvas_Indexed : public Arduino_GFX
 {
@@ -24,24 +27,46 @@ public:
   void drawIndexedBitmap(int16_t x, int16_t y, uint8_t *bitmap, uint16_t *color_index, int16_t w, int16_t h, int16_t x_skip = 0) override;
   void drawIndexedBitmap(int16_t x, int16_t y, uint8_t *bitmap, uint16_t *color_index, uint8_t chroma_key, int16_t w, int16_t h, int16_t x_skip = 0) override;
   void flush(bool force_flush = false) override;
+  void setRotation(uint8_t r) override;
+  void setRotationMode(uint8_t mode);
 
   uint8_t *getFramebuffer();
   uint16_t *getColorIndex();
   void setDirectUseColorIndex(bool isEnable);
+  void setNearestColor(bool isEnable);
+
+  void setDirtyTracking(bool enable);
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
 
   uint8_t get_color_index(uint16_t color);
   uint16_t get_index_color(uint8_t idx);
+  uint8_t get_nearest_color_index(uint16_t color);
   void raise_mask_level();
 
 protected:
+  void addDirty(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+  void flushTransposed(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+
   uint8_t *_framebuffer = nullptr;
   Arduino_G *_output = nullptr;
   int16_t _output_x, _output_y;
   int16_t MAX_X, MAX_Y;
 
+  uint8_t _rotation_mode = CANVAS_ROTATE_ON_DRAW;
+  uint8_t _fb_rotation = 0;      // rotation applied by write functions
+  int16_t _fb_width, _fb_height; // framebuffer layout, raw or logical size
+  uint16_t *_transposeBuf = nullptr;
+
+  gfx_dirty_rects_t _dirty = {};
+  bool _dirtyTracking = true;
+
   uint16_t _color_index[COLOR_IDX_SIZE];
   uint8_t _indexed_size = 0;
   bool _isDirectUseColorIndex = false;
+  uint8_t _color_hash[COLOR_HASH_SIZE];
+  bool _isNearestColor = false;
+  uint8_t *_nearest_cube = nullptr;
+  bool _nearest_cube_valid = false;
 
   uint8_t _current_mask_level;
   uint16_t _color_mask;
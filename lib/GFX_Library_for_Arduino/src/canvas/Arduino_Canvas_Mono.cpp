@@ -62,12 +62,18 @@ bool Arduino_Canvas_Mono::begin(int32_t speed)
       return false;
     }
   }
+  gfx_dirty_rects_add(&_dirty, 0, 0, _canvas_width - 1, _canvas_height - 1);
 
   return true;
 }
 
 void Arduino_Canvas_Mono::writePixelPreclipped(int16_t x, int16_t y, uint16_t color)
 {
+  if (_dirtyTracking)
+  {
+    gfx_dirty_rects_add(&_dirty, x, y, x, y);
+  }
+
   // change the pixel in the original orientation of the bitmap buffer
   if (_verticalByte)
   {
@@ -100,17 +106,96 @@ void Arduino_Canvas_Mono::writePixelPreclipped(int16_t x, int16_t y, uint16_t co
   }
 }
 
+/**************************************************************************/
+/*!
+  @brief  Send the framebuffer to the output if anything changed. With the
+    horizontal byte layout only the changed rows are sent; the vertical
+    byte layout is for page based displays that always take whole frames.
+  @param  force_flush  send the whole framebuffer even if nothing changed
+*/
+/**************************************************************************/
 void Arduino_Canvas_Mono::flush(bool force_flush)
 {
   if (_output)
   {
-    _output->drawBitmap(_output_x, _output_y, _framebuffer, _canvas_width, _canvas_height, RGB565_WHITE, RGB565_BLACK);
+    if (force_flush || (!_dirtyTracking) || (_dirty.count && _verticalByte))
+    {
+      _output->drawBitmap(_output_x, _output_y, _framebuffer, _canvas_width, _canvas_height, RGB565_WHITE, RGB565_BLACK);
+    }
+    else if (_dirty.count)
+    {
+      // rows are whole bytes, send the band of changed rows
+      int16_t y1 = _dirty.rect[0].y1;
+      int16_t y2 = _dirty.rect[0].y2;
+      for (uint8_t i = 1; i < _dirty.count; ++i)
+      {
+        if (_dirty.rect[i].y1 < y1)
+        {
+          y1 = _dirty.rect[i].y1;
+        }
+        if (_dirty.rect[i].y2 > y2)
+        {
+          y2 = _dirty.rect[i].y2;
+        }
+      }
+      _output->drawBitmap(_output_x, _output_y + y1, _framebuffer + (int32_t)y1 * ((_canvas_width + 7) / 8), _canvas_width, y2 - y1 + 1, RGB565_WHITE, RGB565_BLACK);
+    }
   }
+  _dirty.count = 0;
 }
 
+/**************************************************************************/
+/*!
+  @brief  Get the framebuffer. Writes through this pointer are not tracked,
+    so dirty tracking is disabled and flush() sends the whole framebuffer
+    again, until setDirtyTracking(true) is called.
+  @return framebuffer
+*/
+/**************************************************************************/
 uint8_t *Arduino_Canvas_Mono::getFramebuffer()
 {
+  _dirtyTracking = false;
   return _framebuffer;
 }
 
+/**************************************************************************/
+/*!
+  @brief  Enable or disable dirty region tracking. When enabled, flush() skips
+    sending if nothing changed.
+  @param  enable  true to track changed regions
+*/
+/**************************************************************************/
+void Arduino_Canvas_Mono::setDirtyTracking(bool enable)
+{
+  if (enable && (!_dirtyTracking))
+  {
+    // unknown changes while disabled
+    gfx_dirty_rects_add(&_dirty, 0, 0, _canvas_width - 1, _canvas_height - 1);
+  }
+  _dirtyTracking = enable;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Mark a region as changed, e.g. after writing to the framebuffer directly
+  @param  x  Top left corner x coordinate
+  @param  y  Top left corner y coordinate
+  @param  w  Width in pixels
+  @param  h  Height in pixels
+*/
+/**************************************************************************/
+void Arduino_Canvas_Mono::markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int16_t x2 = x + w - 1;
+  int16_t y2 = y + h - 1;
+  if ((w <= 0) || (h <= 0) || (x >= _canvas_width) || (y >= _canvas_height) || (x2 < 0) || (y2 < 0))
+  {
+    return;
+  }
+  gfx_dirty_rects_add(
+      &_dirty,
+      (x < 0) ? 0 : x, (y < 0) ? 0 : y,
+      (x2 >= _canvas_width) ? (_canvas_width - 1) : x2, (y2 >= _canvas_height) ? (_canvas_height - 1) : y2);
+}
+
 #endif // !defined(LITTLE_FOOT_PRINT)
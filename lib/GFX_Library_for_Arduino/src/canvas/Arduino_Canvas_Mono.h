@@ -17,6 +17,8 @@ public:
   void flush(bool force_flush = false) override;
 
   uint8_t *getFramebuffer();
+  void setDirtyTracking(bool enable);
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
 
 protected:
   uint8_t *_framebuffer = nullptr;
@@ -25,6 +27,9 @@ protected:
   bool _verticalByte;
   int16_t _canvas_width, _canvas_height;  // width and height of canvas buffer
 
+  gfx_dirty_rects_t _dirty = {};
+  bool _dirtyTracking = true;
+
 private:
 };
 
@@ -0,0 +1,394 @@
+#include "../Arduino_DataBus.h"
+#if !defined(LITTLE_FOOT_PRINT)
+
+#include "../Arduino_GFX.h"
+#include "Arduino_Canvas_Strip.h"
+
+Arduino_Canvas_Strip::Arduino_Canvas_Strip(
+    int16_t w, int16_t h, Arduino_G *output, int16_t band_h, bool double_buffer, int16_t output_x, int16_t output_y, uint8_t r)
+    : Arduino_GFX(w, h), _output(output), _output_x(output_x), _output_y(output_y), _double_buffer(double_buffer)
+{
+  MAX_X = WIDTH - 1;
+  MAX_Y = HEIGHT - 1;
+  if (band_h < 1)
+  {
+    band_h = 1;
+  }
+  else if (band_h > HEIGHT)
+  {
+    band_h = HEIGHT;
+  }
+  _band_h = band_h;
+  setRotation(r);
+}
+
+Arduino_Canvas_Strip::~Arduino_Canvas_Strip()
+{
+  for (uint8_t i = 0; i < 2; ++i)
+  {
+    if (_bandBuf[i])
+    {
+      free(_bandBuf[i]);
+    }
+  }
+}
+
+bool Arduino_Canvas_Strip::begin(int32_t speed)
+{
+  if (
+      (speed != GFX_SKIP_OUTPUT_BEGIN) && (_output))
+  {
+    if (!_output->begin(speed))
+    {
+      return false;
+    }
+  }
+
+  if (_queue)
+  {
+    // the queue owns the band buffers
+    return _queue->getBufferPixels() >= ((uint32_t)WIDTH * _band_h);
+  }
+
+  size_t s = WIDTH * _band_h * 2;
+  for (uint8_t i = 0; i < (_double_buffer ? 2 : 1); ++i)
+  {
+    if (!_bandBuf[i])
+    {
+#if defined(ESP32)
+      _bandBuf[i] = (uint16_t *)aligned_alloc(16, s);
+#else
+      _bandBuf[i] = (uint16_t *)malloc(s);
+#endif
+      if (!_bandBuf[i])
+      {
+        return false;
+      }
+    }
+  }
+  _framebuffer = _bandBuf[0];
+
+  return true;
+}
+
+void Arduino_Canvas_Strip::writePixelPreclipped(int16_t x, int16_t y, uint16_t color)
+{
+  int16_t rx, ry;
+  switch (_rotation)
+  {
+  case 1:
+    rx = _max_y - y;
+    ry = x;
+    break;
+  case 2:
+    rx = _max_x - x;
+    ry = _max_y - y;
+    break;
+  case 3:
+    rx = y;
+    ry = _max_x - x;
+    break;
+  default: // case 0:
+    rx = x;
+    ry = y;
+  }
+  if (_ordered_in_range(ry, _band_y, _band_y2))
+  {
+    _framebuffer[((int32_t)(ry - _band_y) * WIDTH) + rx] = color;
+  }
+}
+
+void Arduino_Canvas_Strip::writeFastVLine(int16_t x, int16_t y,
+                                          int16_t h, uint16_t color)
+{
+  switch (_rotation)
+  {
+  case 1:
+    writeFastHLineCore(_height - y - h, x, h, color);
+    break;
+  case 2:
+    writeFastVLineCore(_max_x - x, _height - y - h, h, color);
+    break;
+  case 3:
+    writeFastHLineCore(y, _max_x - x, h, color);
+    break;
+  default: // case 0:
+    writeFastVLineCore(x, y, h, color);
+  }
+}
+
+void Arduino_Canvas_Strip::writeFastVLineCore(int16_t x, int16_t y,
+                                              int16_t h, uint16_t color)
+{
+  if (_ordered_in_range(x, 0, MAX_X) && h)
+  { // X on screen, nonzero height
+    if (h < 0)
+    {             // If negative height...
+      y += h + 1; //   Move Y to top edge
+      h = -h;     //   Use positive height
+    }
+    int16_t y2 = y + h - 1;
+    // clip to current band, the band never exceeds the screen
+    if (y < _band_y)
+    {
+      y = _band_y;
+    }
+    if (y2 > _band_y2)
+    {
+      y2 = _band_y2;
+    }
+    if (y <= y2)
+    {
+      h = y2 - y + 1;
+      uint16_t *fb = _framebuffer + ((int32_t)(y - _band_y) * WIDTH) + x;
+      while (h--)
+      {
+        *fb = color;
+        fb += WIDTH;
+      }
+    }
+  }
+}
+
+void Arduino_Canvas_Strip::writeFastHLine(int16_t x, int16_t y,
+                                          int16_t w, uint16_t color)
+{
+  switch (_rotation)
+  {
+  case 1:
+    writeFastVLineCore(_max_y - y, x, w, color);
+    break;
+  case 2:
+    writeFastHLineCore(_width - x - w, _max_y - y, w, color);
+    break;
+  case 3:
+    writeFastVLineCore(y, _width - x - w, w, color);
+    break;
+  default: // case 0:
+    writeFastHLineCore(x, y, w, color);
+  }
+}
+
+void Arduino_Canvas_Strip::writeFastHLineCore(int16_t x, int16_t y,
+                                              int16_t w, uint16_t color)
+{
+  if (_ordered_in_range(y, _band_y, _band_y2) && w)
+  { // Y in band, nonzero width
+    if (w < 0)
+    {             // If negative width...
+      x += w + 1; //   Move X to left edge
+      w = -w;     //   Use positive width
+    }
+    if (x <= MAX_X)
+    { // Not off right
+      int16_t x2 = x + w - 1;
+      if (x2 >= 0)
+      { // Not off left
+        // Line partly or fully overlaps screen
+        if (x < 0)
+        {
+          x = 0;
+          w = x2 + 1;
+        } // Clip left
+        if (x2 > MAX_X)
+        {
+          w = MAX_X - x + 1;
+        } // Clip right
+
+        uint16_t *fb = _framebuffer + ((int32_t)(y - _band_y) * WIDTH) + x;
+        while (w--)
+        {
+          *(fb++) = color;
+        }
+      }
+    }
+  }
+}
+
+void Arduino_Canvas_Strip::writeFillRectPreclipped(int16_t x, int16_t y,
+                                                   int16_t w, int16_t h, uint16_t color)
+{
+  if (_rotation > 0)
+  {
+    int16_t t = x;
+    switch (_rotation)
+    {
+    case 1:
+      x = WIDTH - y - h;
+      y = t;
+      t = w;
+      w = h;
+      h = t;
+      break;
+    case 2:
+      x = WIDTH - x - w;
+      y = HEIGHT - y - h;
+      break;
+    case 3:
+      x = y;
+      y = HEIGHT - t - w;
+      t = w;
+      w = h;
+      h = t;
+      break;
+    }
+  }
+  int16_t y2 = y + h - 1;
+  if (y < _band_y)
+  {
+    y = _band_y;
+  }
+  if (y2 > _band_y2)
+  {
+    y2 = _band_y2;
+  }
+  uint16_t *row = _framebuffer + ((int32_t)(y - _band_y) * WIDTH) + x;
+  for (int16_t j = y; j <= y2; j++)
+  {
+    for (int i = 0; i < w; i++)
+    {
+      row[i] = color;
+    }
+    row += WIDTH;
+  }
+}
+
+void Arduino_Canvas_Strip::draw16bitRGBBitmap(int16_t x, int16_t y,
+                                              uint16_t *bitmap, int16_t w, int16_t h)
+{
+  if (_rotation > 0)
+  {
+    Arduino_GFX::draw16bitRGBBitmap(x, y, bitmap, w, h);
+  }
+  else
+  {
+    if (
+        ((x + w - 1) < 0) ||       // Outside left
+        ((y + h - 1) < _band_y) || // Above band
+        (x > _max_x) ||            // Outside right
+        (y > _band_y2)             // Below band
+    )
+    {
+      return;
+    }
+    else
+    {
+      int16_t xs = (x < 0) ? -x : 0;
+      int16_t xe = ((x + w - 1) > _max_x) ? (_max_x - x + 1) : w;
+      int16_t ys = (y < _band_y) ? (_band_y - y) : 0;
+      int16_t ye = ((y + h - 1) > _band_y2) ? (_band_y2 - y + 1) : h;
+      bitmap += ((int32_t)ys * w) + xs;
+      uint16_t *row = _framebuffer + ((int32_t)(y + ys - _band_y) * WIDTH) + x + xs;
+      size_t len = (xe - xs) * 2;
+      for (int16_t j = ys; j < ye; j++)
+      {
+        memcpy(row, bitmap, len);
+        bitmap += w;
+        row += WIDTH;
+      }
+    }
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Send the current band to the output
+  @param  force_flush  not used
+*/
+/**************************************************************************/
+void Arduino_Canvas_Strip::flush(bool force_flush)
+{
+  if (_queue)
+  {
+    if (_band_y2 >= _band_y)
+    {
+      _queue->submit(_framebuffer, _output_x, _output_y + _band_y, WIDTH, _band_y2 - _band_y + 1);
+    }
+  }
+  else if ((_output) && (_band_y2 >= _band_y))
+  {
+    _output->draw16bitRGBBitmap(_output_x, _output_y + _band_y, _framebuffer, WIDTH, _band_y2 - _band_y + 1);
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Start rendering a frame at the top band. Draw the whole frame
+    between firstPage() and nextPage(), drawing outside the band is
+    clipped. Band content is not cleared, so every frame should paint
+    all of its pixels, e.g. begin with fillScreen().
+*/
+/**************************************************************************/
+void Arduino_Canvas_Strip::firstPage()
+{
+  _band_idx = 0;
+  _framebuffer = _queue ? _queue->acquire() : _bandBuf[0];
+  _band_y = 0;
+  _band_y2 = _band_h - 1;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Flush the finished band and move to the next one
+  @return true if there is another band to draw, false when the frame is done
+*/
+/**************************************************************************/
+bool Arduino_Canvas_Strip::nextPage()
+{
+  flush();
+
+  _band_y += _band_h;
+  if (_band_y > MAX_Y)
+  {
+    // frame done, clip out any drawing until next firstPage()
+    _band_y = 0;
+    _band_y2 = -1;
+    return false;
+  }
+  _band_y2 = _band_y + _band_h - 1;
+  if (_band_y2 > MAX_Y)
+  {
+    _band_y2 = MAX_Y;
+  }
+  if (_queue)
+  {
+    _framebuffer = _queue->acquire();
+  }
+  else if (_double_buffer)
+  {
+    _band_idx ^= 1;
+    _framebuffer = _bandBuf[_band_idx];
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Render into the buffers of a transfer queue, finished bands are
+    sent by the queue consumer while the next band is drawn. Call before
+    begin(), the queue must be started with at least width * band_h pixel
+    buffers and output set to the canvas output.
+  @param  queue  transfer queue, nullptr to use the own band buffers
+*/
+/**************************************************************************/
+void Arduino_Canvas_Strip::setTransferQueue(Arduino_BandQueue *queue)
+{
+  _queue = queue;
+}
+
+uint16_t *Arduino_Canvas_Strip::getFramebuffer()
+{
+  return _framebuffer;
+}
+
+int16_t Arduino_Canvas_Strip::getBandY()
+{
+  return _band_y;
+}
+
+int16_t Arduino_Canvas_Strip::getBandHeight()
+{
+  return _band_h;
+}
+
+#endif // !defined(LITTLE_FOOT_PRINT)
@@ -0,0 +1,59 @@
+#include "../Arduino_DataBus.h"
+#if !defined(LITTLE_FOOT_PRINT)
+
+#ifndef _ARDUINO_CANVAS_STRIP_H_
+#define _ARDUINO_CANVAS_STRIP_H_
+
+#include "../Arduino_GFX.h"
+#include "Arduino_BandQueue.h"
+
+// Canvas that holds only a horizontal band of the frame in RAM. The sketch
+// draws the whole frame once per band in a firstPage() / nextPage() loop,
+// drawing calls are clipped to the current band and each finished band is
+// sent to the output with a single bitmap write. With a transfer queue the
+// bands are rendered into the queue buffers and sent by its consumer, e.g.
+// a transfer task on the other core.
+class Arduino_Canvas_Strip : public Arduino_GFX
+{
+public:
+  Arduino_Canvas_Strip(int16_t w, int16_t h, Arduino_G *output, int16_t band_h = 24, bool double_buffer = false, int16_t output_x = 0, int16_t output_y = 0, uint8_t rotation = 0);
+  ~Arduino_Canvas_Strip();
+
+  bool begin(int32_t speed = GFX_NOT_DEFINED) override;
+  void writePixelPreclipped(int16_t x, int16_t y, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void writeFastVLineCore(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void writeFastHLineCore(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
+  void flush(bool force_flush = false) override;
+
+  void setTransferQueue(Arduino_BandQueue *queue);
+  void firstPage();
+  bool nextPage();
+
+  uint16_t *getFramebuffer();
+  int16_t getBandY();
+  int16_t getBandHeight();
+
+protected:
+  uint16_t *_framebuffer = nullptr; // current band buffer
+  uint16_t *_bandBuf[2] = {nullptr, nullptr};
+  Arduino_G *_output = nullptr;
+  Arduino_BandQueue *_queue = nullptr; // band buffers and transfer, instead of _bandBuf
+  int16_t _output_x, _output_y;
+  int16_t MAX_X, MAX_Y;
+
+  int16_t _band_h;         // band height in raw (unrotated) rows
+  bool _double_buffer;     // draw next band while the output may still read the last one
+  uint8_t _band_idx = 0;   // index of _framebuffer in _bandBuf
+  int16_t _band_y = 0;     // first raw row of current band
+  int16_t _band_y2 = -1;   // last raw row of current band
+
+private:
+};
+
+#endif // _ARDUINO_CANVAS_STRIP_H_
+
+#endif // !defined(LITTLE_FOOT_PRINT)
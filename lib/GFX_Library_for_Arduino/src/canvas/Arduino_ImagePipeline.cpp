@@ -0,0 +1,338 @@
+#include "../Arduino_DataBus.h"
+#if !defined(LITTLE_FOOT_PRINT)
+
+#include "../Arduino_GFX.h"
+#include "Arduino_ImagePipeline.h"
+
+Arduino_ImagePipeline::Arduino_ImagePipeline(Arduino_GFX *output, int16_t band_h, bool double_buffer)
+    : _output(output), _band_h_req((band_h < 1) ? 1 : band_h), _double_buffer(double_buffer)
+{
+}
+
+Arduino_ImagePipeline::~Arduino_ImagePipeline()
+{
+  for (uint8_t i = 0; i < 2; ++i)
+  {
+    if (_bandBuf[i])
+    {
+      free(_bandBuf[i]);
+    }
+  }
+  if (_accBuf)
+  {
+    free(_accBuf);
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Start a new image, call before the decoder starts
+  @param  x            output x position of the image top left corner
+  @param  y            output y position of the image top left corner
+  @param  w            decoded image width in pixels
+  @param  h            decoded image height in pixels
+  @param  scale_shift  downscale 1 / (1 << scale_shift), 0 - 2
+  @param  big_endian   decoder pixels are big endian RGB565, e.g. JPEGDEC
+    RGB565_BIG_ENDIAN, the bands are sent with draw16bitBeRGBBitmap()
+  @return false if scale_shift is not supported or the image is empty
+*/
+/**************************************************************************/
+bool Arduino_ImagePipeline::begin(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t scale_shift, bool big_endian)
+{
+  if (scale_shift > IMAGEPIPELINE_MAX_SCALE_SHIFT)
+  {
+    return false;
+  }
+  _x = x;
+  _y = y;
+  _shift = scale_shift;
+  _w = w >> scale_shift;
+  _h = h >> scale_shift;
+  _big_endian = big_endian;
+  _band_h = 0;
+  _band_y = 0;
+  _band_idx = 0;
+  _band_dirty = false;
+  return (_w > 0) && (_h > 0);
+}
+
+/**************************************************************************/
+/*!
+  @brief  Add a decoded block, blocks must arrive top to bottom like MCU
+    rows of JPEGDEC or lines of PNGdec. A band is sent as soon as a block
+    below it arrives.
+  @param  x       block x position in the decoded image
+  @param  y       block y position in the decoded image
+  @param  pixels  RGB565 pixels, w pixels per row
+  @param  w       block width in pixels
+  @param  h       block height in pixels
+  @return false if the band buffers cannot be allocated
+*/
+/**************************************************************************/
+bool Arduino_ImagePipeline::drawBlock(int16_t x, int16_t y, uint16_t *pixels, int16_t w, int16_t h)
+{
+  if ((!_band_h) && (!allocBands(h)))
+  {
+    return false;
+  }
+  // clip left, the rows are clipped right below
+  int16_t xs = (x < 0) ? -x : 0;
+  if ((xs >= w) || ((x >> _shift) >= _w))
+  {
+    return true;
+  }
+
+  int16_t dy, len;
+  uint16_t p;
+  for (int16_t j = 0; j < h; j++, pixels += w)
+  {
+    dy = (y + j) >> _shift;
+    if (dy >= _h)
+    {
+      break;
+    }
+    if (dy < _band_y)
+    {
+      // band already sent
+      continue;
+    }
+    if (dy >= (_band_y + _band_h))
+    {
+      flushBand();
+      _band_y = dy - (dy % _band_h);
+    }
+
+    if (_shift == 0)
+    {
+      len = _w - x;
+      if (len > w)
+      {
+        len = w;
+      }
+      memcpy(_bandBuf[_band_idx] + ((int32_t)(dy - _band_y) * _w) + x + xs, pixels + xs, (len - xs) * 2);
+    }
+    else
+    {
+      // sum the channels of all source pixels of each output pixel
+      uint32_t *acc = _accBuf + ((int32_t)(dy - _band_y) * _w);
+      int16_t dx;
+      for (int16_t i = xs; i < w; i++)
+      {
+        dx = (x + i) >> _shift;
+        if (dx >= _w)
+        {
+          break;
+        }
+        p = pixels[i];
+        if (_big_endian)
+        {
+          MSB_16_SET(p, p);
+        }
+        acc[dx] += ((uint32_t)(p & 0xF800) << 10) | ((uint32_t)(p & 0x07E0) << 5) | (p & 0x001F);
+      }
+    }
+    _band_dirty = true;
+  }
+  return true;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Add a decoded row, e.g. from a PNGdec draw callback
+  @param  y       row in the decoded image
+  @param  pixels  RGB565 pixels
+  @param  w       row width in pixels
+  @return false if the band buffers cannot be allocated
+*/
+/**************************************************************************/
+bool Arduino_ImagePipeline::drawRow(int16_t y, uint16_t *pixels, int16_t w)
+{
+  return drawBlock(0, y, pixels, w, 1);
+}
+
+/**************************************************************************/
+/*!
+  @brief  Send the last band and wait until it is no longer read, call after
+    the decoder finished
+*/
+/**************************************************************************/
+void Arduino_ImagePipeline::end()
+{
+  if (_band_h)
+  {
+    flushBand();
+  }
+  if (_in_flight && _wait_cb)
+  {
+    _wait_cb(_cb_user);
+  }
+  _in_flight = false;
+  _band_h = 0;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Send finished bands through a callback instead of the output
+    display, e.g. to queue them on a DMA capable bus. With double buffer
+    the next band is assembled while the callback transfer runs, wait_cb
+    is called before a band buffer is reused. Band pixels are in the
+    decoder byte order.
+  @param  flush_cb  send a band, may return before the transfer is done
+  @param  wait_cb   wait for the last transfer, may be nullptr if flush_cb
+    is synchronous
+  @param  user      passed to both callbacks
+*/
+/**************************************************************************/
+void Arduino_ImagePipeline::setFlushCallback(gfx_band_flush_cb_t flush_cb, gfx_band_wait_cb_t wait_cb, void *user)
+{
+  _flush_cb = flush_cb;
+  _wait_cb = wait_cb;
+  _cb_user = user;
+}
+
+int16_t Arduino_ImagePipeline::getOutputWidth()
+{
+  return _w;
+}
+
+int16_t Arduino_ImagePipeline::getOutputHeight()
+{
+  return _h;
+}
+
+int16_t Arduino_ImagePipeline::getBandHeight()
+{
+  return _band_h ? _band_h : _band_h_req;
+}
+
+bool Arduino_ImagePipeline::allocBands(int16_t block_h)
+{
+  // a block must not straddle two bands, round the band up to whole blocks
+  int16_t bh = block_h >> _shift;
+  if (bh < 1)
+  {
+    bh = 1;
+  }
+  int16_t band_h = ((_band_h_req + bh - 1) / bh) * bh;
+  if (band_h > _h)
+  {
+    band_h = _h;
+  }
+
+  uint32_t size = (uint32_t)_w * band_h;
+  if (size > _bandBufSize)
+  {
+    for (uint8_t i = 0; i < 2; ++i)
+    {
+      if (_bandBuf[i])
+      {
+        free(_bandBuf[i]);
+        _bandBuf[i] = nullptr;
+      }
+    }
+    _bandBufSize = size;
+  }
+  for (uint8_t i = 0; i < ((_double_buffer && _flush_cb) ? 2 : 1); ++i)
+  {
+    if (!_bandBuf[i])
+    {
+#if defined(ESP32)
+      _bandBuf[i] = (uint16_t *)aligned_alloc(16, _bandBufSize * 2);
+#else
+      _bandBuf[i] = (uint16_t *)malloc(_bandBufSize * 2);
+#endif
+      if (!_bandBuf[i])
+      {
+        return false;
+      }
+    }
+  }
+
+  if (_shift)
+  {
+    if (size > _accBufSize)
+    {
+      if (_accBuf)
+      {
+        free(_accBuf);
+      }
+      _accBuf = (uint32_t *)malloc(size * 4);
+      if (!_accBuf)
+      {
+        _accBufSize = 0;
+        return false;
+      }
+      _accBufSize = size;
+    }
+    memset(_accBuf, 0, size * 4);
+  }
+
+  _band_h = band_h;
+  return true;
+}
+
+void Arduino_ImagePipeline::flushBand()
+{
+  if (!_band_dirty)
+  {
+    return;
+  }
+
+  int16_t rows = _h - _band_y;
+  if (rows > _band_h)
+  {
+    rows = _band_h;
+  }
+  uint16_t *band = _bandBuf[_band_idx];
+  if (_shift)
+  {
+    // channel sums to rounded averages
+    uint32_t len = (uint32_t)_w * rows;
+    uint8_t s = _shift * 2;
+    uint32_t half = (1 << s) >> 1;
+    uint32_t sum;
+    uint16_t p;
+    for (uint32_t i = 0; i < len; i++)
+    {
+      sum = _accBuf[i];
+      p = ((((sum >> 21) + half) >> s) << 11) | (((((sum >> 10) & 0x7FF) + half) >> s) << 5) | (((sum & 0x3FF) + half) >> s);
+      if (_big_endian)
+      {
+        MSB_16_SET(p, p);
+      }
+      band[i] = p;
+      _accBuf[i] = 0;
+    }
+  }
+
+  if (_flush_cb)
+  {
+    // one transfer at a time, the other buffer is free once it is done
+    if (_in_flight && _wait_cb)
+    {
+      _wait_cb(_cb_user);
+    }
+    _flush_cb(_cb_user, _x, _y + _band_y, band, _w, rows);
+    _in_flight = true;
+    if (_bandBuf[1])
+    {
+      _band_idx ^= 1;
+    }
+    else if (_wait_cb)
+    {
+      _wait_cb(_cb_user);
+      _in_flight = false;
+    }
+  }
+  else if (_big_endian)
+  {
+    _output->draw16bitBeRGBBitmap(_x, _y + _band_y, band, _w, rows);
+  }
+  else
+  {
+    _output->draw16bitRGBBitmap(_x, _y + _band_y, band, _w, rows);
+  }
+  _band_dirty = false;
+}
+
+#endif // !defined(LITTLE_FOOT_PRINT)
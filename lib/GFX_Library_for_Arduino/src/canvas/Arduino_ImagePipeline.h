@@ -0,0 +1,69 @@
+#include "../Arduino_DataBus.h"
+#if !defined(LITTLE_FOOT_PRINT)
+
+#ifndef _ARDUINO_IMAGEPIPELINE_H_
+#define _ARDUINO_IMAGEPIPELINE_H_
+
+#include "../Arduino_GFX.h"
+
+#define IMAGEPIPELINE_MAX_SCALE_SHIFT 2 // downscale up to 1/4, use the decoder's own scaling beyond
+
+// Send a finished band, may start an asynchronous transfer and return
+typedef void (*gfx_band_flush_cb_t)(void *user, int16_t x, int16_t y, uint16_t *band, int16_t w, int16_t h);
+// Wait until the last band sent by gfx_band_flush_cb_t is no longer read
+typedef void (*gfx_band_wait_cb_t)(void *user);
+
+// Streaming image output for JPEG / PNG decoders. The decoder callback hands
+// its MCU blocks or rows to drawBlock() / drawRow(), they are assembled into
+// full width bands and each finished band is sent with one bitmap write.
+// With a flush callback and double buffer, the next band is decoded while
+// the last one is still being transferred. Optional integer downscale
+// averages 2x2 or 4x4 source pixels.
+class Arduino_ImagePipeline
+{
+public:
+  Arduino_ImagePipeline(Arduino_GFX *output, int16_t band_h = 16, bool double_buffer = true);
+  ~Arduino_ImagePipeline();
+
+  bool begin(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t scale_shift = 0, bool big_endian = false);
+  bool drawBlock(int16_t x, int16_t y, uint16_t *pixels, int16_t w, int16_t h);
+  bool drawRow(int16_t y, uint16_t *pixels, int16_t w);
+  void end();
+
+  void setFlushCallback(gfx_band_flush_cb_t flush_cb, gfx_band_wait_cb_t wait_cb, void *user = nullptr);
+  int16_t getOutputWidth();
+  int16_t getOutputHeight();
+  int16_t getBandHeight();
+
+protected:
+  bool allocBands(int16_t block_h);
+  void flushBand();
+
+  Arduino_GFX *_output;
+  int16_t _band_h_req;     // requested band height
+  bool _double_buffer;     // decode next band while the last one may still be read
+  gfx_band_flush_cb_t _flush_cb = nullptr;
+  gfx_band_wait_cb_t _wait_cb = nullptr;
+  void *_cb_user = nullptr;
+
+  uint16_t *_bandBuf[2] = {nullptr, nullptr};
+  uint32_t *_accBuf = nullptr;      // per output pixel channel sums when downscaling
+  uint32_t _bandBufSize = 0;        // capacity of each band buffer in pixels
+  uint32_t _accBufSize = 0;         // capacity of _accBuf in pixels
+
+  int16_t _x, _y;             // output position of the image
+  int16_t _w = 0, _h = 0;     // output image size
+  uint8_t _shift = 0;         // downscale 1 / (1 << _shift)
+  bool _big_endian = false;   // decoder pixels are big endian RGB565
+  int16_t _band_h = 0;        // actual band height, 0 until the first block
+  int16_t _band_y = 0;        // first output row of current band
+  uint8_t _band_idx = 0;      // band buffer being assembled
+  bool _band_dirty = false;   // current band holds decoded pixels
+  bool _in_flight = false;    // flush callback may still read a band
+
+private:
+};
+
+#endif // _ARDUINO_IMAGEPIPELINE_H_
+
+#endif // !defined(LITTLE_FOOT_PRINT)
@@ -0,0 +1,446 @@
+#include "Arduino_RecordBus.h"
+
+#if !defined(LITTLE_FOOT_PRINT)
+
+Arduino_RecordBus::Arduino_RecordBus(int16_t gram_w, int16_t gram_h, uint32_t trace_size)
+    : _gram_w(gram_w), _gram_h(gram_h), _trace_size(trace_size)
+{
+}
+
+Arduino_RecordBus::~Arduino_RecordBus()
+{
+  if (_gram)
+  {
+    free(_gram);
+  }
+  if (_trace)
+  {
+    free(_trace);
+  }
+}
+
+bool Arduino_RecordBus::begin(int32_t speed, int8_t dataMode)
+{
+  UNUSED(dataMode);
+  _speed = (speed == GFX_NOT_DEFINED) ? RECORDBUS_DEFAULT_SPEED : speed;
+
+  if (!_gram)
+  {
+    _gram = (uint16_t *)calloc((size_t)_gram_w * _gram_h, 2);
+    if (!_gram)
+    {
+      return false;
+    }
+  }
+  if ((_trace_size) && (!_trace))
+  {
+    _trace = (uint8_t *)malloc(_trace_size);
+    if (!_trace)
+    {
+      return false;
+    }
+  }
+  reset();
+  _trace_len = 0;
+  _trace_data_pos = 0;
+  _trace_overflow = false;
+
+  return true;
+}
+
+void Arduino_RecordBus::beginWrite()
+{
+  ++_stats.transactions;
+  if (traceReserve(1))
+  {
+    _trace[_trace_len++] = RECORDBUS_BEGIN_WRITE;
+  }
+}
+
+void Arduino_RecordBus::endWrite()
+{
+  if (traceReserve(1))
+  {
+    _trace[_trace_len++] = RECORDBUS_END_WRITE;
+  }
+}
+
+void Arduino_RecordBus::writeCommand(uint8_t c)
+{
+  ++_stats.commands;
+  ++_stats.command_bytes;
+  if (traceReserve(2))
+  {
+    _trace[_trace_len++] = RECORDBUS_COMMAND;
+    _trace[_trace_len++] = c;
+  }
+  decodeCommand(c);
+}
+
+void Arduino_RecordBus::writeCommand16(uint16_t c)
+{
+  ++_stats.commands;
+  _stats.command_bytes += 2;
+  if (traceReserve(3))
+  {
+    _trace[_trace_len++] = RECORDBUS_COMMAND16;
+    _trace[_trace_len++] = c >> 8;
+    _trace[_trace_len++] = c;
+  }
+  // 16-bit command sets are not emulated
+  decodeCommand(0);
+}
+
+void Arduino_RecordBus::writeCommandBytes(uint8_t *data, uint32_t len)
+{
+  while (len--)
+  {
+    writeCommand(*data++);
+  }
+}
+
+void Arduino_RecordBus::write(uint8_t d)
+{
+  traceData(d);
+  decodeByte(d);
+}
+
+void Arduino_RecordBus::write16(uint16_t d)
+{
+  traceData(d >> 8);
+  traceData(d);
+  if (_in_ramwr && (!_pixel_msb_pending))
+  {
+    _stats.pixel_bytes += 2;
+    putPixel(d);
+  }
+  else
+  {
+    decodeByte(d >> 8);
+    decodeByte(d);
+  }
+}
+
+void Arduino_RecordBus::writeRepeat(uint16_t p, uint32_t len)
+{
+  if (!len)
+  {
+    return;
+  }
+  if (traceReserve(7))
+  {
+    _trace[_trace_len++] = RECORDBUS_REPEAT;
+    _trace[_trace_len++] = p >> 8;
+    _trace[_trace_len++] = p;
+    _trace[_trace_len++] = len;
+    _trace[_trace_len++] = len >> 8;
+    _trace[_trace_len++] = len >> 16;
+    _trace[_trace_len++] = len >> 24;
+  }
+  if (_in_ramwr && (!_pixel_msb_pending))
+  {
+    _stats.pixel_bytes += len * 2;
+    while (len--)
+    {
+      putPixel(p);
+    }
+  }
+  else
+  {
+    while (len--)
+    {
+      decodeByte(p >> 8);
+      decodeByte(p);
+    }
+  }
+}
+
+void Arduino_RecordBus::writeBytes(uint8_t *data, uint32_t len)
+{
+  while (len--)
+  {
+    write(*data++);
+  }
+}
+
+void Arduino_RecordBus::writePixels(uint16_t *data, uint32_t len)
+{
+  while (len--)
+  {
+    write16(*data++);
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Clear the statistics, e.g. between benchmark workloads. The trace
+    and the emulated display memory are kept.
+*/
+/**************************************************************************/
+void Arduino_RecordBus::reset()
+{
+  _stats = {};
+}
+
+/**************************************************************************/
+/*!
+  @brief  Get bus traffic counted since begin() or reset()
+  @return statistics
+*/
+/**************************************************************************/
+recordbus_stats_t Arduino_RecordBus::getStats()
+{
+  return _stats;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Set the cost of one transaction (CS toggle, SPI transaction lock,
+    DMA setup...) added to the wire time estimate
+  @param  ns  nanoseconds per beginWrite()
+*/
+/**************************************************************************/
+void Arduino_RecordBus::setTransactionOverhead(uint32_t ns)
+{
+  _transaction_ns = ns;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Estimate the time a SPI bus at the begin() speed needs for the
+    traffic counted since begin() or reset(), 8 clocks per byte plus the
+    transaction overhead
+  @return microseconds
+*/
+/**************************************************************************/
+uint32_t Arduino_RecordBus::getWireTimeUs()
+{
+  uint64_t bits = ((uint64_t)_stats.command_bytes + _stats.pixel_bytes) * 8;
+  uint64_t ns = (bits * 1000000000ULL / _speed) + ((uint64_t)_stats.transactions * _transaction_ns);
+  return ns / 1000;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Get the emulated display memory, gram_w x gram_h pixels in panel
+    orientation
+  @return display memory, nullptr before begin()
+*/
+/**************************************************************************/
+uint16_t *Arduino_RecordBus::getFramebuffer()
+{
+  return _gram;
+}
+
+uint8_t *Arduino_RecordBus::getTrace()
+{
+  return _trace;
+}
+
+uint32_t Arduino_RecordBus::getTraceLength()
+{
+  return _trace_len;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Check if the trace buffer was too small, the trace then holds the
+    records before it filled up
+  @return true if records were dropped
+*/
+/**************************************************************************/
+bool Arduino_RecordBus::isTraceOverflow()
+{
+  return _trace_overflow;
+}
+
+/**************************************************************************/
+/*!
+  @brief  Send a recorded trace to another data bus
+  @param  bus    output data bus, begin() already called
+  @param  trace  trace from getTrace()
+  @param  len    trace length from getTraceLength()
+*/
+/**************************************************************************/
+void Arduino_RecordBus::replay(Arduino_DataBus *bus, const uint8_t *trace, uint32_t len)
+{
+  uint32_t i = 0;
+  while (i < len)
+  {
+    switch (trace[i++])
+    {
+    case RECORDBUS_BEGIN_WRITE:
+      bus->beginWrite();
+      break;
+    case RECORDBUS_END_WRITE:
+      bus->endWrite();
+      break;
+    case RECORDBUS_COMMAND:
+      bus->writeCommand(trace[i++]);
+      break;
+    case RECORDBUS_COMMAND16:
+      bus->writeCommand16(((uint16_t)trace[i] << 8) | trace[i + 1]);
+      i += 2;
+      break;
+    case RECORDBUS_DATA:
+    {
+      uint8_t l = trace[i++];
+      bus->writeBytes((uint8_t *)trace + i, l);
+      i += l;
+      break;
+    }
+    case RECORDBUS_REPEAT:
+    {
+      uint16_t p = ((uint16_t)trace[i] << 8) | trace[i + 1];
+      uint32_t n = trace[i + 2] | ((uint32_t)trace[i + 3] << 8) | ((uint32_t)trace[i + 4] << 16) | ((uint32_t)trace[i + 5] << 24);
+      bus->writeRepeat(p, n);
+      i += 6;
+      break;
+    }
+    default:
+      // corrupted trace
+      return;
+    }
+  }
+}
+
+GFX_INLINE void Arduino_RecordBus::decodeCommand(uint8_t c)
+{
+  _cmd = c;
+  _param_idx = 0;
+  _pixel_msb_pending = false;
+  if (c == RECORDBUS_RAMWR)
+  {
+    _col = _col_s;
+    _row = _row_s;
+    _in_ramwr = true;
+  }
+  else
+  {
+    // RAMWRC continues at the current address
+    _in_ramwr = (c == RECORDBUS_RAMWRC);
+  }
+}
+
+GFX_INLINE void Arduino_RecordBus::decodeByte(uint8_t d)
+{
+  if (_in_ramwr)
+  {
+    ++_stats.pixel_bytes;
+    if (_pixel_msb_pending)
+    {
+      _pixel_msb_pending = false;
+      putPixel(((uint16_t)_pixel_msb << 8) | d);
+    }
+    else
+    {
+      _pixel_msb = d;
+      _pixel_msb_pending = true;
+    }
+    return;
+  }
+
+  ++_stats.command_bytes;
+  if (_param_idx < 4)
+  {
+    _params[_param_idx++] = d;
+  }
+  switch (_cmd)
+  {
+  case RECORDBUS_CASET:
+    if (_param_idx == 4)
+    {
+      _col_s = ((uint16_t)_params[0] << 8) | _params[1];
+      _col_e = ((uint16_t)_params[2] << 8) | _params[3];
+    }
+    break;
+  case RECORDBUS_RASET:
+    if (_param_idx == 4)
+    {
+      _row_s = ((uint16_t)_params[0] << 8) | _params[1];
+      _row_e = ((uint16_t)_params[2] << 8) | _params[3];
+    }
+    break;
+  case RECORDBUS_MADCTL:
+    if (_param_idx == 1)
+    {
+      _madctl = d;
+    }
+    break;
+  }
+}
+
+GFX_INLINE void Arduino_RecordBus::putPixel(uint16_t p)
+{
+  // column / row address to panel position, MV exchanges them and MX / MY
+  // mirror the panel axes
+  int32_t x = _col;
+  int32_t y = _row;
+  if (_madctl & RECORDBUS_MADCTL_MV)
+  {
+    x = _row;
+    y = _col;
+  }
+  if (_madctl & RECORDBUS_MADCTL_MX)
+  {
+    x = _gram_w - 1 - x;
+  }
+  if (_madctl & RECORDBUS_MADCTL_MY)
+  {
+    y = _gram_h - 1 - y;
+  }
+  if (_gram && (x >= 0) && (x < _gram_w) && (y >= 0) && (y < _gram_h))
+  {
+    _gram[(y * _gram_w) + x] = p;
+  }
+
+  if (++_col > _col_e)
+  {
+    _col = _col_s;
+    if (++_row > _row_e)
+    {
+      _row = _row_s;
+    }
+  }
+}
+
+GFX_INLINE bool Arduino_RecordBus::traceReserve(uint32_t len)
+{
+  _trace_data_pos = 0;
+  if ((!_trace) || _trace_overflow)
+  {
+    return false;
+  }
+  if ((_trace_len + len) > _trace_size)
+  {
+    // keep the trace a consistent prefix of the traffic
+    _trace_overflow = true;
+    return false;
+  }
+  return true;
+}
+
+void Arduino_RecordBus::traceData(uint8_t d)
+{
+  if (_trace_data_pos && (_trace[_trace_data_pos] < 255))
+  {
+    if (_trace_len < _trace_size)
+    {
+      ++_trace[_trace_data_pos];
+      _trace[_trace_len++] = d;
+      return;
+    }
+    _trace_overflow = true;
+    _trace_data_pos = 0;
+    return;
+  }
+  if (traceReserve(3))
+  {
+    _trace[_trace_len++] = RECORDBUS_DATA;
+    _trace_data_pos = _trace_len;
+    _trace[_trace_len++] = 1;
+    _trace[_trace_len++] = d;
+  }
+}
+
+#endif // !defined(LITTLE_FOOT_PRINT)
@@ -0,0 +1,107 @@
+// Databus that drives no hardware, for benchmarks and regression tests
+// without a display. It records every command and data byte into a compact
+// trace, counts the bus traffic, estimates the wire time of a SPI bus and
+// decodes CASET / RASET / RAMWR / MADCTL into an emulated ST7789 display
+// memory.
+
+#ifndef _ARDUINO_RECORDBUS_H_
+#define _ARDUINO_RECORDBUS_H_
+
+#include "../Arduino_DataBus.h"
+
+#if !defined(LITTLE_FOOT_PRINT)
+
+#define RECORDBUS_DEFAULT_SPEED 40000000 // estimate wire time at 40 MHz SPI if begin() has no speed
+
+// trace record tags, each record starts with one tag byte
+#define RECORDBUS_BEGIN_WRITE 0x01
+#define RECORDBUS_END_WRITE 0x02
+#define RECORDBUS_COMMAND 0x03   // + 1 byte command
+#define RECORDBUS_COMMAND16 0x04 // + 2 bytes command, MSB first
+#define RECORDBUS_DATA 0x05      // + 1 byte length (1 - 255) + data bytes
+#define RECORDBUS_REPEAT 0x06    // + 2 bytes pixel, MSB first + 4 bytes count, LSB first
+
+// emulated display commands
+#define RECORDBUS_CASET 0x2A
+#define RECORDBUS_RASET 0x2B
+#define RECORDBUS_RAMWR 0x2C
+#define RECORDBUS_MADCTL 0x36
+#define RECORDBUS_RAMWRC 0x3C
+#define RECORDBUS_MADCTL_MY 0x80
+#define RECORDBUS_MADCTL_MX 0x40
+#define RECORDBUS_MADCTL_MV 0x20
+
+/// Bus traffic counted since begin() or reset()
+typedef struct
+{
+  uint32_t transactions;  ///< beginWrite() calls
+  uint32_t commands;      ///< command count
+  uint32_t command_bytes; ///< command and parameter bytes
+  uint32_t pixel_bytes;   ///< bytes written after RAMWR
+} recordbus_stats_t;
+
+class Arduino_RecordBus : public Arduino_DataBus
+{
+public:
+  Arduino_RecordBus(int16_t gram_w = 240, int16_t gram_h = 320, uint32_t trace_size = 0);
+  ~Arduino_RecordBus();
+
+  bool begin(int32_t speed = GFX_NOT_DEFINED, int8_t dataMode = GFX_NOT_DEFINED) override;
+  void beginWrite() override;
+  void endWrite() override;
+  void writeCommand(uint8_t) override;
+  void writeCommand16(uint16_t) override;
+  void writeCommandBytes(uint8_t *data, uint32_t len) override;
+  void write(uint8_t) override;
+  void write16(uint16_t) override;
+  void writeRepeat(uint16_t p, uint32_t len) override;
+  void writeBytes(uint8_t *data, uint32_t len) override;
+  void writePixels(uint16_t *data, uint32_t len) override;
+
+  void reset();
+  recordbus_stats_t getStats();
+  void setTransactionOverhead(uint32_t ns);
+  uint32_t getWireTimeUs();
+
+  uint16_t *getFramebuffer();
+  uint8_t *getTrace();
+  uint32_t getTraceLength();
+  bool isTraceOverflow();
+  static void replay(Arduino_DataBus *bus, const uint8_t *trace, uint32_t len);
+
+protected:
+  GFX_INLINE void decodeCommand(uint8_t c);
+  GFX_INLINE void decodeByte(uint8_t d);
+  GFX_INLINE void putPixel(uint16_t p);
+  GFX_INLINE bool traceReserve(uint32_t len);
+  void traceData(uint8_t d);
+
+  recordbus_stats_t _stats = {};
+  uint32_t _transaction_ns = 0;
+
+  // emulated display memory
+  uint16_t *_gram = nullptr;
+  int16_t _gram_w, _gram_h;
+  uint8_t _cmd = 0;
+  uint8_t _param_idx = 0;
+  uint8_t _params[4];
+  uint8_t _madctl = 0;
+  uint16_t _col_s = 0, _col_e = 0, _row_s = 0, _row_e = 0;
+  uint16_t _col = 0, _row = 0;
+  bool _in_ramwr = false;
+  bool _pixel_msb_pending = false;
+  uint8_t _pixel_msb;
+
+  // trace
+  uint8_t *_trace = nullptr;
+  uint32_t _trace_size;
+  uint32_t _trace_len = 0;
+  uint32_t _trace_data_pos = 0; // length byte of the open data record, 0 if none
+  bool _trace_overflow = false;
+
+private:
+};
+
+#endif // !defined(LITTLE_FOOT_PRINT)
+
+#endif // _ARDUINO_RECORDBUS_H_
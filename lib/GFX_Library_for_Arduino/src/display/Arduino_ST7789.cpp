@@ -12,6 +12,7 @@ Arduino_ST7789::Arduino_ST7789(
     uint8_t col_offset1, uint8_t row_offset1, uint8_t col_offset2, uint8_t row_offset2)
     : Arduino_TFT(bus, rst, r, ips, w, h, col_offset1, row_offset1, col_offset2, row_offset2)
 {
+  _gramHeight = ST7789_TFTHEIGHT; // scroll and partial display rows count in the 320 row frame memory
 }
 
 bool Arduino_ST7789::begin(int32_t speed)
@@ -68,6 +69,11 @@ void Arduino_ST7789::setRotation(uint8_t r)
 
 void Arduino_ST7789::writeAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t h)
 {
+  if (coalesceAddrWindow(x, y, w, &h))
+  {
+    return;
+  }
+
   if ((x != _currentX) || (w != _currentW))
   {
     _currentX = x;
@@ -89,17 +95,20 @@ void Arduino_ST7789::writeAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t
 
 void Arduino_ST7789::invertDisplay(bool i)
 {
+  _windowStreaming = false;
   _bus->sendCommand((_ips ^ i) ? ST7789_INVON : ST7789_INVOFF);
 }
 
 void Arduino_ST7789::displayOn(void)
 {
+  _windowStreaming = false;
   _bus->sendCommand(ST7789_SLPOUT);
   delay(ST7789_SLPOUT_DELAY);
 }
 
 void Arduino_ST7789::displayOff(void)
 {
+  _windowStreaming = false;
   _bus->sendCommand(ST7789_SLPIN);
   delay(ST7789_SLPIN_DELAY);
 }
@@ -124,6 +133,7 @@ void Arduino_ST7789::tftInit()
   _bus->sendCommand(ST7789_SWRESET);
   delay(ST7789_RST_DELAY);
   // }
+  _scrollHeight = 0; // reset clears the scroll area
 
   _bus->batchOperation(st7789_init_operations, sizeof(st7789_init_operations));
 
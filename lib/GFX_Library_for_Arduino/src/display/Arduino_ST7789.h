@@ -37,8 +37,14 @@
 #define ST7789_RAMRD 0x2E
 
 #define ST7789_PTLAR 0x30
+#define ST7789_VSCRDEF 0x33
+#define ST7789_TEOFF 0x34
+#define ST7789_TEON 0x35
 #define ST7789_COLMOD 0x3A
 #define ST7789_MADCTL 0x36
+#define ST7789_VSCSAD 0x37
+#define ST7789_IDMOFF 0x38
+#define ST7789_IDMON 0x39
 
 #define ST7789_MADCTL_MY 0x80
 #define ST7789_MADCTL_MX 0x40
@@ -142,3 +148,23 @@ protected:
 
 private:
 };
+
+// Compile-time panel description for Arduino_TFT_T, derive to change the
+// module size or offsets, e.g. a 240x280 module at row 20:
+//   struct ST7789_280Traits : ST7789Traits
+//   {
+//     static constexpr int16_t HEIGHT = 280;
+//     static constexpr uint8_t ROW_OFFSET1 = 20, ROW_OFFSET2 = 20;
+//   };
+struct ST7789Traits
+{
+  typedef Arduino_ST7789 Display;
+  static constexpr bool IPS = false;
+  static constexpr int16_t WIDTH = ST7789_TFTWIDTH;
+  static constexpr int16_t HEIGHT = ST7789_TFTHEIGHT;
+  static constexpr uint8_t COL_OFFSET1 = 0, ROW_OFFSET1 = 0;
+  static constexpr uint8_t COL_OFFSET2 = 0, ROW_OFFSET2 = 0;
+  static constexpr uint8_t CASET = ST7789_CASET;
+  static constexpr uint8_t RASET = ST7789_RASET;
+  static constexpr uint8_t RAMWR = ST7789_RAMWR;
+};
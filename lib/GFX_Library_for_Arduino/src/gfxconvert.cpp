@@ -0,0 +1,271 @@
+#include "gfxconvert.h"
+
+#if !defined(LITTLE_FOOT_PRINT)
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define GFX_CONVERT_SWAR
+#endif
+
+GFX_INLINE static uint16_t gfx_rgb888_565(const uint8_t *p)
+{
+  return ((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3);
+}
+
+GFX_INLINE static uint16_t gfx_gray8_565(uint8_t v)
+{
+  return ((v & 0xF8) << 8) | ((v & 0xFC) << 3) | (v >> 3);
+}
+
+#if defined(GFX_CONVERT_SWAR)
+// memcpy() keeps the loads and stores free of alignment traps and aliasing
+// issues, the compiler turns them into single word accesses
+GFX_INLINE static uint32_t gfx_load32(const void *p)
+{
+  uint32_t v;
+  memcpy(&v, p, 4);
+  return v;
+}
+
+GFX_INLINE static uint32_t gfx_load32_aligned(const void *p)
+{
+  uint32_t v;
+  memcpy(&v, __builtin_assume_aligned(p, 4), 4);
+  return v;
+}
+
+GFX_INLINE static void gfx_store32_aligned(void *p, uint32_t v)
+{
+  memcpy(__builtin_assume_aligned(p, 4), &v, 4);
+}
+
+// 4 pixels from 3 words: R0G0B0R1 G1B1R2G2 B2R3G3B3 (first byte in bits 0-7)
+GFX_INLINE static void gfx_rgb888_quad(uint16_t *dst, uint32_t w0, uint32_t w1, uint32_t w2)
+{
+  uint32_t p0 = ((w0 << 8) & 0xF800) | ((w0 >> 5) & 0x07E0) | ((w0 >> 19) & 0x001F);
+  uint32_t p1 = ((w0 >> 16) & 0xF800) | ((w1 << 3) & 0x07E0) | ((w1 >> 11) & 0x001F);
+  uint32_t p2 = ((w1 >> 8) & 0xF800) | ((w1 >> 21) & 0x07E0) | ((w2 >> 3) & 0x001F);
+  uint32_t p3 = (w2 & 0xF800) | ((w2 >> 13) & 0x07E0) | (w2 >> 27);
+  gfx_store32_aligned(dst, p0 | (p1 << 16));
+  gfx_store32_aligned(dst + 2, p2 | (p3 << 16));
+}
+
+// 2 gray values in bits 0-7 and 16-23 to 2 RGB565 pixels in one word
+GFX_INLINE static uint32_t gfx_gray8_pair(uint32_t v)
+{
+  return ((v & 0x00F800F8) << 8) | ((v & 0x00FC00FC) << 3) | ((v >> 3) & 0x001F001F);
+}
+
+GFX_INLINE static void gfx_gray8_quad(uint16_t *dst, uint32_t w)
+{
+  gfx_store32_aligned(dst, gfx_gray8_pair((w & 0xFF) | ((w & 0xFF00) << 8)));
+  gfx_store32_aligned(dst + 2, gfx_gray8_pair(((w >> 16) & 0xFF) | ((w >> 8) & 0xFF0000)));
+}
+
+// swap the bytes of both halves, same as rotating __builtin_bswap32() by
+// 16 bits but cheaper on cores without a byte swap instruction
+GFX_INLINE static uint32_t gfx_swap16_pair(uint32_t w)
+{
+  return ((w & 0x00FF00FF) << 8) | ((w >> 8) & 0x00FF00FF);
+}
+#endif // defined(GFX_CONVERT_SWAR)
+
+/**************************************************************************/
+/*!
+  @brief  Convert 24-bit RGB pixels to RGB565
+  @param  dst  RGB565 output, len pixels
+  @param  src  R, G, B bytes, len * 3 bytes
+  @param  len  pixel count
+*/
+/**************************************************************************/
+void gfx_convert_rgb888_to_565(uint16_t *dst, const uint8_t *src, uint32_t len)
+{
+#if defined(GFX_CONVERT_SWAR)
+  if (!((uintptr_t)dst & 3))
+  {
+    if ((uintptr_t)src & 3)
+    {
+      while (len >= 4)
+      {
+        gfx_rgb888_quad(dst, gfx_load32(src), gfx_load32(src + 4), gfx_load32(src + 8));
+        src += 12;
+        dst += 4;
+        len -= 4;
+      }
+    }
+    else
+    {
+      while (len >= 4)
+      {
+        gfx_rgb888_quad(dst, gfx_load32_aligned(src), gfx_load32_aligned(src + 4), gfx_load32_aligned(src + 8));
+        src += 12;
+        dst += 4;
+        len -= 4;
+      }
+    }
+  }
+#endif // defined(GFX_CONVERT_SWAR)
+  while (len--)
+  {
+    *dst++ = gfx_rgb888_565(src);
+    src += 3;
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Convert 8-bit grayscale pixels to RGB565
+  @param  dst  RGB565 output, len pixels
+  @param  src  gray values, len bytes
+  @param  len  pixel count
+*/
+/**************************************************************************/
+void gfx_convert_gray8_to_565(uint16_t *dst, const uint8_t *src, uint32_t len)
+{
+#if defined(GFX_CONVERT_SWAR)
+  if (!((uintptr_t)dst & 3))
+  {
+    if ((uintptr_t)src & 3)
+    {
+      while (len >= 4)
+      {
+        gfx_gray8_quad(dst, gfx_load32(src));
+        src += 4;
+        dst += 4;
+        len -= 4;
+      }
+    }
+    else
+    {
+      while (len >= 4)
+      {
+        gfx_gray8_quad(dst, gfx_load32_aligned(src));
+        src += 4;
+        dst += 4;
+        len -= 4;
+      }
+    }
+  }
+#endif // defined(GFX_CONVERT_SWAR)
+  while (len--)
+  {
+    *dst++ = gfx_gray8_565(*src++);
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Convert big endian RGB565 pixels to native RGB565
+  @param  dst  RGB565 output, len pixels, may be the same as src
+  @param  src  big endian RGB565 pixels
+  @param  len  pixel count
+*/
+/**************************************************************************/
+void gfx_convert_565be_to_565(uint16_t *dst, const uint16_t *src, uint32_t len)
+{
+#if defined(GFX_CONVERT_SWAR)
+  if (!((uintptr_t)dst & 3))
+  {
+    if ((uintptr_t)src & 3)
+    {
+      while (len >= 2)
+      {
+        gfx_store32_aligned(dst, gfx_swap16_pair(gfx_load32(src)));
+        src += 2;
+        dst += 2;
+        len -= 2;
+      }
+    }
+    else
+    {
+      while (len >= 2)
+      {
+        gfx_store32_aligned(dst, gfx_swap16_pair(gfx_load32_aligned(src)));
+        src += 2;
+        dst += 2;
+        len -= 2;
+      }
+    }
+  }
+#endif // defined(GFX_CONVERT_SWAR)
+  uint16_t p;
+  while (len--)
+  {
+    p = *src++;
+    MSB_16_SET(*dst++, p);
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Convert indexed color pixels to RGB565 through the palette
+  @param  dst          RGB565 output, len pixels
+  @param  src          color indexes, len bytes
+  @param  color_index  palette of RGB565 colors
+  @param  len          pixel count
+*/
+/**************************************************************************/
+void gfx_convert_indexed_to_565(uint16_t *dst, const uint8_t *src, const uint16_t *color_index, uint32_t len)
+{
+#if defined(GFX_CONVERT_SWAR)
+  if (!((uintptr_t)dst & 3))
+  {
+    uint32_t w;
+    while (len >= 4)
+    {
+      w = gfx_load32(src);
+      gfx_store32_aligned(dst, color_index[w & 0xFF] | ((uint32_t)color_index[(w >> 8) & 0xFF] << 16));
+      gfx_store32_aligned(dst + 2, color_index[(w >> 16) & 0xFF] | ((uint32_t)color_index[w >> 24] << 16));
+      src += 4;
+      dst += 4;
+      len -= 4;
+    }
+  }
+#endif // defined(GFX_CONVERT_SWAR)
+  while (len--)
+  {
+    *dst++ = color_index[*src++];
+  }
+}
+
+/**************************************************************************/
+/*!
+  @brief  Convert a run of pixels in any GFX_CONVERT_* format to RGB565
+  @param  format       GFX_CONVERT_* source format
+  @param  dst          RGB565 output, len pixels
+  @param  src          source pixels
+  @param  color_index  palette for GFX_CONVERT_INDEXED, otherwise not used
+  @param  len          pixel count
+*/
+/**************************************************************************/
+void gfx_convert_row(uint8_t format, uint16_t *dst, const uint8_t *src, const uint16_t *color_index, uint32_t len)
+{
+  switch (format)
+  {
+  case GFX_CONVERT_RGB888:
+    gfx_convert_rgb888_to_565(dst, src, len);
+    break;
+  case GFX_CONVERT_GRAY8:
+    gfx_convert_gray8_to_565(dst, src, len);
+    break;
+  case GFX_CONVERT_RGB565BE:
+    gfx_convert_565be_to_565(dst, (const uint16_t *)src, len);
+    break;
+  default: // GFX_CONVERT_INDEXED
+    gfx_convert_indexed_to_565(dst, src, color_index, len);
+  }
+}
+
+uint8_t gfx_convert_bytes_per_pixel(uint8_t format)
+{
+  switch (format)
+  {
+  case GFX_CONVERT_RGB888:
+    return 3;
+  case GFX_CONVERT_RGB565BE:
+    return 2;
+  default: // GFX_CONVERT_GRAY8, GFX_CONVERT_INDEXED
+    return 1;
+  }
+}
+
+#endif // !defined(LITTLE_FOOT_PRINT)
@@ -0,0 +1,39 @@
+// Row conversion kernels from common bitmap pixel formats to native RGB565.
+// Each kernel converts a run of pixels into a buffer that can be sent with a
+// single writePixels() / draw16bitRGBBitmap() call. On little endian targets
+// the source is read a 32-bit word at a time and two RGB565 pixels are packed
+// per 32-bit store (SWAR), the result is bit-exact with color565().
+//
+// The word path needs a 4-byte aligned dst, other dst falls back to a per
+// pixel loop.
+
+#ifndef _GFXCONVERT_H_
+#define _GFXCONVERT_H_
+
+#include "Arduino_DataBus.h"
+
+#if !defined(LITTLE_FOOT_PRINT)
+
+#define GFX_CONVERT_BUF_PIXELS 128 // stack buffer size of the bitmap draw functions
+
+// source pixel formats of gfx_convert_row()
+#define GFX_CONVERT_RGB888 0   // 3 bytes per pixel, R, G, B
+#define GFX_CONVERT_GRAY8 1    // 1 byte per pixel
+#define GFX_CONVERT_RGB565BE 2 // 2 bytes per pixel, big endian RGB565
+#define GFX_CONVERT_INDEXED 3  // 1 byte per pixel, index into a RGB565 palette
+
+// PROGMEM can be read with plain loads, except on AVR and ESP8266
+#if !defined(ESP8266)
+#define GFX_CONVERT_PROGMEM
+#endif
+
+void gfx_convert_rgb888_to_565(uint16_t *dst, const uint8_t *src, uint32_t len);
+void gfx_convert_gray8_to_565(uint16_t *dst, const uint8_t *src, uint32_t len);
+void gfx_convert_565be_to_565(uint16_t *dst, const uint16_t *src, uint32_t len);
+void gfx_convert_indexed_to_565(uint16_t *dst, const uint8_t *src, const uint16_t *color_index, uint32_t len);
+void gfx_convert_row(uint8_t format, uint16_t *dst, const uint8_t *src, const uint16_t *color_index, uint32_t len);
+uint8_t gfx_convert_bytes_per_pixel(uint8_t format);
+
+#endif // !defined(LITTLE_FOOT_PRINT)
+
+#endif // _GFXCONVERT_H_
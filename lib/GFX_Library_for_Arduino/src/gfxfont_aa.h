@@ -0,0 +1,49 @@
+// Anti-aliased font structures for Arduino_GFX.
+// Fonts are generated by the 'fontconvert_aa' tool from TTF/OTF files.
+// To use a font in your Arduino sketch, #include the corresponding .h
+// file and pass address of GFXAAfont struct to setAAFont().
+//
+// Each pixel carries a 4-bit coverage (alpha) value, 0 = background,
+// 15 = foreground. Glyph bitmaps are stored in one of two layouts:
+//
+// * uncompressed (compressed == 0): alpha nibbles packed high nibble
+//   first, continuous across rows, each glyph starts at a byte boundary.
+// * compressed (compressed == 1): a sequence of packets, runs may span
+//   rows. Packet header byte:
+//     00nnnnnn  n+1 transparent (alpha 0) pixels
+//     01nnnnnn  n+1 opaque (alpha 15) pixels
+//     10nnnnnn  n+1 literal alpha nibbles follow, high nibble first,
+//               padded to a whole byte
+//     11xxxxxx  reserved
+
+#ifndef _GFXFONT_AA_H_
+#define _GFXFONT_AA_H_
+
+#define GFXAA_PACKET_TRANSPARENT 0x00
+#define GFXAA_PACKET_OPAQUE 0x40
+#define GFXAA_PACKET_LITERAL 0x80
+#define GFXAA_PACKET_MAX_RUN 64
+
+/// Anti-aliased font data stored PER GLYPH
+typedef struct
+{
+	uint32_t bitmapOffset; ///< Pointer into GFXAAfont->bitmap
+	uint8_t width;				 ///< Bitmap dimensions in pixels
+	uint8_t height;				 ///< Bitmap dimensions in pixels
+	uint8_t xAdvance;			 ///< Distance to advance cursor (x axis)
+	int8_t xOffset;				 ///< X dist from cursor pos to UL corner
+	int8_t yOffset;				 ///< Y dist from cursor pos to UL corner
+} GFXAAglyph;
+
+/// Anti-aliased data stored for FONT AS A WHOLE
+typedef struct
+{
+	uint8_t *bitmap;		 ///< Glyph bitmaps, concatenated
+	GFXAAglyph *glyph;	 ///< Glyph array
+	uint16_t first;			 ///< ASCII extents (first char)
+	uint16_t last;			 ///< ASCII extents (last char)
+	uint8_t yAdvance;		 ///< Newline distance (y axis)
+	uint8_t compressed;	 ///< 0: raw 4-bpp bitmap, 1: run-length packets
+} GFXAAfont;
+
+#endif // _GFXFONT_AA_H_
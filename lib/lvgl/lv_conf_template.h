@@ -59,6 +59,15 @@
         #undef LV_MEM_POOL_ALLOC
     #endif
 
+    /*Size of a separate area in the memory for the small allocations (e.g. styles, linked list nodes, animations).
+     *It's divided into 512 byte pages of equal size slots to reduce fragmentation and make the allocations faster.
+     *0: disable*/
+    #define LV_MEM_SLAB_SIZE 0          /*[bytes]*/
+    #if LV_MEM_SLAB_SIZE
+        /*Larger allocations use the normal heap. Should be a multiple of 16 and not larger than 128*/
+        #define LV_MEM_SLAB_MAX_ALLOC 128   /*[bytes]*/
+    #endif
+
 #else       /*LV_MEM_CUSTOM*/
     #define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
     #define LV_MEM_CUSTOM_ALLOC   malloc
@@ -70,6 +79,14 @@
  *You will see an error log message if there wasn't enough buffers. */
 #define LV_MEM_BUF_MAX_NUM 16
 
+/*1: Record the file and line, the size and the lifetime of the allocations to see what uses the memory.
+ *See `lv_mem_track_dump()`. It adds 16 bytes to each allocation.*/
+#define LV_USE_MEM_TRACK 0
+#if LV_USE_MEM_TRACK
+    /*Number of the recorded allocation sites. The last one collects the others if there are more.*/
+    #define LV_MEM_TRACK_SITE_CNT 64
+#endif
+
 /*Use the standard `memcpy` and `memset` instead of LVGL's own functions. (Might or might not be faster).*/
 #define LV_MEMCPY_MEMSET_STD 0
 
@@ -139,6 +156,15 @@
 #define LV_LAYER_SIMPLE_BUF_SIZE          (24 * 1024)
 #define LV_LAYER_SIMPLE_FALLBACK_BUF_SIZE (3 * 1024)
 
+/*Record the draw calls of the widgets and replay them until the widget is invalidated.
+ *Widgets which are redrawn only because they overlap a changed area skip the event processing,
+ *style resolution and draw descriptor setup this way.
+ *LV_RETAINED_DRAW_MAX_SIZE: [bytes] max. size of a widget's recording. Larger ones are drawn as usual.*/
+#define LV_USE_RETAINED_DRAW 0
+#if LV_USE_RETAINED_DRAW
+    #define LV_RETAINED_DRAW_MAX_SIZE (1 * 1024)
+#endif
+
 /*Default image cache size. Image caching keeps the images opened.
  *If only the built-in image formats are used there is no real advantage of caching. (I.e. if no new image decoder is added)
  *With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
@@ -306,6 +332,11 @@
 
 #define LV_USE_USER_DATA 1
 
+/*Number of object parts whose most often read style properties are cached.
+ *The cached values are used until a style, a state or the object tree changes.
+ *An entry takes 24 + 32 * 4 bytes (with 32 bit pointers). 0: to disable caching*/
+#define LV_OBJ_STYLE_CACHE_SIZE 0
+
 /*Garbage Collector settings
  *Used if lvgl is bound to higher level language and the memory is managed by that language*/
 #define LV_ENABLE_GC 0
@@ -409,6 +440,15 @@
 /*Enables/disables support for compressed fonts.*/
 #define LV_USE_FONT_COMPRESSED 0
 
+/*Cache the glyph ids of the recently used letters and the decompressed bitmaps of compressed fonts.
+ *LV_FONT_FMT_TXT_CACHE_ID_CNT: number of cached letter -> glyph id pairs. Has to be a power of 2.
+ *LV_FONT_FMT_TXT_CACHE_SIZE: [bytes] statically allocated place for the decompressed glyphs. Used only with LV_USE_FONT_COMPRESSED*/
+#define LV_USE_FONT_FMT_TXT_CACHE 0
+#if LV_USE_FONT_FMT_TXT_CACHE
+    #define LV_FONT_FMT_TXT_CACHE_ID_CNT 32
+    #define LV_FONT_FMT_TXT_CACHE_SIZE (4 * 1024)
+#endif
+
 /*Enable subpixel rendering*/
 #define LV_USE_FONT_SUBPX 0
 #if LV_USE_FONT_SUBPX
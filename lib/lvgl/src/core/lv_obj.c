@@ -457,10 +457,17 @@ static void lv_obj_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_obj_enable_style_refresh(false); /*No need to refresh the style because the object will be deleted*/
     lv_obj_remove_style_all(obj);
     lv_obj_enable_style_refresh(true);
+#if LV_OBJ_STYLE_CACHE_SIZE
+    _lv_obj_style_cache_invalidate();   /*A new object might be allocated at the same address*/
+#endif
 
     /*Remove the animations from this object*/
     lv_anim_del(obj, NULL);
 
+#if LV_USE_RETAINED_DRAW
+    _lv_obj_draw_rec_free(obj);
+#endif
+
     /*Delete from the group*/
     lv_group_t * group = lv_obj_get_group(obj);
     if(group) lv_group_remove_obj(obj);
@@ -888,6 +895,9 @@ static void lv_obj_set_state(lv_obj_t * obj, lv_state_t new_state)
 
     lv_state_t prev_state = obj->state;
     obj->state = new_state;
+#if LV_OBJ_STYLE_CACHE_SIZE
+    _lv_obj_style_cache_invalidate();   /*The children might inherit from the new state*/
+#endif
 
     _lv_style_state_cmp_t cmp_res = _lv_obj_style_state_compare(obj, prev_state, new_state);
     /*If there is no difference in styles there is nothing else to do*/
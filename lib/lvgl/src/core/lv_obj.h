@@ -177,6 +177,9 @@ typedef struct _lv_obj_t {
     _lv_obj_style_t * styles;
 #if LV_USE_USER_DATA
     void * user_data;
+#endif
+#if LV_USE_RETAINED_DRAW
+    struct _lv_obj_draw_rec_t * draw_rec;
 #endif
     lv_area_t coords;
     lv_obj_flag_t flags;
@@ -10,23 +10,43 @@
 #include "lv_obj.h"
 #include "lv_disp.h"
 #include "lv_indev.h"
+#include "../misc/lv_gc.h"
 
 /*********************
  *      DEFINES
  *********************/
 #define MY_CLASS &lv_obj_class
 
+#if LV_USE_RETAINED_DRAW && LV_RETAINED_DRAW_MAX_SIZE > 0xFFFF
+    #error "LV_RETAINED_DRAW_MAX_SIZE should be less than 64 kB"
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_RETAINED_DRAW
+typedef enum {
+    DRAW_REC_MAIN,      /*The main phase is recorded, the post phase is being recorded*/
+    DRAW_REC_READY,     /*Both phases are recorded*/
+    DRAW_REC_NONE,      /*Can't be recorded, e.g. it adds masks. Draw with the events.*/
+} draw_rec_state_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if LV_USE_RETAINED_DRAW
+    static void send_draw_events(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx, bool post);
+    static bool record_draw_events(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx, bool post, uint32_t * size);
+    static void draw_rec_invalidate_children(lv_obj_t * obj, const lv_area_t * area);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_USE_RETAINED_DRAW
+    static lv_obj_draw_rec_stats_t draw_rec_stats;
+#endif
 
 /**********************
  *      MACROS
@@ -393,6 +413,169 @@ lv_layer_type_t _lv_obj_get_layer_type(const lv_obj_t * obj)
     else return LV_LAYER_TYPE_NONE;
 }
 
+#if LV_USE_RETAINED_DRAW
+
+void _lv_obj_draw_retained(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx, bool post)
+{
+    _lv_obj_draw_rec_t * rec = obj->draw_rec;
+
+    /*Moved, e.g. by scrolling a parent*/
+    if(rec && !_lv_area_is_equal(&rec->coords, &obj->coords)) {
+        _lv_obj_draw_rec_free(obj);
+        rec = NULL;
+    }
+
+    if(rec && rec->state == DRAW_REC_READY && _lv_area_is_in(draw_ctx->clip_area, &rec->clip_area, 0)) {
+        if(post) {
+            lv_draw_rec_replay(draw_ctx, (uint8_t *)rec->data + rec->main_size, rec->post_size);
+        }
+        else {
+            draw_rec_stats.replay_cnt++;
+            lv_draw_rec_replay(draw_ctx, rec->data, rec->main_size);
+        }
+        return;
+    }
+
+    uint32_t size;
+    if(post) {
+        if(rec == NULL || rec->state != DRAW_REC_MAIN) {
+            send_draw_events(obj, draw_ctx, true);
+            return;
+        }
+
+        if(record_draw_events(obj, draw_ctx, true, &size)) {
+            _lv_obj_draw_rec_t * rec_new = lv_mem_realloc(rec, sizeof(_lv_obj_draw_rec_t) + rec->main_size + size);
+            if(rec_new == NULL) lv_mem_free(rec);
+            rec = rec_new;
+            if(rec) {
+                lv_memcpy((uint8_t *)rec->data + rec->main_size, LV_GC_ROOT(_lv_draw_rec_buf), size);
+                rec->post_size = size;
+                rec->state = DRAW_REC_READY;
+                draw_rec_stats.record_cnt++;
+            }
+            obj->draw_rec = rec;
+        }
+        else {
+            /*Keep only the state to not try again until invalidated*/
+            rec->main_size = 0;
+            rec->state = DRAW_REC_NONE;
+            obj->draw_rec = lv_mem_realloc(rec, sizeof(_lv_obj_draw_rec_t));
+        }
+        return;
+    }
+
+    /*Record only if it covers more than the previous recording.
+     *E.g. with a small draw buffer the object is drawn in stripes.*/
+    if(rec && (rec->state == DRAW_REC_NONE || !_lv_area_is_in(&rec->clip_area, draw_ctx->clip_area, 0))) {
+        send_draw_events(obj, draw_ctx, false);
+        return;
+    }
+
+    _lv_obj_draw_rec_free(obj);
+
+    bool ok = record_draw_events(obj, draw_ctx, false, &size);
+    rec = lv_mem_alloc(sizeof(_lv_obj_draw_rec_t) + (ok ? size : 0));
+    if(rec) {
+        rec->coords = obj->coords;
+        rec->clip_area = *draw_ctx->clip_area;
+        rec->main_size = ok ? size : 0;
+        rec->post_size = 0;
+        rec->state = ok ? DRAW_REC_MAIN : DRAW_REC_NONE;
+        if(ok) lv_memcpy(rec->data, LV_GC_ROOT(_lv_draw_rec_buf), size);
+    }
+    obj->draw_rec = rec;
+}
+
+void _lv_obj_draw_rec_invalidate(lv_obj_t * obj, const lv_area_t * area)
+{
+    _lv_obj_draw_rec_free(obj);
+
+    /*The children might use the styles of the parent, e.g. opacity or text color*/
+    draw_rec_invalidate_children(obj, area);
+}
+
+void _lv_obj_draw_rec_free(lv_obj_t * obj)
+{
+    if(obj->draw_rec) {
+        lv_mem_free(obj->draw_rec);
+        obj->draw_rec = NULL;
+    }
+}
+
+void lv_obj_get_draw_rec_stats(lv_obj_draw_rec_stats_t * stats)
+{
+    *stats = draw_rec_stats;
+}
+
+#endif /*LV_USE_RETAINED_DRAW*/
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+#if LV_USE_RETAINED_DRAW
+
+static void send_draw_events(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx, bool post)
+{
+    if(post) {
+        lv_event_send(obj, LV_EVENT_DRAW_POST_BEGIN, draw_ctx);
+        lv_event_send(obj, LV_EVENT_DRAW_POST, draw_ctx);
+        lv_event_send(obj, LV_EVENT_DRAW_POST_END, draw_ctx);
+    }
+    else {
+        lv_event_send(obj, LV_EVENT_DRAW_MAIN_BEGIN, draw_ctx);
+        lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
+        lv_event_send(obj, LV_EVENT_DRAW_MAIN_END, draw_ctx);
+    }
+}
+
+/**
+ * Send the draw events of a phase while recording the draw calls into `_lv_draw_rec_buf`, then draw them.
+ * @param obj       pointer to an object
+ * @param draw_ctx  pointer to a draw context
+ * @param post      true: record the post draw phase
+ * @param size      store the size of the recording here
+ * @return          true: the draw calls are in `_lv_draw_rec_buf` until the next recording;
+ *                  false: the draw calls couldn't be recorded but they are drawn
+ */
+static bool record_draw_events(lv_obj_t * obj, lv_draw_ctx_t * draw_ctx, bool post, uint32_t * size)
+{
+    /*Allocated once, only one object is recorded at a time*/
+    if(LV_GC_ROOT(_lv_draw_rec_buf) == NULL) {
+        LV_GC_ROOT(_lv_draw_rec_buf) = lv_mem_alloc(LV_RETAINED_DRAW_MAX_SIZE);
+        LV_ASSERT_MALLOC(LV_GC_ROOT(_lv_draw_rec_buf));
+        if(LV_GC_ROOT(_lv_draw_rec_buf) == NULL) {
+            send_draw_events(obj, draw_ctx, post);
+            return false;
+        }
+    }
+
+    lv_draw_rec_start(draw_ctx, LV_GC_ROOT(_lv_draw_rec_buf), LV_RETAINED_DRAW_MAX_SIZE);
+    send_draw_events(obj, draw_ctx, post);
+    if(!lv_draw_rec_stop(size)) return false;
+
+    /*Nothing was drawn while recording*/
+    lv_draw_rec_replay(draw_ctx, LV_GC_ROOT(_lv_draw_rec_buf), *size);
+    return true;
+}
+
+static void draw_rec_invalidate_children(lv_obj_t * obj, const lv_area_t * area)
+{
+    uint32_t i;
+    uint32_t child_cnt = lv_obj_get_child_cnt(obj);
+    for(i = 0; i < child_cnt; i++) {
+        lv_obj_t * child = obj->spec_attr->children[i];
+        if(child->draw_rec) {
+            lv_area_t child_coords;
+            lv_obj_get_coords(child, &child_coords);
+            lv_coord_t ext_draw_size = _lv_obj_get_ext_draw_size(child);
+            lv_area_increase(&child_coords, ext_draw_size, ext_draw_size);
+            if(_lv_area_is_on(&child_coords, area)) _lv_obj_draw_rec_free(child);
+        }
+
+        /*Check the grandchildren too as they might be out of the child*/
+        draw_rec_invalidate_children(child, area);
+    }
+}
+
+#endif /*LV_USE_RETAINED_DRAW*/
@@ -66,6 +66,23 @@ typedef struct {
     const void * sub_part_ptr;    /**< A pointer the identifies something in the part. E.g. chart series. */
 } lv_obj_draw_part_dsc_t;
 
+#if LV_USE_RETAINED_DRAW
+/** The recorded draw calls of an object*/
+typedef struct _lv_obj_draw_rec_t {
+    lv_area_t coords;       /**< Coordinates of the object when recorded*/
+    lv_area_t clip_area;    /**< Clip area when recorded. Widgets might skip parts outside of it.*/
+    uint16_t main_size;     /**< Size of the main phase draw calls in bytes*/
+    uint16_t post_size;     /**< Size of the post phase draw calls in bytes*/
+    uint8_t state;          /**< Recording phase, used internally*/
+    lv_uintptr_t data[];    /**< The main and the post phase draw calls. Pointer sized for the pointers in the descriptors.*/
+} _lv_obj_draw_rec_t;
+
+typedef struct {
+    uint32_t record_cnt;    /**< Number of times the draw calls of an object were recorded*/
+    uint32_t replay_cnt;    /**< Number of times the recorded draw calls were used instead of the draw events*/
+} lv_obj_draw_rec_stats_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -159,6 +176,38 @@ lv_coord_t _lv_obj_get_ext_draw_size(const struct _lv_obj_t * obj);
 
 lv_layer_type_t _lv_obj_get_layer_type(const struct _lv_obj_t * obj);
 
+#if LV_USE_RETAINED_DRAW
+
+/**
+ * Send the main or post draw events to an object, or replay its draw calls recorded earlier.
+ * The recording is used until the object or one of its parents is invalidated.
+ * @param obj       pointer to an object
+ * @param draw_ctx  pointer to the draw context with the clip area of the object
+ * @param post      false: `LV_EVENT_DRAW_MAIN_BEGIN/MAIN/MAIN_END`; true: `LV_EVENT_DRAW_POST_BEGIN/POST/POST_END`
+ */
+void _lv_obj_draw_retained(struct _lv_obj_t * obj, lv_draw_ctx_t * draw_ctx, bool post);
+
+/**
+ * Delete the recorded draw calls of an object and the children on an area.
+ * @param obj       pointer to an object
+ * @param area      the invalidated area, absolute coordinates
+ */
+void _lv_obj_draw_rec_invalidate(struct _lv_obj_t * obj, const lv_area_t * area);
+
+/**
+ * Delete the recorded draw calls of an object.
+ * @param obj       pointer to an object
+ */
+void _lv_obj_draw_rec_free(struct _lv_obj_t * obj);
+
+/**
+ * Get how many times the draw calls were recorded and replayed since start up.
+ * @param stats     store the counters here
+ */
+void lv_obj_get_draw_rec_stats(lv_obj_draw_rec_stats_t * stats);
+
+#endif /*LV_USE_RETAINED_DRAW*/
+
 /**********************
  *      MACROS
  **********************/
@@ -835,6 +835,11 @@ void lv_obj_invalidate_area(const lv_obj_t * obj, const lv_area_t * area)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
+#if LV_USE_RETAINED_DRAW
+    /*Drop the recording even if nothing is redrawn now, e.g. the object is hidden*/
+    _lv_obj_draw_rec_invalidate((lv_obj_t *)obj, area);
+#endif
+
     lv_disp_t * disp   = lv_obj_get_disp(obj);
     if(!lv_disp_is_invalidation_enabled(disp)) return;
 
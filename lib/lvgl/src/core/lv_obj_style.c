@@ -15,6 +15,9 @@
  *********************/
 #define MY_CLASS &lv_obj_class
 
+/*Number of the most often read properties cached per object part*/
+#define STYLE_CACHE_PROP_CNT 32
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -35,6 +38,19 @@ typedef enum {
     CACHE_NEED_CHECK = 4,
 } cache_t;
 
+#if LV_OBJ_STYLE_CACHE_SIZE
+/*Resolved style properties of an object part in a state*/
+typedef struct {
+    const lv_obj_t * obj;
+    lv_part_t part;
+    lv_state_t state;
+    uint32_t obj_version;   /*`style_cache_version` when filled*/
+    uint32_t style_version; /*`_lv_style_get_version()` when filled*/
+    uint32_t valid;         /*Bit `i` is set if `values[i]` is resolved*/
+    lv_style_value_t values[STYLE_CACHE_PROP_CNT];
+} style_cache_t;
+#endif
+
 /**********************
  *  GLOBAL PROTOTYPES
  **********************/
@@ -45,6 +61,10 @@ typedef enum {
 static lv_style_t * get_local_style(lv_obj_t * obj, lv_style_selector_t selector);
 static _lv_obj_style_t * get_trans_style(lv_obj_t * obj, uint32_t part);
 static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, lv_style_value_t * v);
+static lv_style_value_t resolve_prop(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop);
+#if LV_OBJ_STYLE_CACHE_SIZE
+    static style_cache_t * get_style_cache(const lv_obj_t * obj, lv_part_t part);
+#endif
 static void report_style_change_core(void * style, lv_obj_t * obj);
 static void refresh_children_style(lv_obj_t * obj);
 static bool trans_del(lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop, trans_t * tr_limit);
@@ -60,6 +80,49 @@ static void fade_in_anim_ready(lv_anim_t * a);
  **********************/
 static bool style_refr = true;
 
+#if LV_OBJ_STYLE_CACHE_SIZE
+static style_cache_t style_cache[LV_OBJ_STYLE_CACHE_SIZE];
+static uint32_t style_cache_version;
+static lv_obj_style_cache_stats_t style_cache_stats;
+
+/*Index + 1 of the cached properties in `style_cache_t::values`, 0 if not cached.
+ *These are the properties read the most while drawing the widgets demo.*/
+static const uint8_t style_cache_index[_LV_STYLE_NUM_BUILT_IN_PROPS] = {
+    [LV_STYLE_OPA] = 1,
+    [LV_STYLE_BORDER_WIDTH] = 2,
+    [LV_STYLE_PAD_TOP] = 3,
+    [LV_STYLE_PAD_BOTTOM] = 4,
+    [LV_STYLE_PAD_LEFT] = 5,
+    [LV_STYLE_PAD_RIGHT] = 6,
+    [LV_STYLE_BASE_DIR] = 7,
+    [LV_STYLE_CLIP_CORNER] = 8,
+    [LV_STYLE_BORDER_POST] = 9,
+    [LV_STYLE_TEXT_FONT] = 10,
+    [LV_STYLE_COLOR_FILTER_DSC] = 11,
+    [LV_STYLE_TEXT_LINE_SPACE] = 12,
+    [LV_STYLE_TEXT_LETTER_SPACE] = 13,
+    [LV_STYLE_RADIUS] = 14,
+    [LV_STYLE_OUTLINE_WIDTH] = 15,
+    [LV_STYLE_BG_OPA] = 16,
+    [LV_STYLE_TRANSFORM_WIDTH] = 17,
+    [LV_STYLE_TRANSFORM_HEIGHT] = 18,
+    [LV_STYLE_SHADOW_WIDTH] = 19,
+    [LV_STYLE_BG_IMG_SRC] = 20,
+    [LV_STYLE_TEXT_COLOR] = 21,
+    [LV_STYLE_TEXT_ALIGN] = 22,
+    [LV_STYLE_TEXT_DECOR] = 23,
+    [LV_STYLE_TEXT_OPA] = 24,
+    [LV_STYLE_BG_COLOR] = 25,
+    [LV_STYLE_BG_DITHER_MODE] = 26,
+    [LV_STYLE_BG_GRAD] = 27,
+    [LV_STYLE_BG_GRAD_DIR] = 28,
+    [LV_STYLE_BORDER_OPA] = 29,
+    [LV_STYLE_BORDER_SIDE] = 30,
+    [LV_STYLE_BORDER_COLOR] = 31,
+    [LV_STYLE_BLEND_MODE] = 32,
+};
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -168,6 +231,10 @@ void lv_obj_refresh_style(lv_obj_t * obj, lv_style_selector_t selector, lv_style
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
 
+#if LV_OBJ_STYLE_CACHE_SIZE
+    _lv_obj_style_cache_invalidate();
+#endif
+
     if(!style_refr) return;
 
     lv_obj_invalidate(obj);
@@ -222,49 +289,25 @@ void lv_obj_enable_style_refresh(bool en)
 
 lv_style_value_t lv_obj_get_style_prop(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
 {
-    lv_style_value_t value_act;
-    bool inheritable = lv_style_prop_has_flag(prop, LV_STYLE_PROP_INHERIT);
-    lv_style_res_t found = LV_STYLE_RES_NOT_FOUND;
-    while(obj) {
-        found = get_prop_core(obj, part, prop, &value_act);
-        if(found == LV_STYLE_RES_FOUND) break;
-        if(!inheritable) break;
-
-        /*If not found, check the `MAIN` style first*/
-        if(found != LV_STYLE_RES_INHERIT && part != LV_PART_MAIN) {
-            part = LV_PART_MAIN;
-            continue;
-        }
-
-        /*Check the parent too.*/
-        obj = lv_obj_get_parent(obj);
+#if LV_OBJ_STYLE_CACHE_SIZE
+    style_cache_stats.read_cnt++;
+
+    /*Transitions read the values without the transition style, don't cache them*/
+    uint32_t cache_i = prop < _LV_STYLE_NUM_BUILT_IN_PROPS ? style_cache_index[prop] : 0;
+    if(cache_i && obj && !obj->skip_trans) {
+        cache_i--;
+        style_cache_t * cache = get_style_cache(obj, part);
+        if(cache->valid & (1UL << cache_i)) return cache->values[cache_i];
+
+        style_cache_stats.resolve_cnt++;
+        cache->values[cache_i] = resolve_prop(obj, part, prop);
+        cache->valid |= 1UL << cache_i;
+        return cache->values[cache_i];
     }
 
-    if(found != LV_STYLE_RES_FOUND) {
-        if(part == LV_PART_MAIN && (prop == LV_STYLE_WIDTH || prop == LV_STYLE_HEIGHT)) {
-            const lv_obj_class_t * cls = obj->class_p;
-            while(cls) {
-                if(prop == LV_STYLE_WIDTH) {
-                    if(cls->width_def != 0) break;
-                }
-                else {
-                    if(cls->height_def != 0) break;
-                }
-                cls = cls->base_class;
-            }
-
-            if(cls) {
-                value_act.num = prop == LV_STYLE_WIDTH ? cls->width_def : cls->height_def;
-            }
-            else {
-                value_act.num = 0;
-            }
-        }
-        else {
-            value_act = lv_style_prop_get_default(prop);
-        }
-    }
-    return value_act;
+    style_cache_stats.resolve_cnt++;
+#endif
+    return resolve_prop(obj, part, prop);
 }
 
 void lv_obj_set_local_style_prop(lv_obj_t * obj, lv_style_prop_t prop, lv_style_value_t value,
@@ -321,6 +364,18 @@ bool lv_obj_remove_local_style_prop(lv_obj_t * obj, lv_style_prop_t prop, lv_sty
     return res;
 }
 
+#if LV_OBJ_STYLE_CACHE_SIZE
+void _lv_obj_style_cache_invalidate(void)
+{
+    style_cache_version++;
+}
+
+void lv_obj_get_style_cache_stats(lv_obj_style_cache_stats_t * stats)
+{
+    *stats = style_cache_stats;
+}
+#endif
+
 void _lv_obj_style_create_transition(lv_obj_t * obj, lv_part_t part, lv_state_t prev_state, lv_state_t new_state,
                                      const _lv_obj_style_transition_dsc_t * tr_dsc)
 {
@@ -665,6 +720,89 @@ static lv_style_res_t get_prop_core(const lv_obj_t * obj, lv_part_t part, lv_sty
     else return LV_STYLE_RES_NOT_FOUND;
 }
 
+/**
+ * Get the value of a property from the styles of an object, its parents or the default value
+ * @param obj   pointer to an object
+ * @param part  a part of the object
+ * @param prop  the property to get
+ * @return      the value of the property
+ */
+static lv_style_value_t resolve_prop(const lv_obj_t * obj, lv_part_t part, lv_style_prop_t prop)
+{
+    lv_style_value_t value_act;
+    bool inheritable = lv_style_prop_has_flag(prop, LV_STYLE_PROP_INHERIT);
+    lv_style_res_t found = LV_STYLE_RES_NOT_FOUND;
+    while(obj) {
+        found = get_prop_core(obj, part, prop, &value_act);
+        if(found == LV_STYLE_RES_FOUND) break;
+        if(!inheritable) break;
+
+        /*If not found, check the `MAIN` style first*/
+        if(found != LV_STYLE_RES_INHERIT && part != LV_PART_MAIN) {
+            part = LV_PART_MAIN;
+            continue;
+        }
+
+        /*Check the parent too.*/
+        obj = lv_obj_get_parent(obj);
+    }
+
+    if(found != LV_STYLE_RES_FOUND) {
+        if(part == LV_PART_MAIN && (prop == LV_STYLE_WIDTH || prop == LV_STYLE_HEIGHT)) {
+            const lv_obj_class_t * cls = obj->class_p;
+            while(cls) {
+                if(prop == LV_STYLE_WIDTH) {
+                    if(cls->width_def != 0) break;
+                }
+                else {
+                    if(cls->height_def != 0) break;
+                }
+                cls = cls->base_class;
+            }
+
+            if(cls) {
+                value_act.num = prop == LV_STYLE_WIDTH ? cls->width_def : cls->height_def;
+            }
+            else {
+                value_act.num = 0;
+            }
+        }
+        else {
+            value_act = lv_style_prop_get_default(prop);
+        }
+    }
+    return value_act;
+}
+
+#if LV_OBJ_STYLE_CACHE_SIZE
+/**
+ * Get the cache entry of an object part. The entry is cleared if it belongs to an other object
+ * or the styles changed since it was filled.
+ * @param obj   pointer to an object
+ * @param part  a part of the object
+ * @return      pointer to the cache entry
+ */
+static style_cache_t * get_style_cache(const lv_obj_t * obj, lv_part_t part)
+{
+    /*Objects are at least 8 byte aligned and the parts are in the upper 16 bits*/
+    uint32_t hash = ((uint32_t)((lv_uintptr_t)obj >> 3) + (part >> 16)) * 2654435761U;
+    style_cache_t * cache = &style_cache[(hash >> 16) % LV_OBJ_STYLE_CACHE_SIZE];
+
+    uint32_t style_version = _lv_style_get_version();
+    if(cache->obj != obj || cache->part != part || cache->state != obj->state ||
+       cache->obj_version != style_cache_version || cache->style_version != style_version) {
+        cache->obj = obj;
+        cache->part = part;
+        cache->state = obj->state;
+        cache->obj_version = style_cache_version;
+        cache->style_version = style_version;
+        cache->valid = 0;
+    }
+
+    return cache;
+}
+#endif
+
 /**
  * Refresh the style of all children of an object. (Called recursively)
  * @param style refresh objects only with this
@@ -54,6 +54,13 @@ typedef struct {
 #endif
 } _lv_obj_style_transition_dsc_t;
 
+#if LV_OBJ_STYLE_CACHE_SIZE
+typedef struct {
+    uint32_t read_cnt;      /**< Style property reads by `lv_obj_get_style_prop()`*/
+    uint32_t resolve_cnt;   /**< Reads which were not found in the cache and checked all the styles*/
+} lv_obj_style_cache_stats_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -180,6 +187,20 @@ void _lv_obj_style_create_transition(struct _lv_obj_t * obj, lv_part_t part, lv_
  */
 _lv_style_state_cmp_t _lv_obj_style_state_compare(struct _lv_obj_t * obj, lv_state_t state1, lv_state_t state2);
 
+#if LV_OBJ_STYLE_CACHE_SIZE
+/**
+ * Drop the cached style properties of all objects.
+ * Used internally when a state, the object tree or the styles of an object change.
+ */
+void _lv_obj_style_cache_invalidate(void);
+
+/**
+ * Get the number of style property reads and how many of them were resolved from the styles
+ * @param stats     store the counters here. They are counted since `lv_init()`
+ */
+void lv_obj_get_style_cache_stats(lv_obj_style_cache_stats_t * stats);
+#endif
+
 /**
  * Fade in an an object and all its children.
  * @param obj       the object to fade in
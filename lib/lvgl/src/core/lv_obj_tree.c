@@ -166,6 +166,9 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
     parent->spec_attr->children[lv_obj_get_child_cnt(parent) - 1] = obj;
 
     obj->parent = parent;
+#if LV_OBJ_STYLE_CACHE_SIZE
+    _lv_obj_style_cache_invalidate();   /*Inherited properties come from the new parent*/
+#endif
 
     /*Notify the original parent because one of its children is lost*/
     lv_obj_scrollbar_invalidate(old_parent);
@@ -51,7 +51,7 @@ typedef struct {
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static void lv_refr_join_area(void);
+static uint16_t inv_area_find_join(lv_disp_t * disp, const lv_area_t * area_p, uint32_t * extra_p);
 static void refr_invalid_areas(void);
 static void refr_sync_areas(void);
 static void refr_area(const lv_area_t * area_p);
@@ -144,9 +144,13 @@ void lv_obj_redraw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
     if(should_draw) {
         draw_ctx->clip_area = &clip_coords_for_obj;
 
+#if LV_USE_RETAINED_DRAW
+        _lv_obj_draw_retained(obj, draw_ctx, false);
+#else
         lv_event_send(obj, LV_EVENT_DRAW_MAIN_BEGIN, draw_ctx);
         lv_event_send(obj, LV_EVENT_DRAW_MAIN, draw_ctx);
         lv_event_send(obj, LV_EVENT_DRAW_MAIN_END, draw_ctx);
+#endif
 #if LV_USE_REFR_DEBUG
         lv_color_t debug_color = lv_color_make(lv_rand(0, 0xFF), lv_rand(0, 0xFF), lv_rand(0, 0xFF));
         lv_draw_rect_dsc_t draw_dsc;
@@ -188,9 +192,13 @@ void lv_obj_redraw(lv_draw_ctx_t * draw_ctx, lv_obj_t * obj)
         draw_ctx->clip_area = &clip_coords_for_obj;
 
         /*If all the children are redrawn make 'post draw' draw*/
+#if LV_USE_RETAINED_DRAW
+        _lv_obj_draw_retained(obj, draw_ctx, true);
+#else
         lv_event_send(obj, LV_EVENT_DRAW_POST_BEGIN, draw_ctx);
         lv_event_send(obj, LV_EVENT_DRAW_POST, draw_ctx);
         lv_event_send(obj, LV_EVENT_DRAW_POST_END, draw_ctx);
+#endif
     }
 
     draw_ctx->clip_area = clip_area_ori;
@@ -247,14 +255,20 @@ void _lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
         if(_lv_area_is_in(&com_area, &disp->inv_areas[i], 0) != false) return;
     }
 
-    /*Save the area*/
-    if(disp->inv_p < LV_INV_BUF_SIZE) {
-        lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
-    }
-    else {   /*If no place for the area add the screen*/
-        disp->inv_p = 0;
-        lv_area_copy(&disp->inv_areas[disp->inv_p], &scr_area);
+    /*Join the new area with the saved areas while it makes the refresh cheaper.
+     *If there is no place for the area join it with the one it grows the least.*/
+    while(disp->inv_p > 0) {
+        uint32_t extra;
+        uint16_t join_i = inv_area_find_join(disp, &com_area, &extra);
+        if(extra > LV_INV_AREA_COST && disp->inv_p < LV_INV_BUF_SIZE) break;
+
+        _lv_area_join(&com_area, &com_area, &disp->inv_areas[join_i]);
+        disp->inv_p--;
+        disp->inv_areas[join_i] = disp->inv_areas[disp->inv_p];
     }
+
+    /*Save the area*/
+    lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
     disp->inv_p++;
     if(disp->refr_timer) lv_timer_resume(disp->refr_timer);
 }
@@ -319,7 +333,6 @@ void _lv_disp_refr_timer(lv_timer_t * tmr)
         return;
     }
 
-    lv_refr_join_area();
     refr_sync_areas();
     refr_invalid_areas();
 
@@ -471,40 +484,38 @@ uint32_t lv_refr_get_fps_avg(void)
  **********************/
 
 /**
- * Join the areas which has got common parts
+ * Find the saved area which is the cheapest to join with an area.
+ * Refreshing an area costs its pixels plus `LV_INV_AREA_COST` for drawing the objects on it
+ * and flushing it, so joining two areas pays off if the joined area has at most
+ * `LV_INV_AREA_COST` more pixels than the two areas together.
+ * @param disp      pointer to a display with at least one invalidated area
+ * @param area_p    pointer to the area to join
+ * @param extra_p   store how many more pixels the joined area has than the two areas
+ * @return          index of the area in `disp->inv_areas`
  */
-static void lv_refr_join_area(void)
+static uint16_t inv_area_find_join(lv_disp_t * disp, const lv_area_t * area_p, uint32_t * extra_p)
 {
-    uint32_t join_from;
-    uint32_t join_in;
-    lv_area_t joined_area;
-    for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
-        if(disp_refr->inv_area_joined[join_in] != 0) continue;
-
-        /*Check all areas to join them in 'join_in'*/
-        for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
-            /*Handle only unjoined areas and ignore itself*/
-            if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) {
-                continue;
-            }
-
-            /*Check if the areas are on each other*/
-            if(_lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) == false) {
-                continue;
-            }
-
-            _lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
-
-            /*Join two area only if the joined area size is smaller*/
-            if(lv_area_get_size(&joined_area) < (lv_area_get_size(&disp_refr->inv_areas[join_in]) +
-                                                 lv_area_get_size(&disp_refr->inv_areas[join_from]))) {
-                lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
-
-                /*Mark 'join_form' is joined into 'join_in'*/
-                disp_refr->inv_area_joined[join_from] = 1;
-            }
+    uint32_t area_size = lv_area_get_size(area_p);
+    uint32_t best_extra = UINT32_MAX;
+    uint16_t best_i = 0;
+    uint16_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        lv_area_t joined_area;
+        _lv_area_join(&joined_area, area_p, &disp->inv_areas[i]);
+
+        /*Overlapping areas are drawn twice if kept apart, so they cost no extra to join*/
+        uint32_t apart_size = area_size + lv_area_get_size(&disp->inv_areas[i]);
+        uint32_t joined_size = lv_area_get_size(&joined_area);
+        uint32_t extra = joined_size > apart_size ? joined_size - apart_size : 0;
+        if(extra < best_extra) {
+            best_extra = extra;
+            best_i = i;
+            if(extra == 0) break;
         }
     }
+
+    *extra_p = best_extra;
+    return best_i;
 }
 
 /**
@@ -4,6 +4,7 @@ CSRCS += lv_draw_img.c
 CSRCS += lv_draw_label.c
 CSRCS += lv_draw_line.c
 CSRCS += lv_draw_mask.c
+CSRCS += lv_draw_rec.c
 CSRCS += lv_draw_rect.c
 CSRCS += lv_draw_transform.c
 CSRCS += lv_draw_layer.c
@@ -47,6 +47,9 @@ void lv_draw_arc(lv_draw_ctx_t * draw_ctx, const lv_draw_arc_dsc_t * dsc, const
     if(dsc->opa <= LV_OPA_MIN) return;
     if(dsc->width == 0) return;
     if(start_angle == end_angle) return;
+#if LV_USE_RETAINED_DRAW
+    if(_lv_draw_rec_arc(draw_ctx, dsc, center, radius, start_angle, end_angle)) return;
+#endif
 
     draw_ctx->draw_arc(draw_ctx, dsc, center, radius, start_angle, end_angle);
 
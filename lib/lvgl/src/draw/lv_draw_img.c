@@ -69,6 +69,9 @@ void lv_draw_img(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc, const
     }
 
     if(dsc->opa <= LV_OPA_MIN) return;
+#if LV_USE_RETAINED_DRAW
+    if(_lv_draw_rec_img(draw_ctx, dsc, coords, src)) return;
+#endif
 
     lv_res_t res = LV_RES_INV;
 
@@ -97,6 +97,10 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
     if(txt == NULL || txt[0] == '\0')
         return;
 
+#if LV_USE_RETAINED_DRAW
+    if(_lv_draw_rec_label(draw_ctx, dsc, coords, txt, hint)) return;
+#endif
+
     lv_area_t clipped_area;
     bool clip_ok = _lv_area_intersect(&clipped_area, coords, draw_ctx->clip_area);
     if(!clip_ok) return;
@@ -364,6 +368,9 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_label(lv_draw_ctx_t * draw_ctx, const lv_draw
 void lv_draw_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,  const lv_point_t * pos_p,
                     uint32_t letter)
 {
+#if LV_USE_RETAINED_DRAW
+    if(_lv_draw_rec_letter(draw_ctx, dsc, pos_p, letter)) return;
+#endif
     draw_ctx->draw_letter(draw_ctx, dsc, pos_p, letter);
 }
 
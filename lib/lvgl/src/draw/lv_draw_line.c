@@ -47,6 +47,9 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_line(struct _lv_draw_ctx_t * draw_ctx, const
 {
     if(dsc->width == 0) return;
     if(dsc->opa <= LV_OPA_MIN) return;
+#if LV_USE_RETAINED_DRAW
+    if(_lv_draw_rec_line(draw_ctx, dsc, point1, point2)) return;
+#endif
 
     draw_ctx->draw_line(draw_ctx, dsc, point1, point2);
 }
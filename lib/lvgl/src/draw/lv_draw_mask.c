@@ -80,6 +80,11 @@ static inline lv_opa_t /* LV_ATTRIBUTE_FAST_MEM */ mask_mix(lv_opa_t mask_act, l
  */
 int16_t lv_draw_mask_add(void * param, void * custom_id)
 {
+#if LV_USE_RETAINED_DRAW
+    /*The recorded draw calls couldn't be replayed without the mask*/
+    _lv_draw_rec_abort();
+#endif
+
     /*Look for a free entry*/
     uint8_t i;
     for(i = 0; i < _LV_MASK_MAX_NUM; i++) {
@@ -173,6 +178,10 @@ void * lv_draw_mask_remove_id(int16_t id)
 {
     _lv_draw_mask_common_dsc_t * p = NULL;
 
+#if LV_USE_RETAINED_DRAW
+    _lv_draw_rec_abort();
+#endif
+
     if(id != LV_MASK_ID_INV) {
         p = LV_GC_ROOT(_lv_draw_mask_list[id]).param;
         LV_GC_ROOT(_lv_draw_mask_list[id]).param = NULL;
@@ -0,0 +1,324 @@
+/**
+ * @file lv_draw_rec.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw.h"
+#include "lv_draw_rec.h"
+#include "../misc/lv_mem.h"
+#include <string.h>
+
+#if LV_USE_RETAINED_DRAW
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Keep the commands aligned for the pointers in the descriptors*/
+#define CMD_ALIGN(size) (((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    CMD_RECT,
+    CMD_LABEL,
+    CMD_LETTER,
+    CMD_IMG,
+    CMD_LINE,
+    CMD_ARC,
+    CMD_POLYGON,
+} cmd_type_t;
+
+typedef struct {
+    uint16_t type;
+    uint16_t size;          /*Size of the command in bytes, including this header*/
+    lv_area_t clip_area;    /*Clip area at the draw call*/
+} cmd_t;
+
+typedef struct {
+    cmd_t cmd;
+    lv_draw_rect_dsc_t dsc;
+    lv_area_t coords;
+} cmd_rect_t;
+
+typedef struct {
+    cmd_t cmd;
+    lv_draw_label_dsc_t dsc;
+    lv_area_t coords;
+    lv_draw_label_hint_t * hint;
+    char txt[];
+} cmd_label_t;
+
+typedef struct {
+    cmd_t cmd;
+    lv_draw_label_dsc_t dsc;
+    lv_point_t pos;
+    uint32_t letter;
+} cmd_letter_t;
+
+typedef struct {
+    cmd_t cmd;
+    lv_draw_img_dsc_t dsc;
+    lv_area_t coords;
+    const void * src;
+} cmd_img_t;
+
+typedef struct {
+    cmd_t cmd;
+    lv_draw_line_dsc_t dsc;
+    lv_point_t point1;
+    lv_point_t point2;
+} cmd_line_t;
+
+typedef struct {
+    cmd_t cmd;
+    lv_draw_arc_dsc_t dsc;
+    lv_point_t center;
+    uint16_t radius;
+    uint16_t start_angle;
+    uint16_t end_angle;
+} cmd_arc_t;
+
+typedef struct {
+    cmd_t cmd;
+    lv_draw_rect_dsc_t dsc;
+    uint16_t point_cnt;
+    lv_point_t points[];
+} cmd_polygon_t;
+
+typedef struct {
+    lv_draw_ctx_t * draw_ctx;   /*NULL if not recording*/
+    uint8_t * buf;
+    uint32_t buf_size;
+    uint32_t size;
+    lv_area_t clip_area;        /*Clip area when the recording was started*/
+    bool aborted;
+} recorder_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void * add_cmd(lv_draw_ctx_t * draw_ctx, cmd_type_t type, uint32_t size);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static recorder_t rec;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_draw_rec_start(lv_draw_ctx_t * draw_ctx, void * buf, uint32_t buf_size)
+{
+    LV_ASSERT_MSG(rec.draw_ctx == NULL, "Already recording");
+
+    rec.draw_ctx = draw_ctx;
+    rec.buf = buf;
+    rec.buf_size = buf_size;
+    rec.size = 0;
+    rec.clip_area = *draw_ctx->clip_area;
+    rec.aborted = false;
+}
+
+bool lv_draw_rec_stop(uint32_t * size)
+{
+    rec.draw_ctx = NULL;
+    *size = rec.size;
+    return !rec.aborted;
+}
+
+void lv_draw_rec_replay(lv_draw_ctx_t * draw_ctx, const void * buf, uint32_t size)
+{
+    const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+    lv_area_t clip_area;
+    const uint8_t * p = buf;
+    const uint8_t * end = p + size;
+    while(p < end) {
+        const cmd_t * cmd = (const cmd_t *)p;
+        p += cmd->size;
+
+        if(!_lv_area_intersect(&clip_area, &cmd->clip_area, clip_area_ori)) continue;
+        draw_ctx->clip_area = &clip_area;
+
+        switch(cmd->type) {
+            case CMD_RECT: {
+                    const cmd_rect_t * c = (const cmd_rect_t *)cmd;
+                    lv_draw_rect(draw_ctx, &c->dsc, &c->coords);
+                    break;
+                }
+            case CMD_LABEL: {
+                    const cmd_label_t * c = (const cmd_label_t *)cmd;
+                    lv_draw_label(draw_ctx, &c->dsc, &c->coords, c->txt, c->hint);
+                    break;
+                }
+            case CMD_LETTER: {
+                    const cmd_letter_t * c = (const cmd_letter_t *)cmd;
+                    lv_draw_letter(draw_ctx, &c->dsc, &c->pos, c->letter);
+                    break;
+                }
+            case CMD_IMG: {
+                    const cmd_img_t * c = (const cmd_img_t *)cmd;
+                    lv_draw_img(draw_ctx, &c->dsc, &c->coords, c->src);
+                    break;
+                }
+            case CMD_LINE: {
+                    const cmd_line_t * c = (const cmd_line_t *)cmd;
+                    lv_draw_line(draw_ctx, &c->dsc, &c->point1, &c->point2);
+                    break;
+                }
+            case CMD_ARC: {
+                    const cmd_arc_t * c = (const cmd_arc_t *)cmd;
+                    lv_draw_arc(draw_ctx, &c->dsc, &c->center, c->radius, c->start_angle, c->end_angle);
+                    break;
+                }
+            case CMD_POLYGON: {
+                    const cmd_polygon_t * c = (const cmd_polygon_t *)cmd;
+                    lv_draw_polygon(draw_ctx, &c->dsc, c->points, c->point_cnt);
+                    break;
+                }
+        }
+    }
+
+    draw_ctx->clip_area = clip_area_ori;
+}
+
+void _lv_draw_rec_abort(void)
+{
+    lv_draw_ctx_t * draw_ctx = rec.draw_ctx;
+    if(draw_ctx == NULL) return;
+
+    /*Stop first to really draw the calls recorded so far*/
+    rec.draw_ctx = NULL;
+    rec.aborted = true;
+
+    const lv_area_t * clip_area_ori = draw_ctx->clip_area;
+    draw_ctx->clip_area = &rec.clip_area;
+    lv_draw_rec_replay(draw_ctx, rec.buf, rec.size);
+    draw_ctx->clip_area = clip_area_ori;
+}
+
+bool _lv_draw_rec_rect(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
+{
+    cmd_rect_t * c = add_cmd(draw_ctx, CMD_RECT, sizeof(cmd_rect_t));
+    if(c == NULL) return false;
+
+    c->dsc = *dsc;
+    c->coords = *coords;
+    return true;
+}
+
+bool _lv_draw_rec_label(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_area_t * coords,
+                        const char * txt, lv_draw_label_hint_t * hint)
+{
+    /*Copy the text because it might be in a temporary buffer*/
+    uint32_t txt_size = strlen(txt) + 1;
+    cmd_label_t * c = add_cmd(draw_ctx, CMD_LABEL, sizeof(cmd_label_t) + txt_size);
+    if(c == NULL) return false;
+
+    c->dsc = *dsc;
+    c->coords = *coords;
+    c->hint = hint;
+    lv_memcpy(c->txt, txt, txt_size);
+    return true;
+}
+
+bool _lv_draw_rec_letter(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos_p,
+                         uint32_t letter)
+{
+    cmd_letter_t * c = add_cmd(draw_ctx, CMD_LETTER, sizeof(cmd_letter_t));
+    if(c == NULL) return false;
+
+    c->dsc = *dsc;
+    c->pos = *pos_p;
+    c->letter = letter;
+    return true;
+}
+
+bool _lv_draw_rec_img(lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc, const lv_area_t * coords,
+                      const void * src)
+{
+    cmd_img_t * c = add_cmd(draw_ctx, CMD_IMG, sizeof(cmd_img_t));
+    if(c == NULL) return false;
+
+    c->dsc = *dsc;
+    c->coords = *coords;
+    c->src = src;
+    return true;
+}
+
+bool _lv_draw_rec_line(lv_draw_ctx_t * draw_ctx, const lv_draw_line_dsc_t * dsc, const lv_point_t * point1,
+                       const lv_point_t * point2)
+{
+    cmd_line_t * c = add_cmd(draw_ctx, CMD_LINE, sizeof(cmd_line_t));
+    if(c == NULL) return false;
+
+    c->dsc = *dsc;
+    c->point1 = *point1;
+    c->point2 = *point2;
+    return true;
+}
+
+bool _lv_draw_rec_arc(lv_draw_ctx_t * draw_ctx, const lv_draw_arc_dsc_t * dsc, const lv_point_t * center,
+                      uint16_t radius, uint16_t start_angle, uint16_t end_angle)
+{
+    cmd_arc_t * c = add_cmd(draw_ctx, CMD_ARC, sizeof(cmd_arc_t));
+    if(c == NULL) return false;
+
+    c->dsc = *dsc;
+    c->center = *center;
+    c->radius = radius;
+    c->start_angle = start_angle;
+    c->end_angle = end_angle;
+    return true;
+}
+
+bool _lv_draw_rec_polygon(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_point_t points[],
+                          uint16_t point_cnt)
+{
+    cmd_polygon_t * c = add_cmd(draw_ctx, CMD_POLYGON, sizeof(cmd_polygon_t) + point_cnt * sizeof(lv_point_t));
+    if(c == NULL) return false;
+
+    c->dsc = *dsc;
+    c->point_cnt = point_cnt;
+    lv_memcpy(c->points, points, point_cnt * sizeof(lv_point_t));
+    return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Allocate a command in the recording buffer
+ * @param draw_ctx  draw context of the draw call
+ * @param type      type of the command
+ * @param size      size of the command in bytes
+ * @return          the new command with its header filled, or NULL if the call needs to be drawn now
+ */
+static void * add_cmd(lv_draw_ctx_t * draw_ctx, cmd_type_t type, uint32_t size)
+{
+    if(rec.draw_ctx == NULL || rec.draw_ctx != draw_ctx) return NULL;
+
+    size = CMD_ALIGN(size);
+    if(rec.size + size > rec.buf_size || size > UINT16_MAX) {
+        _lv_draw_rec_abort();
+        return NULL;
+    }
+
+    cmd_t * cmd = (cmd_t *)(rec.buf + rec.size);
+    cmd->type = type;
+    cmd->size = size;
+    cmd->clip_area = *draw_ctx->clip_area;
+    rec.size += size;
+    return cmd;
+}
+
+#endif /*LV_USE_RETAINED_DRAW*/
@@ -0,0 +1,102 @@
+/**
+ * @file lv_draw_rec.h
+ *
+ */
+
+#ifndef LV_DRAW_REC_H
+#define LV_DRAW_REC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#if LV_USE_RETAINED_DRAW
+
+#include "lv_draw_rect.h"
+#include "lv_draw_label.h"
+#include "lv_draw_img.h"
+#include "lv_draw_line.h"
+#include "lv_draw_arc.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+struct _lv_draw_ctx_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start recording the draw calls made with a draw context.
+ * While recording `lv_draw_rect()`, `lv_draw_label()`, etc. only store their parameters and don't draw.
+ * @param draw_ctx  record the draw calls of this draw context. Calls with other draw contexts are drawn as usual.
+ * @param buf       buffer to store the recorded draw calls
+ * @param buf_size  size of `buf` in bytes
+ */
+void lv_draw_rec_start(struct _lv_draw_ctx_t * draw_ctx, void * buf, uint32_t buf_size);
+
+/**
+ * Stop recording.
+ * @param size      store the number of bytes used in the buffer here
+ * @return          true: the draw calls are recorded, they still need to be replayed to get drawn;
+ *                  false: the recording was aborted and everything is already drawn
+ */
+bool lv_draw_rec_stop(uint32_t * size);
+
+/**
+ * Draw the recorded draw calls again.
+ * @param draw_ctx  pointer to a draw context. The draw calls are clipped to its current clip area too.
+ * @param buf       recorded draw calls
+ * @param size      size of the recorded draw calls in bytes
+ */
+void lv_draw_rec_replay(struct _lv_draw_ctx_t * draw_ctx, const void * buf, uint32_t size);
+
+/**
+ * Draw what is recorded so far and continue without recording.
+ * Called when something happens that can't be replayed, e.g. a mask is added.
+ */
+void _lv_draw_rec_abort(void);
+
+/*Record a draw call if recording is in progress. Return true if the call was recorded and mustn't be drawn now*/
+bool _lv_draw_rec_rect(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords);
+
+bool _lv_draw_rec_label(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_area_t * coords,
+                        const char * txt, lv_draw_label_hint_t * hint);
+
+bool _lv_draw_rec_letter(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos_p,
+                         uint32_t letter);
+
+bool _lv_draw_rec_img(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_img_dsc_t * dsc, const lv_area_t * coords,
+                      const void * src);
+
+bool _lv_draw_rec_line(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_line_dsc_t * dsc, const lv_point_t * point1,
+                       const lv_point_t * point2);
+
+bool _lv_draw_rec_arc(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_arc_dsc_t * dsc, const lv_point_t * center,
+                      uint16_t radius, uint16_t start_angle, uint16_t end_angle);
+
+bool _lv_draw_rec_polygon(struct _lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_point_t points[],
+                          uint16_t point_cnt);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_RETAINED_DRAW*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_REC_H*/
@@ -62,6 +62,9 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_rect_dsc_init(lv_draw_rect_dsc_t * dsc)
 void lv_draw_rect(lv_draw_ctx_t * draw_ctx, const lv_draw_rect_dsc_t * dsc, const lv_area_t * coords)
 {
     if(lv_area_get_height(coords) < 1 || lv_area_get_width(coords) < 1) return;
+#if LV_USE_RETAINED_DRAW
+    if(_lv_draw_rec_rect(draw_ctx, dsc, coords)) return;
+#endif
 
     draw_ctx->draw_rect(draw_ctx, dsc, coords);
 
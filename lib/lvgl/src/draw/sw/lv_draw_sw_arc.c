@@ -17,6 +17,7 @@
  *********************/
 #define SPLIT_RADIUS_LIMIT 10  /*With radius greater than this the arc will drawn in quarters. A quarter is drawn only if there is arc in it*/
 #define SPLIT_ANGLE_GAP_LIMIT 60  /*With small gaps in the arc don't bother with splitting because there is nothing to skip.*/
+#define ANGLE_MASK_MARGIN 2  /*Pixels farther than this from the lines of the angle mask are not affected by its anti-aliasing*/
 
 /**********************
  *      TYPEDEFS
@@ -29,6 +30,8 @@ typedef struct {
     uint16_t start_quarter;
     uint16_t end_quarter;
     lv_coord_t width;
+    lv_coord_t radius_in;
+    int16_t mask_angle_id;
     lv_draw_rect_dsc_t * draw_dsc;
     const lv_area_t * draw_area;
     lv_draw_ctx_t * draw_ctx;
@@ -42,6 +45,7 @@ typedef struct {
     static void draw_quarter_1(quarter_draw_dsc_t * q);
     static void draw_quarter_2(quarter_draw_dsc_t * q);
     static void draw_quarter_3(quarter_draw_dsc_t * q);
+    static void draw_full_quarter(quarter_draw_dsc_t * q, uint8_t quarter);
     static void get_rounded_area(int16_t angle, lv_coord_t radius, uint8_t thickness, lv_area_t * res_area);
 #endif /*LV_DRAW_COMPLEX*/
 
@@ -151,6 +155,8 @@ void lv_draw_sw_arc(lv_draw_ctx_t * draw_ctx, const lv_draw_arc_dsc_t * dsc, con
         q_dsc.start_quarter = (start_angle / 90) & 0x3;
         q_dsc.end_quarter = (end_angle / 90) & 0x3;
         q_dsc.width = width;
+        q_dsc.radius_in = radius - dsc->width;
+        q_dsc.mask_angle_id = mask_angle_id;
         q_dsc.draw_dsc = &cir_dsc;
         q_dsc.draw_area = &area_out;
         q_dsc.draw_ctx = draw_ctx;
@@ -159,6 +165,9 @@ void lv_draw_sw_arc(lv_draw_ctx_t * draw_ctx, const lv_draw_arc_dsc_t * dsc, con
         draw_quarter_1(&q_dsc);
         draw_quarter_2(&q_dsc);
         draw_quarter_3(&q_dsc);
+
+        /*The angle mask might be added again while drawing the quarters*/
+        mask_angle_id = q_dsc.mask_angle_id;
     }
     else {
         lv_draw_rect(draw_ctx, &cir_dsc, &area_out);
@@ -288,7 +297,7 @@ static void draw_quarter_0(quarter_draw_dsc_t * q)
         bool ok = _lv_area_intersect(&quarter_area, &quarter_area, clip_area_ori);
         if(ok) {
             q->draw_ctx->clip_area = &quarter_area;
-            lv_draw_rect(q->draw_ctx, q->draw_dsc, q->draw_area);
+            draw_full_quarter(q, 0);
         }
     }
     q->draw_ctx->clip_area = clip_area_ori;
@@ -355,7 +364,7 @@ static void draw_quarter_1(quarter_draw_dsc_t * q)
         bool ok = _lv_area_intersect(&quarter_area, &quarter_area, clip_area_ori);
         if(ok) {
             q->draw_ctx->clip_area = &quarter_area;
-            lv_draw_rect(q->draw_ctx, q->draw_dsc, q->draw_area);
+            draw_full_quarter(q, 1);
         }
     }
     q->draw_ctx->clip_area = clip_area_ori;
@@ -422,7 +431,7 @@ static void draw_quarter_2(quarter_draw_dsc_t * q)
         bool ok = _lv_area_intersect(&quarter_area, &quarter_area, clip_area_ori);
         if(ok) {
             q->draw_ctx->clip_area = &quarter_area;
-            lv_draw_rect(q->draw_ctx, q->draw_dsc, q->draw_area);
+            draw_full_quarter(q, 2);
         }
     }
     q->draw_ctx->clip_area = clip_area_ori;
@@ -489,13 +498,48 @@ static void draw_quarter_3(quarter_draw_dsc_t * q)
         bool ok = _lv_area_intersect(&quarter_area, &quarter_area, clip_area_ori);
         if(ok) {
             q->draw_ctx->clip_area = &quarter_area;
-            lv_draw_rect(q->draw_ctx, q->draw_dsc, q->draw_area);
+            draw_full_quarter(q, 3);
         }
     }
 
     q->draw_ctx->clip_area = clip_area_ori;
 }
 
+/**
+ * Draw a quarter which is fully inside the arc. If the lines of the angle mask are far enough from
+ * the visible part of the quarter the angle mask can't change anything there so it's removed while drawing.
+ */
+static void draw_full_quarter(quarter_draw_dsc_t * q, uint8_t quarter)
+{
+    /*The mask list is processed until the first empty slot so only the last mask can be removed*/
+    bool skip_angle = q->mask_angle_id != LV_MASK_ID_INV && q->radius_in > ANGLE_MASK_MARGIN &&
+                      lv_draw_mask_get_cnt() == q->mask_angle_id + 1;
+
+    if(skip_angle) {
+        /*The smallest angle between the quarter and the lines (both directions) of the angle mask*/
+        uint16_t angles[2] = {q->start_angle, q->end_angle};
+        int32_t dist_min = 45;
+        uint32_t i;
+        for(i = 0; i < 2; i++) {
+            int32_t rel = (angles[i] + 360 - quarter * 90) % 180;
+            int32_t dist = rel <= 90 ? 0 : LV_MIN(rel - 90, 180 - rel);
+            dist_min = LV_MIN(dist_min, dist);
+        }
+
+        lv_coord_t line_dist = ((q->radius_in - ANGLE_MASK_MARGIN) * lv_trigo_sin(dist_min)) >> LV_TRIGO_SHIFT;
+        if(line_dist < ANGLE_MASK_MARGIN) skip_angle = false;
+    }
+
+    if(skip_angle) {
+        void * angle_param = lv_draw_mask_remove_id(q->mask_angle_id);
+        lv_draw_rect(q->draw_ctx, q->draw_dsc, q->draw_area);
+        q->mask_angle_id = lv_draw_mask_add(angle_param, NULL);
+    }
+    else {
+        lv_draw_rect(q->draw_ctx, q->draw_dsc, q->draw_area);
+    }
+}
+
 static void get_rounded_area(int16_t angle, lv_coord_t radius, uint8_t thickness, lv_area_t * res_area)
 {
     const uint8_t ps = 8;
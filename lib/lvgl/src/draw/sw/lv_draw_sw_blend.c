@@ -14,6 +14,15 @@
 /*********************
  *      DEFINES
  *********************/
+/*With RGB565 the masked and semi-transparent kernels use the same 32 bit mixing as `lv_color_mix()`
+ *but spread the fill color and calculate the mix ratio only once per area/mask value.*/
+#if LV_COLOR_DEPTH == 16 && LV_COLOR_MIX_ROUND_OFS == 0
+    #define BLEND_565   1
+#else
+    #define BLEND_565   0
+#endif
+
+#define RGB565_SPREAD_MASK  0x07E0F81F   /*0b00000111111000001111100000011111*/
 
 /**********************
  *      TYPEDEFS
@@ -68,6 +77,16 @@ static inline lv_color_t color_blend_true_color_subtractive(lv_color_t fg, lv_co
 static inline lv_color_t color_blend_true_color_multiply(lv_color_t fg, lv_color_t bg, lv_opa_t opa);
 #endif /*LV_DRAW_COMPLEX*/
 
+#if BLEND_565
+static void fill_normal_mask_565(lv_color_t * dest_buf, int32_t w, int32_t h, lv_coord_t dest_stride,
+                                 lv_color_t color, lv_opa_t opa, const lv_opa_t * mask, lv_coord_t mask_stride);
+static void map_normal_mask_565(lv_color_t * dest_buf, int32_t w, int32_t h, lv_coord_t dest_stride,
+                                const lv_color_t * src_buf, lv_coord_t src_stride, lv_opa_t opa,
+                                const lv_opa_t * mask, lv_coord_t mask_stride);
+static inline uint32_t rgb565_spread(lv_color_t c);
+static inline lv_color_t rgb565_mix(uint32_t fg32, lv_color_t bg, uint32_t mix);
+#endif /*BLEND_565*/
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -288,6 +307,9 @@ static LV_ATTRIBUTE_FAST_MEM void fill_normal(lv_color_t * dest_buf, const lv_ar
     }
     /*Masked*/
     else {
+#if BLEND_565
+        fill_normal_mask_565(dest_buf, w, h, dest_stride, color, opa, mask, mask_stride);
+#else
 #if LV_COLOR_DEPTH == 16
         uint32_t c32 = color.full + ((uint32_t)color.full << 16);
 #endif
@@ -371,6 +393,7 @@ static LV_ATTRIBUTE_FAST_MEM void fill_normal(lv_color_t * dest_buf, const lv_ar
                 mask += (mask_stride - w);
             }
         }
+#endif /*BLEND_565*/
     }
 }
 
@@ -671,6 +694,9 @@ static void LV_ATTRIBUTE_FAST_MEM map_normal(lv_color_t * dest_buf, const lv_are
     }
     /*Masked*/
     else {
+#if BLEND_565
+        map_normal_mask_565(dest_buf, w, h, dest_stride, src_buf, src_stride, opa, mask, mask_stride);
+#else
         /*Only the mask matters*/
         if(opa > LV_OPA_MAX) {
             int32_t x_end4 = w - 4;
@@ -730,8 +756,181 @@ static void LV_ATTRIBUTE_FAST_MEM map_normal(lv_color_t * dest_buf, const lv_are
                 mask += mask_stride;
             }
         }
+#endif /*BLEND_565*/
+    }
+}
+
+#if BLEND_565
+/**
+ * Fill an RGB565 area with a color using a mask.
+ * Gives the same result as the generic `fill_normal()` but the mask is processed in 32 bit words
+ * to skip the transparent and handle the fully covered parts quickly.
+ */
+static void LV_ATTRIBUTE_FAST_MEM fill_normal_mask_565(lv_color_t * dest_buf, int32_t w, int32_t h,
+                                                       lv_coord_t dest_stride, lv_color_t color, lv_opa_t opa,
+                                                       const lv_opa_t * mask, lv_coord_t mask_stride)
+{
+    uint32_t color32 = rgb565_spread(color);
+    uint32_t c32 = color.full + ((uint32_t)color.full << 16);
+    bool opa_cover = opa >= LV_OPA_MAX;
+    uint32_t opa_mix = ((uint32_t)opa + 4) >> 3;
+
+    /*Mix ratio of a mask value. With `opa_cover` only the mask matters.*/
+#define FILL_565_PX(x)                                                                              \
+    if(mask[x]) {                                                                                   \
+        lv_opa_t m = mask[x];                                                                       \
+        if(m == LV_OPA_COVER) m = opa_cover ? LV_OPA_COVER : opa;                                   \
+        else if(!opa_cover) m = (uint32_t)((uint32_t)m * opa) >> 8;                                 \
+        dest_buf[x] = m == LV_OPA_COVER ? color : rgb565_mix(color32, dest_buf[x], ((uint32_t)m + 4) >> 3); \
     }
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x < w && ((lv_uintptr_t)&mask[x] & 0x3); x++) {
+            FILL_565_PX(x)
+        }
+
+        for(; x <= w - 4; x += 4) {
+            uint32_t mask32 = *((const uint32_t *)&mask[x]);
+            if(mask32 == 0) continue;
+
+            if(mask32 == 0xFFFFFFFF) {
+                if(opa_cover) {
+                    if((lv_uintptr_t)&dest_buf[x] & 0x3) {
+                        dest_buf[x] = color;
+                        *((uint32_t *)&dest_buf[x + 1]) = c32;
+                        dest_buf[x + 3] = color;
+                    }
+                    else {
+                        *((uint32_t *)&dest_buf[x]) = c32;
+                        *((uint32_t *)&dest_buf[x + 2]) = c32;
+                    }
+                }
+                else {
+                    dest_buf[x] = rgb565_mix(color32, dest_buf[x], opa_mix);
+                    dest_buf[x + 1] = rgb565_mix(color32, dest_buf[x + 1], opa_mix);
+                    dest_buf[x + 2] = rgb565_mix(color32, dest_buf[x + 2], opa_mix);
+                    dest_buf[x + 3] = rgb565_mix(color32, dest_buf[x + 3], opa_mix);
+                }
+            }
+            else {
+                FILL_565_PX(x)
+                FILL_565_PX(x + 1)
+                FILL_565_PX(x + 2)
+                FILL_565_PX(x + 3)
+            }
+        }
+
+        for(; x < w; x++) {
+            FILL_565_PX(x)
+        }
+
+        dest_buf += dest_stride;
+        mask += mask_stride;
+    }
+#undef FILL_565_PX
+}
+
+/**
+ * Blend an RGB565 image using a mask.
+ * Gives the same result as the generic `map_normal()` but the mask is processed in 32 bit words
+ * to skip the transparent and handle the fully covered parts quickly.
+ */
+static void LV_ATTRIBUTE_FAST_MEM map_normal_mask_565(lv_color_t * dest_buf, int32_t w, int32_t h,
+                                                      lv_coord_t dest_stride, const lv_color_t * src_buf,
+                                                      lv_coord_t src_stride, lv_opa_t opa,
+                                                      const lv_opa_t * mask, lv_coord_t mask_stride)
+{
+    bool opa_cover = opa > LV_OPA_MAX;
+    uint32_t opa_mix = ((uint32_t)opa + 4) >> 3;
+
+#define MAP_565_PX(x)                                                                               \
+    if(mask[x]) {                                                                                   \
+        lv_opa_t m = mask[x];                                                                       \
+        if(!opa_cover) m = m >= LV_OPA_MAX ? opa : (uint32_t)((uint32_t)m * opa) >> 8;              \
+        dest_buf[x] = m == LV_OPA_COVER ? src_buf[x] :                                              \
+                      rgb565_mix(rgb565_spread(src_buf[x]), dest_buf[x], ((uint32_t)m + 4) >> 3);   \
+    }
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x < w && ((lv_uintptr_t)&mask[x] & 0x3); x++) {
+            MAP_565_PX(x)
+        }
+
+        for(; x <= w - 4; x += 4) {
+            uint32_t mask32 = *((const uint32_t *)&mask[x]);
+            if(mask32 == 0) continue;
+
+            if(mask32 == 0xFFFFFFFF) {
+                if(opa_cover) {
+                    dest_buf[x] = src_buf[x];
+                    dest_buf[x + 1] = src_buf[x + 1];
+                    dest_buf[x + 2] = src_buf[x + 2];
+                    dest_buf[x + 3] = src_buf[x + 3];
+                }
+                else {
+                    dest_buf[x] = rgb565_mix(rgb565_spread(src_buf[x]), dest_buf[x], opa_mix);
+                    dest_buf[x + 1] = rgb565_mix(rgb565_spread(src_buf[x + 1]), dest_buf[x + 1], opa_mix);
+                    dest_buf[x + 2] = rgb565_mix(rgb565_spread(src_buf[x + 2]), dest_buf[x + 2], opa_mix);
+                    dest_buf[x + 3] = rgb565_mix(rgb565_spread(src_buf[x + 3]), dest_buf[x + 3], opa_mix);
+                }
+            }
+            else {
+                MAP_565_PX(x)
+                MAP_565_PX(x + 1)
+                MAP_565_PX(x + 2)
+                MAP_565_PX(x + 3)
+            }
+        }
+
+        for(; x < w; x++) {
+            MAP_565_PX(x)
+        }
+
+        dest_buf += dest_stride;
+        src_buf += src_stride;
+        mask += mask_stride;
+    }
+#undef MAP_565_PX
+}
+
+/**
+ * Move the green channel of an RGB565 color to the upper half-word
+ * to leave room for the multiplication in `rgb565_mix()`.
+ */
+static inline uint32_t rgb565_spread(lv_color_t c)
+{
+#if LV_COLOR_16_SWAP == 1
+    uint32_t c32 = (uint16_t)(c.full << 8 | c.full >> 8);
+#else
+    uint32_t c32 = c.full;
+#endif
+    return (c32 | (c32 << 16)) & RGB565_SPREAD_MASK;
+}
+
+/**
+ * Mix a spread foreground color to a background color. Same as `lv_color_mix()`.
+ * @param fg32      the foreground color prepared by `rgb565_spread()`
+ * @param bg        the background color
+ * @param mix       the ratio of the foreground in [0..32] range. `(opa + 4) >> 3` gives the same result as `lv_color_mix()`
+ * @return          the mixed color
+ */
+static inline lv_color_t rgb565_mix(uint32_t fg32, lv_color_t bg, uint32_t mix)
+{
+    uint32_t bg32 = rgb565_spread(bg);
+    uint32_t res = ((((fg32 - bg32) * mix) >> 5) + bg32) & RGB565_SPREAD_MASK;
+
+    lv_color_t ret;
+    ret.full = (uint16_t)((res >> 16) | res);
+#if LV_COLOR_16_SWAP == 1
+    ret.full = ret.full << 8 | ret.full >> 8;
+#endif
+    return ret;
 }
+#endif /*BLEND_565*/
 
 #if LV_COLOR_SCREEN_TRANSP
 static void LV_ATTRIBUTE_FAST_MEM map_argb(lv_color_t * dest_buf, const lv_area_t * dest_area,
@@ -23,12 +23,25 @@
  *      TYPEDEFS
  **********************/
 
+/*The colors of an opaque letter mixed to a given background color, indexed by the pixel opacity.
+ *The entries are calculated on first use.*/
+typedef struct {
+    lv_color_t fg;
+    lv_color_t bg;
+    uint32_t valid[256 / 32];
+    lv_color_t color[256];
+} color_ramp_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 
 static void /* LV_ATTRIBUTE_FAST_MEM */ draw_letter_normal(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc,
                                                            const lv_point_t * pos, lv_font_glyph_dsc_t * g, const uint8_t * map_p);
+static void /* LV_ATTRIBUTE_FAST_MEM */ draw_letter_direct(lv_draw_ctx_t * draw_ctx, lv_color_t color,
+                                                           const lv_area_t * fill_area, const uint8_t * map_p, uint32_t bpp, uint32_t col_bit,
+                                                           uint32_t col_bit_row_ofs, const uint8_t * bpp_opa_table_p);
+static inline lv_color_t ramp_get_color(lv_color_t bg, lv_opa_t opa);
 
 #if LV_DRAW_COMPLEX && LV_USE_FONT_SUBPX
 static void draw_letter_subpx(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos,
@@ -38,6 +51,7 @@ static void draw_letter_subpx(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_
 /**********************
  *  STATIC VARIABLES
  **********************/
+static color_ramp_t ramp;
 
 /**********************
  *  GLOBAL VARIABLES
@@ -251,18 +265,6 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_normal(lv_draw_ctx_t * draw_ctx, c
     uint32_t col_bit;
     col_bit = bit_ofs & 0x7; /*"& 0x7" equals to "% 8" just faster*/
 
-    lv_draw_sw_blend_dsc_t blend_dsc;
-    lv_memset_00(&blend_dsc, sizeof(blend_dsc));
-    blend_dsc.color = dsc->color;
-    blend_dsc.opa = dsc->opa;
-    blend_dsc.blend_mode = dsc->blend_mode;
-
-    lv_coord_t hor_res = lv_disp_get_hor_res(_lv_refr_get_disp_refreshing());
-    uint32_t mask_buf_size = box_w * box_h > hor_res ? hor_res : box_w * box_h;
-    lv_opa_t * mask_buf = lv_mem_buf_get(mask_buf_size);
-    blend_dsc.mask_buf = mask_buf;
-    int32_t mask_p = 0;
-
     lv_area_t fill_area;
     fill_area.x1 = col_start + pos->x;
     fill_area.x2 = col_end  + pos->x - 1;
@@ -274,13 +276,42 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_normal(lv_draw_ctx_t * draw_ctx, c
     lv_area_copy(&mask_area, &fill_area);
     mask_area.y2 = mask_area.y1 + row_end;
     bool mask_any = lv_draw_mask_is_any(&mask_area);
+#else
+    bool mask_any = false;
 #endif
-    blend_dsc.blend_area = &fill_area;
-    blend_dsc.mask_area = &fill_area;
 
     uint32_t col_bit_max = 8 - bpp;
     uint32_t col_bit_row_ofs = (box_w + col_start - col_end) * bpp;
 
+    /*Opaque A4 and A8 letters without masks can be blended directly into the draw buffer
+     *if the blending is not redirected (GPU, `set_px_cb`, transparent screen).
+     *The checks are done for each letter, they are cheap compared to the pixels
+     *(~25 ns vs. ~110 ns for a 14 px letter on a PC) so the letters of a label are not batched.*/
+    lv_disp_t * disp = _lv_refr_get_disp_refreshing();
+    if(opa >= LV_OPA_MAX && (g->bpp == 4 || g->bpp == 8) && !mask_any &&
+       dsc->blend_mode == LV_BLEND_MODE_NORMAL &&
+       ((lv_draw_sw_ctx_t *)draw_ctx)->blend == lv_draw_sw_blend_basic &&
+       disp->driver->set_px_cb == NULL && disp->driver->screen_transp == 0 && disp->driver->antialiasing) {
+        fill_area.y2 = row_end + pos->y - 1;
+        if(draw_ctx->wait_for_finish) draw_ctx->wait_for_finish(draw_ctx);
+        draw_letter_direct(draw_ctx, dsc->color, &fill_area, map_p, bpp, col_bit, col_bit_row_ofs, bpp_opa_table_p);
+        return;
+    }
+
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memset_00(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.color = dsc->color;
+    blend_dsc.opa = dsc->opa;
+    blend_dsc.blend_mode = dsc->blend_mode;
+
+    lv_coord_t hor_res = lv_disp_get_hor_res(disp);
+    uint32_t mask_buf_size = box_w * box_h > hor_res ? hor_res : box_w * box_h;
+    lv_opa_t * mask_buf = lv_mem_buf_get(mask_buf_size);
+    blend_dsc.mask_buf = mask_buf;
+    int32_t mask_p = 0;
+    blend_dsc.blend_area = &fill_area;
+    blend_dsc.mask_area = &fill_area;
+
     for(row = row_start ; row < row_end; row++) {
 #if LV_DRAW_COMPLEX
         int32_t mask_p_start = mask_p;
@@ -350,6 +381,80 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_normal(lv_draw_ctx_t * draw_ctx, c
     lv_mem_buf_release(mask_buf);
 }
 
+/**
+ * Blend the pixels of an A4 or A8 letter into the draw buffer without building a mask.
+ * @param fill_area the area of the letter to draw, already clipped to the clip area
+ * @param map_p the first pixel of `fill_area` in the letter's bitmap
+ * @param col_bit the bit offset of the first pixel in `map_p`
+ * @param col_bit_row_ofs bits to skip in the bitmap at the end of each row
+ */
+static void LV_ATTRIBUTE_FAST_MEM draw_letter_direct(lv_draw_ctx_t * draw_ctx, lv_color_t color,
+                                                     const lv_area_t * fill_area, const uint8_t * map_p, uint32_t bpp, uint32_t col_bit,
+                                                     uint32_t col_bit_row_ofs, const uint8_t * bpp_opa_table_p)
+{
+    if(ramp.fg.full != color.full) {
+        ramp.fg = color;
+        lv_memset_00(ramp.valid, sizeof(ramp.valid));
+    }
+
+    int32_t dest_stride = lv_area_get_width(draw_ctx->buf_area);
+    int32_t w = lv_area_get_width(fill_area);
+    lv_color_t * dest_buf = draw_ctx->buf;
+    dest_buf += dest_stride * (fill_area->y1 - draw_ctx->buf_area->y1) + (fill_area->x1 - draw_ctx->buf_area->x1);
+
+    int32_t x;
+    int32_t y;
+    for(y = fill_area->y1; y <= fill_area->y2; y++) {
+        if(bpp == 8) {
+            for(x = 0; x < w; x++) {
+                lv_opa_t px_opa = map_p[x];
+                if(px_opa == LV_OPA_COVER) dest_buf[x] = color;
+                else if(px_opa) dest_buf[x] = ramp_get_color(dest_buf[x], px_opa);
+            }
+            map_p += w;
+        }
+        else {
+            for(x = 0; x < w; x++) {
+                uint32_t letter_px = col_bit ? (*map_p & 0x0F) : (*map_p >> 4);
+                if(letter_px == 0x0F) dest_buf[x] = color;
+                else if(letter_px) dest_buf[x] = ramp_get_color(dest_buf[x], bpp_opa_table_p[letter_px]);
+
+                if(col_bit) map_p++;
+                col_bit ^= 4;
+            }
+        }
+
+        col_bit += col_bit_row_ofs;
+        map_p += (col_bit >> 3);
+        col_bit = col_bit & 0x7;
+        dest_buf += dest_stride;
+    }
+}
+
+/**
+ * Get the letter color mixed to a background color with the given opacity.
+ * The result is the same as `lv_color_mix()` but it's calculated only once for each opacity
+ * while the background color and the letter color don't change.
+ * @param bg the background color
+ * @param opa the opacity of the letter's pixel
+ * @return the mixed color
+ */
+static inline lv_color_t ramp_get_color(lv_color_t bg, lv_opa_t opa)
+{
+    if(ramp.bg.full != bg.full) {
+        ramp.bg = bg;
+        lv_memset_00(ramp.valid, sizeof(ramp.valid));
+    }
+
+    uint32_t bit = (uint32_t)1 << (opa & 0x1F);
+    if((ramp.valid[opa >> 5] & bit) == 0) {
+        ramp.color[opa] = lv_color_mix(ramp.fg, bg, opa);
+        ramp.valid[opa >> 5] |= bit;
+    }
+
+    return ramp.color[opa];
+}
+
 #if LV_DRAW_COMPLEX && LV_USE_FONT_SUBPX
 static void draw_letter_subpx(lv_draw_ctx_t * draw_ctx, const lv_draw_label_dsc_t * dsc, const lv_point_t * pos,
                               lv_font_glyph_dsc_t * g, const uint8_t * map_p)
@@ -18,6 +18,14 @@
 /*********************
  *      DEFINES
  *********************/
+#if LV_USE_FONT_FMT_TXT_CACHE
+#if (LV_FONT_FMT_TXT_CACHE_ID_CNT & (LV_FONT_FMT_TXT_CACHE_ID_CNT - 1)) != 0
+    #error "LV_FONT_FMT_TXT_CACHE_ID_CNT has to be a power of 2"
+#endif
+
+/*Max. number of decompressed glyphs in the cache. Assume glyphs with at least 64 bytes on average*/
+#define BITMAP_CACHE_CNT    LV_MAX(LV_FONT_FMT_TXT_CACHE_SIZE / 64, 8)
+#endif /*LV_USE_FONT_FMT_TXT_CACHE*/
 
 /**********************
  *      TYPEDEFS
@@ -28,10 +36,27 @@ typedef enum {
     RLE_STATE_COUNTER,
 } rle_state_t;
 
+#if LV_USE_FONT_FMT_TXT_CACHE
+typedef struct {
+    const lv_font_fmt_txt_dsc_t * fdsc;
+    uint32_t letter;
+    uint32_t glyph_id;
+} glyph_id_cache_entry_t;
+
+typedef struct {
+    const lv_font_fmt_txt_dsc_t * fdsc;
+    uint32_t glyph_id;
+    uint32_t last_use;  /*Value of `bitmap_cache_time` when the entry was used last*/
+    uint32_t ofs;       /*Start of the bitmap in `bitmap_cache_arena`*/
+    uint32_t size;
+} bitmap_cache_entry_t;
+#endif /*LV_USE_FONT_FMT_TXT_CACHE*/
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
+static uint32_t get_glyph_dsc_id_from_cmaps(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter);
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right);
 static int32_t unicode_list_compare(const void * ref, const void * element);
 static int32_t kern_pair_8_compare(const void * ref, const void * element);
@@ -46,6 +71,11 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
     static inline uint8_t rle_next(void);
 #endif /*LV_USE_FONT_COMPRESSED*/
 
+#if LV_USE_FONT_FMT_TXT_CACHE && LV_USE_FONT_COMPRESSED
+    static uint8_t * bitmap_cache_get(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t glyph_id, uint32_t size, bool * hit);
+    static void bitmap_cache_remove(uint32_t i);
+#endif
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -58,6 +88,17 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
     static rle_state_t rle_state;
 #endif /*LV_USE_FONT_COMPRESSED*/
 
+#if LV_USE_FONT_FMT_TXT_CACHE
+    static glyph_id_cache_entry_t glyph_id_cache[LV_FONT_FMT_TXT_CACHE_ID_CNT];
+    static lv_font_fmt_txt_cache_stats_t cache_stats;
+#if LV_USE_FONT_COMPRESSED
+    static uint8_t bitmap_cache_arena[LV_FONT_FMT_TXT_CACHE_SIZE];
+    static bitmap_cache_entry_t bitmap_cache[BITMAP_CACHE_CNT];  /*Ordered by `ofs`*/
+    static uint32_t bitmap_cache_cnt;
+    static uint32_t bitmap_cache_time;
+#endif
+#endif /*LV_USE_FONT_FMT_TXT_CACHE*/
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -115,6 +156,21 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
                 break;
         }
 
+        bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED ? true : false;
+
+#if LV_USE_FONT_FMT_TXT_CACHE
+        /*Decompress directly into the cache. Glyphs not fitting into the cache use the common buffer*/
+        bool hit;
+        uint8_t * cache_buf = bitmap_cache_get(fdsc, gid, buf_size, &hit);
+        if(cache_buf) {
+            if(!hit) {
+                decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], cache_buf, gdsc->box_w, gdsc->box_h,
+                           (uint8_t)fdsc->bpp, prefilter);
+            }
+            return cache_buf;
+        }
+#endif
+
         if(last_buf_size < buf_size) {
             uint8_t * tmp = lv_mem_realloc(LV_GC_ROOT(_lv_font_decompr_buf), buf_size);
             LV_ASSERT_MALLOC(tmp);
@@ -123,7 +179,6 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
             last_buf_size = buf_size;
         }
 
-        bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED ? true : false;
         decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], LV_GC_ROOT(_lv_font_decompr_buf), gdsc->box_w, gdsc->box_h,
                    (uint8_t)fdsc->bpp, prefilter);
         return LV_GC_ROOT(_lv_font_decompr_buf);
@@ -202,6 +257,39 @@ void _lv_font_clean_up_fmt_txt(void)
 #endif
 }
 
+#if LV_USE_FONT_FMT_TXT_CACHE
+/**
+ * Remove the glyph ids and bitmaps of a font from the cache.
+ * Needs to be called before freeing a font created at run time.
+ * @param font pointer to a font
+ */
+void lv_font_drop_cache_fmt_txt(const lv_font_t * font)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    uint32_t i;
+    for(i = 0; i < LV_FONT_FMT_TXT_CACHE_ID_CNT; i++) {
+        if(glyph_id_cache[i].fdsc == fdsc) glyph_id_cache[i].fdsc = NULL;
+    }
+
+#if LV_USE_FONT_COMPRESSED
+    i = 0;
+    while(i < bitmap_cache_cnt) {
+        if(bitmap_cache[i].fdsc == fdsc) bitmap_cache_remove(i);
+        else i++;
+    }
+#endif
+}
+
+/**
+ * Get the hit and miss counters of the font cache
+ * @param stats store the counters here
+ */
+void lv_font_get_cache_stats_fmt_txt(lv_font_fmt_txt_cache_stats_t * stats)
+{
+    *stats = cache_stats;
+}
+#endif /*LV_USE_FONT_FMT_TXT_CACHE*/
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -215,6 +303,38 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
     /*Check the cache first*/
     if(fdsc->cache && letter == fdsc->cache->last_letter) return fdsc->cache->last_glyph_id;
 
+#if LV_USE_FONT_FMT_TXT_CACHE
+    /*Then the recently used letters of all fonts*/
+    glyph_id_cache_entry_t * id_entry = &glyph_id_cache[(letter ^ ((lv_uintptr_t)fdsc >> 4)) &
+                                                        (LV_FONT_FMT_TXT_CACHE_ID_CNT - 1)];
+    if(id_entry->fdsc == fdsc && id_entry->letter == letter) {
+        cache_stats.id_hit_cnt++;
+        if(fdsc->cache) {
+            fdsc->cache->last_letter = letter;
+            fdsc->cache->last_glyph_id = id_entry->glyph_id;
+        }
+        return id_entry->glyph_id;
+    }
+    cache_stats.id_miss_cnt++;
+#endif
+
+    uint32_t glyph_id = get_glyph_dsc_id_from_cmaps(fdsc, letter);
+
+#if LV_USE_FONT_FMT_TXT_CACHE
+    id_entry->fdsc = fdsc;
+    id_entry->letter = letter;
+    id_entry->glyph_id = glyph_id;
+#endif
+
+    if(fdsc->cache) {
+        fdsc->cache->last_letter = letter;
+        fdsc->cache->last_glyph_id = glyph_id;
+    }
+    return glyph_id;
+}
+
+static uint32_t get_glyph_dsc_id_from_cmaps(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter)
+{
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
 
@@ -251,20 +371,10 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
             }
         }
 
-        /*Update the cache*/
-        if(fdsc->cache) {
-            fdsc->cache->last_letter = letter;
-            fdsc->cache->last_glyph_id = glyph_id;
-        }
         return glyph_id;
     }
 
-    if(fdsc->cache) {
-        fdsc->cache->last_letter = letter;
-        fdsc->cache->last_glyph_id = 0;
-    }
     return 0;
-
 }
 
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right)
@@ -575,6 +685,78 @@ static inline uint8_t rle_next(void)
 }
 #endif /*LV_USE_FONT_COMPRESSED*/
 
+#if LV_USE_FONT_FMT_TXT_CACHE && LV_USE_FONT_COMPRESSED
+/**
+ * Get the place of a decompressed glyph in the cache. If the glyph is not cached yet
+ * the least recently used glyphs are removed until there is enough space for it.
+ * @param fdsc pointer to a font descriptor
+ * @param glyph_id id of the glyph
+ * @param size size of the decompressed bitmap in bytes
+ * @param hit true: the glyph was found in the cache; false: the glyph needs to be decompressed to the returned place
+ * @return pointer to the bitmap in the cache or NULL if the glyph is larger than the cache
+ */
+static uint8_t * bitmap_cache_get(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t glyph_id, uint32_t size, bool * hit)
+{
+    bitmap_cache_time++;
+
+    uint32_t i;
+    for(i = 0; i < bitmap_cache_cnt; i++) {
+        if(bitmap_cache[i].fdsc == fdsc && bitmap_cache[i].glyph_id == glyph_id) {
+            bitmap_cache[i].last_use = bitmap_cache_time;
+            cache_stats.bitmap_hit_cnt++;
+            *hit = true;
+            return &bitmap_cache_arena[bitmap_cache[i].ofs];
+        }
+    }
+
+    cache_stats.bitmap_miss_cnt++;
+    *hit = false;
+    if(size > LV_FONT_FMT_TXT_CACHE_SIZE) return NULL;
+
+    while(1) {
+        /*Look for the first gap large enough between the entries*/
+        if(bitmap_cache_cnt < BITMAP_CACHE_CNT) {
+            uint32_t gap_start = 0;
+            for(i = 0; i <= bitmap_cache_cnt; i++) {
+                uint32_t gap_end = i < bitmap_cache_cnt ? bitmap_cache[i].ofs : LV_FONT_FMT_TXT_CACHE_SIZE;
+                if(gap_end - gap_start >= size) break;
+                if(i < bitmap_cache_cnt) gap_start = bitmap_cache[i].ofs + bitmap_cache[i].size;
+            }
+
+            if(i <= bitmap_cache_cnt) {
+                uint32_t j;
+                for(j = bitmap_cache_cnt; j > i; j--) bitmap_cache[j] = bitmap_cache[j - 1];
+                bitmap_cache_cnt++;
+
+                bitmap_cache[i].fdsc = fdsc;
+                bitmap_cache[i].glyph_id = glyph_id;
+                bitmap_cache[i].last_use = bitmap_cache_time;
+                bitmap_cache[i].ofs = gap_start;
+                bitmap_cache[i].size = size;
+                return &bitmap_cache_arena[gap_start];
+            }
+        }
+
+        /*No place, remove the least recently used glyph*/
+        uint32_t lru = 0;
+        for(i = 1; i < bitmap_cache_cnt; i++) {
+            if(bitmap_cache[i].last_use < bitmap_cache[lru].last_use) lru = i;
+        }
+        bitmap_cache_remove(lru);
+    }
+}
+
+/**
+ * Remove an entry from the bitmap cache
+ * @param i index of the entry
+ */
+static void bitmap_cache_remove(uint32_t i)
+{
+    bitmap_cache_cnt--;
+    for(; i < bitmap_cache_cnt; i++) bitmap_cache[i] = bitmap_cache[i + 1];
+}
+#endif /*LV_USE_FONT_FMT_TXT_CACHE && LV_USE_FONT_COMPRESSED*/
+
 /** Code Comparator.
  *
  *  Compares the value of both input arguments.
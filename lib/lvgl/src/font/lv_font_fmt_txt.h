@@ -156,6 +156,15 @@ typedef struct {
     uint32_t last_glyph_id;
 } lv_font_fmt_txt_glyph_cache_t;
 
+#if LV_USE_FONT_FMT_TXT_CACHE
+typedef struct {
+    uint32_t id_hit_cnt;        /*Letters found in the glyph id cache*/
+    uint32_t id_miss_cnt;       /*Letters searched in the cmaps*/
+    uint32_t bitmap_hit_cnt;    /*Compressed glyphs found decompressed in the cache*/
+    uint32_t bitmap_miss_cnt;   /*Compressed glyphs decompressed again*/
+} lv_font_fmt_txt_cache_stats_t;
+#endif
+
 /*Describe store additional data for fonts*/
 typedef struct {
     /*The bitmaps of all glyphs*/
@@ -225,6 +234,21 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
  */
 void _lv_font_clean_up_fmt_txt(void);
 
+#if LV_USE_FONT_FMT_TXT_CACHE
+/**
+ * Remove the glyph ids and bitmaps of a font from the cache.
+ * Needs to be called before freeing a font created at run time.
+ * @param font pointer to a font
+ */
+void lv_font_drop_cache_fmt_txt(const lv_font_t * font);
+
+/**
+ * Get the hit and miss counters of the font cache
+ * @param stats store the counters here
+ */
+void lv_font_get_cache_stats_fmt_txt(lv_font_fmt_txt_cache_stats_t * stats);
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -32,6 +32,10 @@ extern "C" {
 #define LV_INV_BUF_SIZE 32 /*Buffer size for invalid areas*/
 #endif
 
+#ifndef LV_INV_AREA_COST
+#define LV_INV_AREA_COST 1024 /*Cost of refreshing one more invalid area in pixels. Areas are joined if it's cheaper*/
+#endif
+
 #ifndef LV_ATTRIBUTE_FLUSH_READY
 #define LV_ATTRIBUTE_FLUSH_READY
 #endif
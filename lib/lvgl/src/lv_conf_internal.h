@@ -157,6 +157,27 @@
         #endif
     #endif
 
+    /*Size of a separate area in the memory for the small allocations (e.g. styles, linked list nodes, animations).
+     *It's divided into 512 byte pages of equal size slots to reduce fragmentation and make the allocations faster.
+     *0: disable*/
+    #ifndef LV_MEM_SLAB_SIZE
+        #ifdef CONFIG_LV_MEM_SLAB_SIZE
+            #define LV_MEM_SLAB_SIZE CONFIG_LV_MEM_SLAB_SIZE
+        #else
+            #define LV_MEM_SLAB_SIZE 0          /*[bytes]*/
+        #endif
+    #endif
+    #if LV_MEM_SLAB_SIZE
+        /*Larger allocations use the normal heap. Should be a multiple of 16 and not larger than 128*/
+        #ifndef LV_MEM_SLAB_MAX_ALLOC
+            #ifdef CONFIG_LV_MEM_SLAB_MAX_ALLOC
+                #define LV_MEM_SLAB_MAX_ALLOC CONFIG_LV_MEM_SLAB_MAX_ALLOC
+            #else
+                #define LV_MEM_SLAB_MAX_ALLOC 128   /*[bytes]*/
+            #endif
+        #endif
+    #endif
+
 #else       /*LV_MEM_CUSTOM*/
     #ifndef LV_MEM_CUSTOM_INCLUDE
         #ifdef CONFIG_LV_MEM_CUSTOM_INCLUDE
@@ -198,6 +219,26 @@
     #endif
 #endif
 
+/*1: Record the file and line, the size and the lifetime of the allocations to see what uses the memory.
+ *See `lv_mem_track_dump()`. It adds 16 bytes to each allocation.*/
+#ifndef LV_USE_MEM_TRACK
+    #ifdef CONFIG_LV_USE_MEM_TRACK
+        #define LV_USE_MEM_TRACK CONFIG_LV_USE_MEM_TRACK
+    #else
+        #define LV_USE_MEM_TRACK 0
+    #endif
+#endif
+#if LV_USE_MEM_TRACK
+    /*Number of the recorded allocation sites. The last one collects the others if there are more.*/
+    #ifndef LV_MEM_TRACK_SITE_CNT
+        #ifdef CONFIG_LV_MEM_TRACK_SITE_CNT
+            #define LV_MEM_TRACK_SITE_CNT CONFIG_LV_MEM_TRACK_SITE_CNT
+        #else
+            #define LV_MEM_TRACK_SITE_CNT 64
+        #endif
+    #endif
+#endif
+
 /*Use the standard `memcpy` and `memset` instead of LVGL's own functions. (Might or might not be faster).*/
 #ifndef LV_MEMCPY_MEMSET_STD
     #ifdef CONFIG_LV_MEMCPY_MEMSET_STD
@@ -343,6 +384,27 @@
     #endif
 #endif
 
+/*Record the draw calls of the widgets and replay them until the widget is invalidated.
+ *Widgets which are redrawn only because they overlap a changed area skip the event processing,
+ *style resolution and draw descriptor setup this way.
+ *LV_RETAINED_DRAW_MAX_SIZE: [bytes] max. size of a widget's recording. Larger ones are drawn as usual.*/
+#ifndef LV_USE_RETAINED_DRAW
+    #ifdef CONFIG_LV_USE_RETAINED_DRAW
+        #define LV_USE_RETAINED_DRAW CONFIG_LV_USE_RETAINED_DRAW
+    #else
+        #define LV_USE_RETAINED_DRAW 0
+    #endif
+#endif
+#if LV_USE_RETAINED_DRAW
+    #ifndef LV_RETAINED_DRAW_MAX_SIZE
+        #ifdef CONFIG_LV_RETAINED_DRAW_MAX_SIZE
+            #define LV_RETAINED_DRAW_MAX_SIZE CONFIG_LV_RETAINED_DRAW_MAX_SIZE
+        #else
+            #define LV_RETAINED_DRAW_MAX_SIZE (1 * 1024)
+        #endif
+    #endif
+#endif
+
 /*Default image cache size. Image caching keeps the images opened.
  *If only the built-in image formats are used there is no real advantage of caching. (I.e. if no new image decoder is added)
  *With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
@@ -848,6 +910,17 @@
     #endif
 #endif
 
+/*Number of object parts whose most often read style properties are cached.
+ *The cached values are used until a style, a state or the object tree changes.
+ *An entry takes 24 + 32 * 4 bytes (with 32 bit pointers). 0: to disable caching*/
+#ifndef LV_OBJ_STYLE_CACHE_SIZE
+    #ifdef CONFIG_LV_OBJ_STYLE_CACHE_SIZE
+        #define LV_OBJ_STYLE_CACHE_SIZE CONFIG_LV_OBJ_STYLE_CACHE_SIZE
+    #else
+        #define LV_OBJ_STYLE_CACHE_SIZE 0
+    #endif
+#endif
+
 /*Garbage Collector settings
  *Used if lvgl is bound to higher level language and the memory is managed by that language*/
 #ifndef LV_ENABLE_GC
@@ -1229,6 +1302,33 @@
     #endif
 #endif
 
+/*Cache the glyph ids of the recently used letters and the decompressed bitmaps of compressed fonts.
+ *LV_FONT_FMT_TXT_CACHE_ID_CNT: number of cached letter -> glyph id pairs. Has to be a power of 2.
+ *LV_FONT_FMT_TXT_CACHE_SIZE: [bytes] statically allocated place for the decompressed glyphs. Used only with LV_USE_FONT_COMPRESSED*/
+#ifndef LV_USE_FONT_FMT_TXT_CACHE
+    #ifdef CONFIG_LV_USE_FONT_FMT_TXT_CACHE
+        #define LV_USE_FONT_FMT_TXT_CACHE CONFIG_LV_USE_FONT_FMT_TXT_CACHE
+    #else
+        #define LV_USE_FONT_FMT_TXT_CACHE 0
+    #endif
+#endif
+#if LV_USE_FONT_FMT_TXT_CACHE
+    #ifndef LV_FONT_FMT_TXT_CACHE_ID_CNT
+        #ifdef CONFIG_LV_FONT_FMT_TXT_CACHE_ID_CNT
+            #define LV_FONT_FMT_TXT_CACHE_ID_CNT CONFIG_LV_FONT_FMT_TXT_CACHE_ID_CNT
+        #else
+            #define LV_FONT_FMT_TXT_CACHE_ID_CNT 32
+        #endif
+    #endif
+    #ifndef LV_FONT_FMT_TXT_CACHE_SIZE
+        #ifdef CONFIG_LV_FONT_FMT_TXT_CACHE_SIZE
+            #define LV_FONT_FMT_TXT_CACHE_SIZE CONFIG_LV_FONT_FMT_TXT_CACHE_SIZE
+        #else
+            #define LV_FONT_FMT_TXT_CACHE_SIZE (4 * 1024)
+        #endif
+    #endif
+#endif
+
 /*Enable subpixel rendering*/
 #ifndef LV_USE_FONT_SUBPX
     #ifdef CONFIG_LV_USE_FONT_SUBPX
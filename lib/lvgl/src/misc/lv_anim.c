@@ -20,26 +20,49 @@
  *********************/
 #define LV_ANIM_RESOLUTION 1024
 #define LV_ANIM_RES_SHIFT 10
+#define ANIM_ARR_MIN_CAP 8
+
+#define ANIM_ARR (LV_GC_ROOT(_lv_anim_arr))
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/*The timing of the last evaluated animation and the step of its path if it's affine (see `path_is_affine`)*/
+typedef struct {
+    lv_anim_path_cb_t path_cb;
+    int32_t act_time;
+    int32_t time;
+    int32_t step;
+    uint8_t step_valid : 1;
+} step_cache_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void anim_timer(lv_timer_t * param);
-static void anim_mark_list_change(void);
-static void anim_ready_handler(lv_anim_t * a);
+static void anim_step(uint32_t idx, uint32_t elaps, step_cache_t * cache);
+static int32_t anim_path_value(const lv_anim_t * a, step_cache_t * c);
+static void anim_ready_handler(uint32_t idx);
+static bool path_is_affine(lv_anim_path_cb_t path_cb);
+static bool anim_arr_reserve(uint32_t cnt);
+static void anim_arr_remove(uint32_t idx);
+static void anim_arr_compact(void);
+static void anim_timer_update(void);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static uint32_t last_timer_run;
-static bool anim_list_changed;
-static bool anim_run_round;
 static lv_timer_t * _lv_anim_tmr;
 
+/*The animations are stored in `_lv_anim_arr` in the order of their creation.
+ *While `anim_timer` runs the deleted animations leave NULL holes which are removed at its end.*/
+static uint32_t anim_cnt;
+static uint32_t anim_cap;
+static uint32_t anim_hole_cnt;
+static bool anim_running;
+
 /**********************
  *      MACROS
  **********************/
@@ -55,10 +78,13 @@ static lv_timer_t * _lv_anim_tmr;
 
 void _lv_anim_core_init(void)
 {
-    _lv_ll_init(&LV_GC_ROOT(_lv_anim_ll), sizeof(lv_anim_t));
+    ANIM_ARR = NULL;
+    anim_cnt = 0;
+    anim_cap = 0;
+    anim_hole_cnt = 0;
+    anim_running = false;
     _lv_anim_tmr = lv_timer_create(anim_timer, LV_DISP_DEF_REFR_PERIOD, NULL);
-    anim_mark_list_change(); /*Turn off the animation timer*/
-    anim_list_changed = false;
+    anim_timer_update(); /*Turn off the animation timer*/
 }
 
 void lv_anim_init(lv_anim_t * a)
@@ -79,20 +105,28 @@ lv_anim_t * lv_anim_start(const lv_anim_t * a)
     /*Do not let two animations for the same 'var' with the same 'exec_cb'*/
     if(a->exec_cb != NULL) lv_anim_del(a->var, a->exec_cb); /*exec_cb == NULL would delete all animations of var*/
 
-    /*If the list is empty the anim timer was suspended and it's last run measure is invalid*/
-    if(_lv_ll_is_empty(&LV_GC_ROOT(_lv_anim_ll))) {
+    /*If there are no animations the anim timer was suspended and it's last run measure is invalid*/
+    if(lv_anim_count_running() == 0) {
         last_timer_run = lv_tick_get();
     }
 
-    /*Add the new animation to the animation linked list*/
-    lv_anim_t * new_anim = _lv_ll_ins_head(&LV_GC_ROOT(_lv_anim_ll));
+    /*Add the new animation to the end of the array.
+     *If it's added in `anim_timer` it will run only from the next round.*/
+    if(!anim_arr_reserve(anim_cnt + 1)) {
+        LV_ASSERT_MALLOC(NULL);
+        return NULL;
+    }
+
+    lv_anim_t * new_anim = lv_mem_alloc(sizeof(lv_anim_t));
     LV_ASSERT_MALLOC(new_anim);
     if(new_anim == NULL) return NULL;
 
+    ANIM_ARR[anim_cnt] = new_anim;
+    anim_cnt++;
+
     /*Initialize the animation descriptor*/
     lv_memcpy(new_anim, a, sizeof(lv_anim_t));
     if(a->var == a) new_anim->var = new_anim;
-    new_anim->run_round = anim_run_round;
 
     /*Set the start value*/
     if(new_anim->early_apply) {
@@ -105,9 +139,7 @@ lv_anim_t * lv_anim_start(const lv_anim_t * a)
         if(new_anim->exec_cb && new_anim->var) new_anim->exec_cb(new_anim->var, new_anim->start_value);
     }
 
-    /*Creating an animation changed the linked list.
-     *It's important if it happens in a ready callback. (see `anim_timer`)*/
-    anim_mark_list_change();
+    anim_timer_update();
 
     TRACE_ANIM("finished");
     return new_anim;
@@ -136,40 +168,51 @@ uint32_t lv_anim_get_playtime(lv_anim_t * a)
 
 bool lv_anim_del(void * var, lv_anim_exec_xcb_t exec_cb)
 {
-    lv_anim_t * a;
-    lv_anim_t * a_next;
     bool del = false;
-    a        = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-    while(a != NULL) {
-        /*'a' might be deleted, so get the next object while 'a' is valid*/
-        a_next = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
+
+    /*Go from the newest animation to the oldest*/
+    uint32_t i = anim_cnt;
+    while(i > 0) {
+        i--;
+        lv_anim_t * a = ANIM_ARR[i];
+        if(a == NULL) continue;
 
         if((a->var == var || var == NULL) && (a->exec_cb == exec_cb || exec_cb == NULL)) {
-            _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
+            anim_arr_remove(i);
             if(a->deleted_cb != NULL) a->deleted_cb(a);
             lv_mem_free(a);
-            anim_mark_list_change(); /*Read by `anim_timer`. It need to know if a delete occurred in
-                                       the linked list*/
             del = true;
-        }
 
-        a = a_next;
+            /*The callback might have deleted other animations too*/
+            if(i > anim_cnt) i = anim_cnt;
+        }
     }
 
+    if(del) anim_timer_update();
+
     return del;
 }
 
 void lv_anim_del_all(void)
 {
-    _lv_ll_clear(&LV_GC_ROOT(_lv_anim_ll));
-    anim_mark_list_change();
+    uint32_t i;
+    for(i = 0; i < anim_cnt; i++) {
+        if(ANIM_ARR[i] == NULL) continue;
+        lv_mem_free(ANIM_ARR[i]);
+        ANIM_ARR[i] = NULL;
+        anim_hole_cnt++;
+    }
+
+    if(!anim_running) anim_arr_compact();
+    anim_timer_update();
 }
 
 lv_anim_t * lv_anim_get(void * var, lv_anim_exec_xcb_t exec_cb)
 {
-    lv_anim_t * a;
-    _LV_LL_READ(&LV_GC_ROOT(_lv_anim_ll), a) {
-        if(a->var == var && (a->exec_cb == exec_cb || exec_cb == NULL)) {
+    uint32_t i;
+    for(i = anim_cnt; i > 0; i--) {
+        lv_anim_t * a = ANIM_ARR[i - 1];
+        if(a && a->var == var && (a->exec_cb == exec_cb || exec_cb == NULL)) {
             return a;
         }
     }
@@ -184,11 +227,7 @@ struct _lv_timer_t * lv_anim_get_timer(void)
 
 uint16_t lv_anim_count_running(void)
 {
-    uint16_t cnt = 0;
-    lv_anim_t * a;
-    _LV_LL_READ(&LV_GC_ROOT(_lv_anim_ll), a) cnt++;
-
-    return cnt;
+    return anim_cnt - anim_hole_cnt;
 }
 
 uint32_t lv_anim_speed_to_time(uint32_t speed, int32_t start, int32_t end)
@@ -338,6 +377,7 @@ int32_t lv_anim_path_step(const lv_anim_t * a)
         return a->start_value;
 }
 
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -350,72 +390,118 @@ static void anim_timer(lv_timer_t * param)
 {
     LV_UNUSED(param);
 
+    /*E.g. `lv_refr_now()` in an animation callback. The animations will be updated in the next round.*/
+    if(anim_running) return;
+
     uint32_t elaps = lv_tick_elaps(last_timer_run);
 
-    /*Flip the run round*/
-    anim_run_round = anim_run_round ? false : true;
-
-    lv_anim_t * a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-
-    while(a != NULL) {
-        /*It can be set by `lv_anim_del()` typically in `end_cb`. If set then an animation delete
-         * happened in `anim_ready_handler` which could make this linked list reading corrupt
-         * because the list is changed meanwhile
-         */
-        anim_list_changed = false;
-
-        if(a->run_round != anim_run_round) {
-            a->run_round = anim_run_round; /*The list readying might be reset so need to know which anim has run already*/
-
-            /*The animation will run now for the first time. Call `start_cb`*/
-            int32_t new_act_time = a->act_time + elaps;
-            if(!a->start_cb_called && a->act_time <= 0 && new_act_time >= 0) {
-                if(a->early_apply == 0 && a->get_value_cb) {
-                    int32_t v_ofs = a->get_value_cb(a);
-                    a->start_value += v_ofs;
-                    a->end_value += v_ofs;
-                }
-                if(a->start_cb) a->start_cb(a);
-                a->start_cb_called = 1;
-            }
-            a->act_time += elaps;
-            if(a->act_time >= 0) {
-                if(a->act_time > a->time) a->act_time = a->time;
-
-                int32_t new_value;
-                new_value = a->path_cb(a);
-
-                if(new_value != a->current_value) {
-                    a->current_value = new_value;
-                    /*Apply the calculated value*/
-                    if(a->exec_cb) a->exec_cb(a->var, new_value);
-                }
-
-                /*If the time is elapsed the animation is ready*/
-                if(a->act_time >= a->time) {
-                    anim_ready_handler(a);
-                }
-            }
-        }
+    /*The animations started in the callbacks are added after `cnt` and will run from the next round*/
+    uint32_t cnt = anim_cnt;
+    anim_running = true;
+
+    step_cache_t cache;
+    lv_memset_00(&cache, sizeof(cache));
 
-        /*If the linked list changed due to anim. delete then it's not safe to continue
-         *the reading of the list from here -> start from the head*/
-        if(anim_list_changed)
-            a = _lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-        else
-            a = _lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
+    /*Go from the newest animation to the oldest*/
+    uint32_t i;
+    for(i = cnt; i > 0; i--) {
+        if(ANIM_ARR[i - 1] == NULL) continue;   /*Deleted in a callback*/
+        anim_step(i - 1, elaps, &cache);
     }
 
+    anim_running = false;
+    anim_arr_compact();
+    anim_timer_update();
+
     last_timer_run = lv_tick_get();
 }
 
+/**
+ * Advance an animation, apply its new value and handle its start and end
+ * @param idx       index of the animation
+ * @param elaps     time elapsed since the last run
+ * @param cache     the timing and path step of the previous animation
+ */
+static void anim_step(uint32_t idx, uint32_t elaps, step_cache_t * cache)
+{
+    lv_anim_t * a = ANIM_ARR[idx];
+
+    /*The animation will run now for the first time. Call `start_cb`*/
+    int32_t new_act_time = a->act_time + elaps;
+    if(!a->start_cb_called && a->act_time <= 0 && new_act_time >= 0) {
+        if(a->early_apply == 0 && a->get_value_cb) {
+            int32_t v_ofs = a->get_value_cb(a);
+            a->start_value += v_ofs;
+            a->end_value += v_ofs;
+        }
+        if(a->start_cb) a->start_cb(a);
+        a->start_cb_called = 1;
+        if(ANIM_ARR[idx] == NULL) return;   /*Deleted in `start_cb`*/
+    }
+    a->act_time += elaps;
+    if(a->act_time < 0) return;
+    if(a->act_time > a->time) a->act_time = a->time;
+
+    int32_t new_value = anim_path_value(a, cache);
+    if(new_value != a->current_value) {
+        a->current_value = new_value;
+        /*Apply the calculated value*/
+        if(a->exec_cb) a->exec_cb(a->var, new_value);
+        if(ANIM_ARR[idx] == NULL) return;   /*Deleted in `exec_cb`*/
+    }
+
+    /*If the time is elapsed the animation is ready*/
+    if(a->act_time >= a->time) {
+        anim_ready_handler(idx);
+    }
+}
+
+/**
+ * Get the current value of an animation.
+ * Animations started together are next to each other in the array, so if an animation
+ * has the same affine path and timing as the previous one the step of the path is reused.
+ * @param a         pointer to an animation
+ * @param c         the timing and path step of the previous animation
+ * @return          the current value
+ */
+static int32_t anim_path_value(const lv_anim_t * a, step_cache_t * c)
+{
+    if(c->path_cb != a->path_cb || c->act_time != a->act_time || c->time != a->time) {
+        /*Probably a single animation with this timing, just remember the timing*/
+        c->path_cb = a->path_cb;
+        c->act_time = a->act_time;
+        c->time = a->time;
+        c->step_valid = 0;
+        return a->path_cb(a);
+    }
+
+    if(!path_is_affine(a->path_cb)) return a->path_cb(a);
+
+    if(!c->step_valid) {
+        /*With 0..LV_ANIM_RESOLUTION range the path returns its step*/
+        lv_anim_t unit;
+        unit.act_time = a->act_time;
+        unit.time = a->time;
+        unit.start_value = 0;
+        unit.end_value = LV_ANIM_RESOLUTION;
+        c->step = a->path_cb(&unit);
+        c->step_valid = 1;
+    }
+
+    int32_t new_value = c->step * (a->end_value - a->start_value);
+    new_value = new_value >> LV_ANIM_RES_SHIFT;
+    return new_value + a->start_value;
+}
+
 /**
  * Called when an animation is ready to do the necessary thinks
  * e.g. repeat, play back, delete etc.
- * @param a pointer to an animation descriptor
+ * @param idx   index of the animation
  */
-static void anim_ready_handler(lv_anim_t * a)
+static void anim_ready_handler(uint32_t idx)
 {
+    lv_anim_t * a = ANIM_ARR[idx];
+
     /*In the end of a forward anim decrement repeat cnt.*/
     if(a->playback_now == 0 && a->repeat_cnt > 0 && a->repeat_cnt != LV_ANIM_REPEAT_INFINITE) {
         a->repeat_cnt--;
@@ -426,11 +512,9 @@ static void anim_ready_handler(lv_anim_t * a)
      * - no repeat, play back is enabled and play back is ready*/
     if(a->repeat_cnt == 0 && (a->playback_time == 0 || a->playback_now == 1)) {
 
-        /*Delete the animation from the list.
+        /*Delete the animation from the array.
          * This way the `ready_cb` will see the animations like it's animation is ready deleted*/
-        _lv_ll_remove(&LV_GC_ROOT(_lv_anim_ll), a);
-        /*Flag that the list has changed*/
-        anim_mark_list_change();
+        anim_arr_remove(idx);
 
         /*Call the callback function at the end*/
         if(a->ready_cb != NULL) a->ready_cb(a);
@@ -459,10 +543,89 @@ static void anim_ready_handler(lv_anim_t * a)
     }
 }
 
-static void anim_mark_list_change(void)
+/**
+ * Tell whether a path is `start + ((step * (end - start)) >> LV_ANIM_RES_SHIFT)` where `step` depends only on the time.
+ * These paths can be evaluated once for all animations with the same timing.
+ * @param path_cb   the path
+ * @return          true: it's an affine path
+ */
+static bool path_is_affine(lv_anim_path_cb_t path_cb)
+{
+    return path_cb == lv_anim_path_linear || path_cb == lv_anim_path_ease_in || path_cb == lv_anim_path_ease_out ||
+           path_cb == lv_anim_path_ease_in_out || path_cb == lv_anim_path_overshoot || path_cb == lv_anim_path_step;
+}
+
+/**
+ * Make sure the animation array has room for `cnt` animations
+ * @param cnt   number of animations
+ * @return      true: success; false: out of memory
+ */
+static bool anim_arr_reserve(uint32_t cnt)
+{
+    if(cnt <= anim_cap) return true;
+
+    uint32_t new_cap = anim_cap ? anim_cap * 2 : ANIM_ARR_MIN_CAP;
+    lv_anim_t ** new_arr = lv_mem_realloc(ANIM_ARR, new_cap * sizeof(lv_anim_t *));
+    if(new_arr == NULL) return false;
+
+    ANIM_ARR = new_arr;
+    anim_cap = new_cap;
+    return true;
+}
+
+/**
+ * Remove an animation from the array but don't free it
+ * @param idx   index of the animation
+ */
+static void anim_arr_remove(uint32_t idx)
+{
+    if(anim_running) {
+        /*`anim_timer` iterates the array so just leave a hole*/
+        ANIM_ARR[idx] = NULL;
+        anim_hole_cnt++;
+        return;
+    }
+
+    uint32_t i;
+    for(i = idx + 1; i < anim_cnt; i++) {
+        ANIM_ARR[i - 1] = ANIM_ARR[i];
+    }
+    anim_cnt--;
+    anim_arr_compact();
+}
+
+/**
+ * Remove the holes from the animation array and free it if it's empty
+ */
+static void anim_arr_compact(void)
+{
+    if(anim_hole_cnt) {
+        uint32_t i;
+        uint32_t j = 0;
+        for(i = 0; i < anim_cnt; i++) {
+            if(ANIM_ARR[i]) {
+                ANIM_ARR[j] = ANIM_ARR[i];
+                j++;
+            }
+        }
+        anim_cnt = j;
+        anim_hole_cnt = 0;
+    }
+
+    /*Keep the capacity while there are animations as they typically come and go in bursts*/
+    if(anim_cnt == 0 && ANIM_ARR) {
+        lv_mem_free(ANIM_ARR);
+        ANIM_ARR = NULL;
+        anim_cap = 0;
+    }
+}
+
+/**
+ * Pause the animation timer if there are no animations and resume it otherwise
+ */
+static void anim_timer_update(void)
 {
-    anim_list_changed = true;
-    if(_lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll)) == NULL)
+    if(lv_anim_count_running() == 0)
         lv_timer_pause(_lv_anim_tmr);
     else
         lv_timer_resume(_lv_anim_tmr);
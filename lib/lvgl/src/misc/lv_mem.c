@@ -12,6 +12,8 @@
 #include "lv_gc.h"
 #include "lv_assert.h"
 #include "lv_log.h"
+#include "lv_math.h"
+#include "../hal/lv_hal_tick.h"
 
 #if LV_MEM_CUSTOM != 0
     #include LV_MEM_CUSTOM_INCLUDE
@@ -39,17 +41,74 @@
 
 #define ZERO_MEM_SENTINEL  0xa1b2c3d4
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_SIZE
+    #define USE_SLAB            1
+    #define SLAB_PAGE_SIZE      512
+    #define SLAB_PAGE_CNT       (LV_MEM_SLAB_SIZE / SLAB_PAGE_SIZE)
+    #define SLAB_SLOT_STEP      16
+    #define SLAB_CLASS_CNT      (LV_MEM_SLAB_MAX_ALLOC / SLAB_SLOT_STEP)
+    #define SLAB_CLASS_NONE     0xFF
+
+    #if SLAB_PAGE_CNT == 0 || SLAB_PAGE_CNT > 255
+        #error "LV_MEM_SLAB_SIZE should be between 512 bytes and 127 kB"
+    #endif
+    #if LV_MEM_SLAB_MAX_ALLOC % SLAB_SLOT_STEP || LV_MEM_SLAB_MAX_ALLOC > SLAB_PAGE_SIZE / 4
+        #error "LV_MEM_SLAB_MAX_ALLOC should be a multiple of 16 and not larger than 128"
+    #endif
+#else
+    #define USE_SLAB            0
+#endif
+
+#if LV_USE_MEM_TRACK
+    #define TRACK_HDR_SIZE      sizeof(track_hdr_t)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if USE_SLAB
+typedef struct {
+    void * free_list;       /*The freed slots linked through their first bytes*/
+    uint16_t used_cnt;      /*Number of allocated slots*/
+    uint16_t unused_ofs;    /*The slots from here were not used since the page got its size class*/
+    uint8_t class_id;       /*The slot size is `(class_id + 1) * SLAB_SLOT_STEP`. SLAB_CLASS_NONE: empty page*/
+} slab_page_t;
+#endif
+
+#if LV_USE_MEM_TRACK
+/*Stored before the allocated memories. Its size keeps the alignment of the allocation.*/
+typedef struct {
+    uint32_t size;
+    uint32_t time;
+    uint32_t site_id;
+    uint32_t reserved;
+} track_hdr_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void * alloc_core(size_t size);
+static void free_core(void * data);
+static void * realloc_core(void * data_p, size_t new_size);
+
 #if LV_MEM_CUSTOM == 0
     static void lv_mem_walker(void * ptr, size_t size, int used, void * user);
 #endif
 
+#if USE_SLAB
+    static void * slab_alloc(size_t size);
+    static void slab_free(void * data);
+    static inline bool is_slab(const void * data);
+    static inline uint32_t slab_slot_size(const void * data);
+#endif
+
+#if LV_USE_MEM_TRACK
+    static void track_add(track_hdr_t * hdr, uint32_t size, uint32_t time, const char * file, uint32_t line);
+    static void track_remove(track_hdr_t * hdr);
+    static uint32_t track_hist_index(uint32_t v, uint32_t limit);
+#endif
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -61,6 +120,17 @@
 
 static uint32_t zero_mem = ZERO_MEM_SENTINEL; /*Give the address of this variable if 0 byte should be allocated*/
 
+#if USE_SLAB
+    static uint8_t * slab_area;
+    static slab_page_t slab_pages[SLAB_PAGE_CNT];
+    static uint8_t slab_last_page[SLAB_CLASS_CNT];   /*The page where the size class allocated last time*/
+#endif
+
+#if LV_USE_MEM_TRACK
+    static lv_mem_track_site_t track_sites[LV_MEM_TRACK_SITE_CNT];
+    static lv_mem_track_hist_t track_hist;
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -100,6 +170,20 @@ void lv_mem_init(void)
 #endif
 #endif
 
+#if USE_SLAB
+    slab_area = lv_tlsf_malloc(tlsf, SLAB_PAGE_CNT * SLAB_PAGE_SIZE);
+    LV_ASSERT_MALLOC(slab_area);
+    uint32_t i;
+    lv_memset_00(slab_pages, sizeof(slab_pages));
+    for(i = 0; i < SLAB_PAGE_CNT; i++) slab_pages[i].class_id = SLAB_CLASS_NONE;
+    lv_memset_00(slab_last_page, sizeof(slab_last_page));
+#endif
+
+#if LV_USE_MEM_TRACK
+    lv_memset_00(track_sites, sizeof(track_sites));
+    lv_memset_00(&track_hist, sizeof(track_hist));
+#endif
+
 #if LV_MEM_ADD_JUNK
     LV_LOG_WARN("LV_MEM_ADD_JUNK is enabled which makes LVGL much slower");
 #endif
@@ -122,44 +206,19 @@ void lv_mem_deinit(void)
  * @param size size of the memory to allocate in bytes
  * @return pointer to the allocated memory
  */
-void * lv_mem_alloc(size_t size)
+void * (lv_mem_alloc)(size_t size)
 {
+#if LV_USE_MEM_TRACK
+    return _lv_mem_alloc_track(size, NULL, 0);
+#else
     MEM_TRACE("allocating %lu bytes", (unsigned long)size);
     if(size == 0) {
         MEM_TRACE("using zero_mem");
         return &zero_mem;
     }
 
-#if LV_MEM_CUSTOM == 0
-    void * alloc = lv_tlsf_malloc(tlsf, size);
-#else
-    void * alloc = LV_MEM_CUSTOM_ALLOC(size);
-#endif
-
-    if(alloc == NULL) {
-        LV_LOG_INFO("couldn't allocate memory (%lu bytes)", (unsigned long)size);
-#if LV_LOG_LEVEL <= LV_LOG_LEVEL_INFO
-        lv_mem_monitor_t mon;
-        lv_mem_monitor(&mon);
-        LV_LOG_INFO("used: %6d (%3d %%), frag: %3d %%, biggest free: %6d",
-                    (int)(mon.total_size - mon.free_size), mon.used_pct, mon.frag_pct,
-                    (int)mon.free_biggest_size);
-#endif
-    }
-#if LV_MEM_ADD_JUNK
-    else {
-        lv_memset(alloc, 0xaa, size);
-    }
-#endif
-
-    if(alloc) {
-#if LV_MEM_CUSTOM == 0
-        cur_used += size;
-        max_used = LV_MAX(cur_used, max_used);
+    return alloc_core(size);
 #endif
-        MEM_TRACE("allocated at %p", alloc);
-    }
-    return alloc;
 }
 
 /**
@@ -172,16 +231,14 @@ void lv_mem_free(void * data)
     if(data == &zero_mem) return;
     if(data == NULL) return;
 
-#if LV_MEM_CUSTOM == 0
-#  if LV_MEM_ADD_JUNK
-    lv_memset(data, 0xbb, lv_tlsf_block_size(data));
-#  endif
-    size_t size = lv_tlsf_free(tlsf, data);
-    if(cur_used > size) cur_used -= size;
-    else cur_used = 0;
-#else
-    LV_MEM_CUSTOM_FREE(data);
+#if LV_USE_MEM_TRACK
+    track_hdr_t * hdr = (track_hdr_t *)data - 1;
+    track_remove(hdr);
+    track_hist.lifetime_cnt[track_hist_index(lv_tick_elaps(hdr->time), 1)]++;
+    data = hdr;
 #endif
+
+    free_core(data);
 }
 
 /**
@@ -191,8 +248,11 @@ void lv_mem_free(void * data)
  * @param new_size the desired new size in byte
  * @return pointer to the new memory
  */
-void * lv_mem_realloc(void * data_p, size_t new_size)
+void * (lv_mem_realloc)(void * data_p, size_t new_size)
 {
+#if LV_USE_MEM_TRACK
+    return _lv_mem_realloc_track(data_p, new_size, NULL, 0);
+#else
     MEM_TRACE("reallocating %p with %lu size", data_p, (unsigned long)new_size);
     if(new_size == 0) {
         MEM_TRACE("using zero_mem");
@@ -200,22 +260,125 @@ void * lv_mem_realloc(void * data_p, size_t new_size)
         return &zero_mem;
     }
 
-    if(data_p == &zero_mem) return lv_mem_alloc(new_size);
+    if(data_p == &zero_mem || data_p == NULL) return lv_mem_alloc(new_size);
 
-#if LV_MEM_CUSTOM == 0
-    void * new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
-#else
-    void * new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
+    return realloc_core(data_p, new_size);
 #endif
-    if(new_p == NULL) {
-        LV_LOG_ERROR("couldn't allocate memory");
-        return NULL;
+}
+
+#if LV_USE_MEM_TRACK
+
+void * _lv_mem_alloc_track(size_t size, const char * file, uint32_t line)
+{
+    MEM_TRACE("allocating %lu bytes", (unsigned long)size);
+    if(size == 0) {
+        MEM_TRACE("using zero_mem");
+        return &zero_mem;
     }
 
-    MEM_TRACE("allocated at %p", new_p);
-    return new_p;
+    track_hdr_t * hdr = alloc_core(size + TRACK_HDR_SIZE);
+    if(hdr == NULL) return NULL;
+
+    track_add(hdr, size, lv_tick_get(), file, line);
+    track_hist.size_cnt[track_hist_index(size, 8)]++;
+    return hdr + 1;
+}
+
+void * _lv_mem_realloc_track(void * data_p, size_t new_size, const char * file, uint32_t line)
+{
+    MEM_TRACE("reallocating %p with %lu size", data_p, (unsigned long)new_size);
+    if(new_size == 0) {
+        MEM_TRACE("using zero_mem");
+        lv_mem_free(data_p);
+        return &zero_mem;
+    }
+
+    if(data_p == &zero_mem || data_p == NULL) return _lv_mem_alloc_track(new_size, file, line);
+
+    /*It's still the same allocation so keep its age but move it to the new call site.
+     *The header is copied with the data.*/
+    track_hdr_t * hdr = realloc_core((track_hdr_t *)data_p - 1, new_size + TRACK_HDR_SIZE);
+    if(hdr == NULL) return NULL;
+
+    track_remove(hdr);
+    track_add(hdr, new_size, hdr->time, file, line);
+    return hdr + 1;
+}
+
+/**
+ * Get the allocation sites recorded so far
+ * @param cnt store the number of sites here
+ * @return the array of the sites
+ */
+const lv_mem_track_site_t * lv_mem_track_get_sites(uint32_t * cnt)
+{
+    uint32_t i;
+    *cnt = 0;
+    for(i = 0; i < LV_MEM_TRACK_SITE_CNT; i++) {
+        if(track_sites[i].alloc_cnt) (*cnt)++;
+    }
+
+    return track_sites;
 }
 
+/**
+ * Get the histograms of the sizes and the lifetimes of the allocations
+ * @param hist store the histograms here
+ */
+void lv_mem_track_get_hist(lv_mem_track_hist_t * hist)
+{
+    *hist = track_hist;
+}
+
+/**
+ * Log the allocation sites with the most memory in use, the histograms and the memory monitor's data
+ * @param max_site_cnt log at most this many sites
+ */
+void lv_mem_track_dump(uint32_t max_site_cnt)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    LV_LOG_USER("used: %d (%d %%), max used: %d, frag: %d %%, biggest free: %d",
+                (int)(mon.total_size - mon.free_size), mon.used_pct, (int)mon.max_used, mon.frag_pct,
+                (int)mon.free_biggest_size);
+
+    /*Find the sites with the largest live size one by one to not need a buffer for sorting*/
+    uint32_t prev_size = UINT32_MAX;
+    const lv_mem_track_site_t * prev_site = NULL;
+    uint32_t n;
+    for(n = 0; n < max_site_cnt; n++) {
+        const lv_mem_track_site_t * best = NULL;
+        bool prev_passed = prev_site == NULL;
+        uint32_t i;
+        for(i = 0; i < LV_MEM_TRACK_SITE_CNT; i++) {
+            const lv_mem_track_site_t * site = &track_sites[i];
+            if(site == prev_site) {
+                prev_passed = true;
+                continue;
+            }
+            if(site->live_cnt == 0) continue;
+            /*Order the sites with the same size by their index*/
+            if(site->live_size > prev_size || (site->live_size == prev_size && !prev_passed)) continue;
+            if(best == NULL || site->live_size > best->live_size) best = site;
+        }
+        if(best == NULL) break;
+
+        LV_LOG_USER("%s:%d: %d bytes in %d allocations (max. %d bytes), %d allocations in total",
+                    best->file ? best->file : "other", (int)best->line, (int)best->live_size,
+                    (int)best->live_cnt, (int)best->max_live_size, (int)best->alloc_cnt);
+        prev_size = best->live_size;
+        prev_site = best;
+    }
+
+    uint32_t i;
+    for(i = 0; i < LV_MEM_TRACK_HIST_CNT; i++) {
+        LV_LOG_USER("size <= %d: %d, lifetime <= %d ms: %d", 8 << i, (int)track_hist.size_cnt[i], 1 << i,
+                    (int)track_hist.lifetime_cnt[i]);
+    }
+}
+
+#endif /*LV_USE_MEM_TRACK*/
+
 lv_res_t lv_mem_test(void)
 {
     if(zero_mem != ZERO_MEM_SENTINEL) {
@@ -253,7 +416,6 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
     lv_tlsf_walk_pool(lv_tlsf_get_pool(tlsf), lv_mem_walker, mon_p);
 
     mon_p->total_size = LV_MEM_SIZE;
-    mon_p->used_pct = 100 - (100U * mon_p->free_size) / mon_p->total_size;
     if(mon_p->free_size > 0) {
         mon_p->frag_pct = mon_p->free_biggest_size * 100U / mon_p->free_size;
         mon_p->frag_pct = 100 - mon_p->frag_pct;
@@ -262,6 +424,28 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
         mon_p->frag_pct = 0; /*no fragmentation if all the RAM is used*/
     }
 
+#if USE_SLAB
+    /*Count the slots instead of the slab area. Its free slots can't be used for larger allocations
+     *so they don't count in the fragmentation.*/
+    mon_p->used_cnt--;
+    mon_p->slab_size = SLAB_PAGE_CNT * SLAB_PAGE_SIZE;
+    uint32_t i;
+    for(i = 0; i < SLAB_PAGE_CNT; i++) {
+        slab_page_t * page = &slab_pages[i];
+        if(page->class_id == SLAB_CLASS_NONE) {
+            mon_p->slab_free_size += SLAB_PAGE_SIZE;
+        }
+        else {
+            uint32_t slot_size = (page->class_id + 1) * SLAB_SLOT_STEP;
+            mon_p->used_cnt += page->used_cnt;
+            mon_p->slab_free_size += SLAB_PAGE_SIZE - page->used_cnt * slot_size;
+        }
+    }
+    mon_p->free_size += mon_p->slab_free_size;
+#endif
+
+    mon_p->used_pct = 100 - (100U * mon_p->free_size) / mon_p->total_size;
+
     mon_p->max_used = max_used;
 
     MEM_TRACE("finished");
@@ -546,6 +730,108 @@ void LV_ATTRIBUTE_FAST_MEM lv_memset_ff(void * dst, size_t len)
  *   STATIC FUNCTIONS
  **********************/
 
+static void * alloc_core(size_t size)
+{
+    void * alloc = NULL;
+#if USE_SLAB
+    if(size <= LV_MEM_SLAB_MAX_ALLOC) alloc = slab_alloc(size);
+    if(alloc) size = slab_slot_size(alloc);
+#endif
+
+    if(alloc == NULL) {
+#if LV_MEM_CUSTOM == 0
+        alloc = lv_tlsf_malloc(tlsf, size);
+#else
+        alloc = LV_MEM_CUSTOM_ALLOC(size);
+#endif
+    }
+
+    if(alloc == NULL) {
+        LV_LOG_INFO("couldn't allocate memory (%lu bytes)", (unsigned long)size);
+#if LV_LOG_LEVEL <= LV_LOG_LEVEL_INFO
+        lv_mem_monitor_t mon;
+        lv_mem_monitor(&mon);
+        LV_LOG_INFO("used: %6d (%3d %%), frag: %3d %%, biggest free: %6d",
+                    (int)(mon.total_size - mon.free_size), mon.used_pct, mon.frag_pct,
+                    (int)mon.free_biggest_size);
+#endif
+    }
+#if LV_MEM_ADD_JUNK
+    else {
+        lv_memset(alloc, 0xaa, size);
+    }
+#endif
+
+    if(alloc) {
+#if LV_MEM_CUSTOM == 0
+        cur_used += size;
+        max_used = LV_MAX(cur_used, max_used);
+#endif
+        MEM_TRACE("allocated at %p", alloc);
+    }
+    return alloc;
+}
+
+static void free_core(void * data)
+{
+#if LV_MEM_CUSTOM == 0
+    size_t size;
+#if USE_SLAB
+    if(is_slab(data)) {
+        size = slab_slot_size(data);
+#  if LV_MEM_ADD_JUNK
+        lv_memset(data, 0xbb, size);
+#  endif
+        slab_free(data);
+    }
+    else
+#endif
+    {
+#  if LV_MEM_ADD_JUNK
+        lv_memset(data, 0xbb, lv_tlsf_block_size(data));
+#  endif
+        size = lv_tlsf_free(tlsf, data);
+    }
+    if(cur_used > size) cur_used -= size;
+    else cur_used = 0;
+#else
+    LV_MEM_CUSTOM_FREE(data);
+#endif
+}
+
+static void * realloc_core(void * data_p, size_t new_size)
+{
+    void * new_p;
+#if USE_SLAB
+    if(is_slab(data_p)) {
+        /*Stay in the slot if it's large enough, else move to a new place*/
+        uint32_t slot_size = slab_slot_size(data_p);
+        if(new_size <= slot_size) return data_p;
+
+        new_p = alloc_core(new_size);
+        if(new_p) {
+            lv_memcpy(new_p, data_p, slot_size);
+            free_core(data_p);
+        }
+    }
+    else {
+        new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
+    }
+#elif LV_MEM_CUSTOM == 0
+    new_p = lv_tlsf_realloc(tlsf, data_p, new_size);
+#else
+    new_p = LV_MEM_CUSTOM_REALLOC(data_p, new_size);
+#endif
+
+    if(new_p == NULL) {
+        LV_LOG_ERROR("couldn't allocate memory");
+        return NULL;
+    }
+
+    MEM_TRACE("allocated at %p", new_p);
+    return new_p;
+}
+
 #if LV_MEM_CUSTOM == 0
 static void lv_mem_walker(void * ptr, size_t size, int used, void * user)
 {
@@ -563,3 +849,144 @@ static void lv_mem_walker(void * ptr, size_t size, int used, void * user)
     }
 }
 #endif
+
+#if USE_SLAB
+/**
+ * Get a slot for a small allocation. First try the page used last time for this size class,
+ * then the other pages of the size class, then an empty page.
+ * @param size the size of the allocation, at most `LV_MEM_SLAB_MAX_ALLOC`
+ * @return pointer to the slot or NULL if the slab area is full
+ */
+static void * slab_alloc(size_t size)
+{
+    uint32_t class_id = (size - 1) / SLAB_SLOT_STEP;
+    uint32_t slot_size = (class_id + 1) * SLAB_SLOT_STEP;
+
+    slab_page_t * page = &slab_pages[slab_last_page[class_id]];
+    if(page->class_id != class_id || (page->free_list == NULL && page->unused_ofs + slot_size > SLAB_PAGE_SIZE)) {
+        page = NULL;
+        slab_page_t * empty_page = NULL;
+        uint32_t i;
+        for(i = 0; i < SLAB_PAGE_CNT; i++) {
+            slab_page_t * p = &slab_pages[i];
+            if(p->class_id == class_id) {
+                if(p->free_list || p->unused_ofs + slot_size <= SLAB_PAGE_SIZE) {
+                    page = p;
+                    break;
+                }
+            }
+            else if(p->class_id == SLAB_CLASS_NONE && empty_page == NULL) {
+                empty_page = p;
+            }
+        }
+
+        if(page == NULL) {
+            if(empty_page == NULL) return NULL;
+            page = empty_page;
+            page->class_id = class_id;
+            page->free_list = NULL;
+            page->unused_ofs = 0;
+        }
+        slab_last_page[class_id] = page - slab_pages;
+    }
+
+    void * slot;
+    if(page->free_list) {
+        slot = page->free_list;
+        page->free_list = *(void **)slot;
+    }
+    else {
+        slot = slab_area + (page - slab_pages) * SLAB_PAGE_SIZE + page->unused_ofs;
+        page->unused_ofs += slot_size;
+    }
+    page->used_cnt++;
+
+    return slot;
+}
+
+/**
+ * Give back a slot to its page. The page becomes free for any size class when all of its slots are freed.
+ * @param data pointer to a slot
+ */
+static void slab_free(void * data)
+{
+    slab_page_t * page = &slab_pages[((uint8_t *)data - slab_area) / SLAB_PAGE_SIZE];
+    *(void **)data = page->free_list;
+    page->free_list = data;
+    page->used_cnt--;
+    if(page->used_cnt == 0) page->class_id = SLAB_CLASS_NONE;
+}
+
+static inline bool is_slab(const void * data)
+{
+    return (const uint8_t *)data >= slab_area && (const uint8_t *)data < slab_area + SLAB_PAGE_CNT * SLAB_PAGE_SIZE;
+}
+
+static inline uint32_t slab_slot_size(const void * data)
+{
+    slab_page_t * page = &slab_pages[((const uint8_t *)data - slab_area) / SLAB_PAGE_SIZE];
+    return (page->class_id + 1) * SLAB_SLOT_STEP;
+}
+#endif /*USE_SLAB*/
+
+#if LV_USE_MEM_TRACK
+/**
+ * Store an allocation in its header and add it to its site
+ * @param hdr the header of the allocation
+ * @param size the size asked by the caller
+ * @param time the tick when the allocation was made
+ * @param file the file of the call, NULL if unknown
+ * @param line the line of the call
+ */
+static void track_add(track_hdr_t * hdr, uint32_t size, uint32_t time, const char * file, uint32_t line)
+{
+    /*Open addressing on the file and line. If the table is full, the last site collects the rest.*/
+    uint32_t id = (((lv_uintptr_t)file >> 2) ^ (line * 31)) % (LV_MEM_TRACK_SITE_CNT - 1);
+    uint32_t i;
+    for(i = 0; i < LV_MEM_TRACK_SITE_CNT - 1; i++) {
+        lv_mem_track_site_t * site = &track_sites[id];
+        if(site->alloc_cnt == 0) {
+            site->file = file;
+            site->line = line;
+            break;
+        }
+        if(site->file == file && site->line == line) break;
+        id++;
+        if(id == LV_MEM_TRACK_SITE_CNT - 1) id = 0;
+    }
+    if(i == LV_MEM_TRACK_SITE_CNT - 1) id = LV_MEM_TRACK_SITE_CNT - 1;
+
+    lv_mem_track_site_t * site = &track_sites[id];
+    site->alloc_cnt++;
+    site->live_cnt++;
+    site->live_size += size;
+    site->max_live_size = LV_MAX(site->max_live_size, site->live_size);
+
+    hdr->size = size;
+    hdr->time = time;
+    hdr->site_id = id;
+}
+
+static void track_remove(track_hdr_t * hdr)
+{
+    lv_mem_track_site_t * site = &track_sites[hdr->site_id];
+    site->live_cnt--;
+    site->live_size -= hdr->size;
+}
+
+/**
+ * Get the index of a value in a histogram where each limit is twice the previous
+ * @param v the value
+ * @param limit the first limit
+ * @return the index of the first limit which is not smaller than `v`, or the last index
+ */
+static uint32_t track_hist_index(uint32_t v, uint32_t limit)
+{
+    uint32_t i = 0;
+    while(v > limit && i < LV_MEM_TRACK_HIST_CNT - 1) {
+        limit <<= 1;
+        i++;
+    }
+    return i;
+}
+#endif /*LV_USE_MEM_TRACK*/
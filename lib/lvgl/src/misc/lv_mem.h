@@ -24,6 +24,10 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+#if LV_USE_MEM_TRACK
+/*Number of steps in the histograms of `lv_mem_track_hist_t`*/
+#define LV_MEM_TRACK_HIST_CNT   16
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -39,10 +43,36 @@ typedef struct {
     uint32_t free_biggest_size;
     uint32_t used_cnt;
     uint32_t max_used; /**< Max size of Heap memory used*/
+    uint32_t slab_size; /**< Size of the area of the small allocations (`LV_MEM_SLAB_SIZE`)*/
+    uint32_t slab_free_size; /**< Free part of `slab_size`. Also included in `free_size`*/
     uint8_t used_pct; /**< Percentage used*/
-    uint8_t frag_pct; /**< Amount of fragmentation*/
+    uint8_t frag_pct; /**< Amount of fragmentation, without the slab area*/
 } lv_mem_monitor_t;
 
+#if LV_USE_MEM_TRACK
+/**
+ * The allocations made at a line of a file.
+ */
+typedef struct {
+    const char * file;      /**< File of the call. NULL: unknown or any call if the site table was full*/
+    uint32_t line;          /**< Line of the call*/
+    uint32_t alloc_cnt;     /**< Number of allocations and reallocations made here*/
+    uint32_t live_cnt;      /**< Number of the allocations which are not freed yet*/
+    uint32_t live_size;     /**< Total size of the allocations which are not freed yet*/
+    uint32_t max_live_size; /**< The largest `live_size` so far*/
+} lv_mem_track_site_t;
+
+/**
+ * Histograms of all allocations.
+ */
+typedef struct {
+    uint32_t size_cnt[LV_MEM_TRACK_HIST_CNT];       /**< Number of allocations with size <= 8, 16, 32, ... bytes.
+                                                         The last one counts the larger allocations too*/
+    uint32_t lifetime_cnt[LV_MEM_TRACK_HIST_CNT];   /**< Number of freed allocations which lived <= 1, 2, 4, ... ms.
+                                                         The last one counts the longer lifetimes too*/
+} lv_mem_track_hist_t;
+#endif
+
 typedef struct {
     void * p;
     uint16_t size;
@@ -118,6 +148,38 @@ void lv_mem_buf_release(void * p);
  */
 void lv_mem_buf_free_all(void);
 
+#if LV_USE_MEM_TRACK
+
+void * _lv_mem_alloc_track(size_t size, const char * file, uint32_t line);
+
+void * _lv_mem_realloc_track(void * data_p, size_t new_size, const char * file, uint32_t line);
+
+/*Record where the memories are allocated*/
+#define lv_mem_alloc(size) _lv_mem_alloc_track(size, __FILE__, __LINE__)
+#define lv_mem_realloc(data_p, new_size) _lv_mem_realloc_track(data_p, new_size, __FILE__, __LINE__)
+
+/**
+ * Get the allocation sites recorded so far
+ * @param cnt store the number of sites here
+ * @return the array of the sites. It has `LV_MEM_TRACK_SITE_CNT` elements but only the ones
+ *         with non-zero `alloc_cnt` are used.
+ */
+const lv_mem_track_site_t * lv_mem_track_get_sites(uint32_t * cnt);
+
+/**
+ * Get the histograms of the sizes and the lifetimes of the allocations
+ * @param hist store the histograms here
+ */
+void lv_mem_track_get_hist(lv_mem_track_hist_t * hist);
+
+/**
+ * Log the allocation sites with the most memory in use, the histograms and the memory monitor's data
+ * @param max_site_cnt log at most this many sites
+ */
+void lv_mem_track_dump(uint32_t max_site_cnt);
+
+#endif /*LV_USE_MEM_TRACK*/
+
 //! @cond Doxygen_Suppress
 
 #if LV_MEMCPY_MEMSET_STD
@@ -139,6 +139,7 @@ uint32_t _lv_style_custom_prop_flag_lookup_table_size = 0;
 
 static uint16_t last_custom_prop_id = (uint16_t)_LV_STYLE_LAST_BUILT_IN_PROP;
 static const lv_style_value_t null_style_value = { .num = 0 };
+static uint32_t style_version;
 
 /**********************
  *      MACROS
@@ -173,6 +174,7 @@ void lv_style_reset(lv_style_t * style)
 
     if(style->prop_cnt > 1) lv_mem_free(style->v_p.values_and_props);
     lv_memset_00(style, sizeof(lv_style_t));
+    style_version++;
 #if LV_USE_ASSERT_STYLE
     style->sentinel = LV_STYLE_SENTINEL_VALUE;
 #endif
@@ -234,6 +236,7 @@ bool lv_style_remove_prop(lv_style_t * style, lv_style_prop_t prop)
         if(LV_STYLE_PROP_ID_MASK(style->prop1) == prop) {
             style->prop1 = LV_STYLE_PROP_INV;
             style->prop_cnt = 0;
+            style_version++;
             return true;
         }
         return false;
@@ -273,6 +276,7 @@ bool lv_style_remove_prop(lv_style_t * style, lv_style_prop_t prop)
             }
 
             lv_mem_free(old_values);
+            style_version++;
             return true;
         }
     }
@@ -295,6 +299,11 @@ lv_style_res_t lv_style_get_prop(const lv_style_t * style, lv_style_prop_t prop,
     return lv_style_get_prop_inlined(style, prop, value);
 }
 
+uint32_t _lv_style_get_version(void)
+{
+    return style_version;
+}
+
 void lv_style_transition_dsc_init(lv_style_transition_dsc_t * tr, const lv_style_prop_t props[],
                                   lv_anim_path_cb_t path_cb, uint32_t time, uint32_t delay, void * user_data)
 {
@@ -422,6 +431,8 @@ static void lv_style_set_prop_internal(lv_style_t * style, lv_style_prop_t prop_
         return;
     }
 
+    style_version++;
+
     lv_style_prop_t prop_id = LV_STYLE_PROP_ID_MASK(prop_and_meta);
 
     if(style->prop_cnt > 1) {
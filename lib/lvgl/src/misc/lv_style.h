@@ -518,6 +518,13 @@ uint8_t _lv_style_get_prop_group(lv_style_prop_t prop);
  */
 uint8_t _lv_style_prop_lookup_flags(lv_style_prop_t prop);
 
+/**
+ * Get a counter which is incremented when a property is set in or removed from any style.
+ * It tells if the values resolved from the styles earlier might be outdated.
+ * @return the current value of the counter
+ */
+uint32_t _lv_style_get_version(void);
+
 #include "lv_style_gen.h"
 
 static inline void lv_style_set_size(lv_style_t * style, lv_coord_t value)
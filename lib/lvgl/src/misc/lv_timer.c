@@ -10,6 +10,7 @@
 #include "lv_assert.h"
 #include "lv_mem.h"
 #include "lv_ll.h"
+#include "lv_math.h"
 #include "lv_gc.h"
 
 /*********************
@@ -17,6 +18,10 @@
  *********************/
 #define IDLE_MEAS_PERIOD 500 /*[ms]*/
 #define DEF_PERIOD 500
+#define HEAP_MIN_CAP 8
+
+/*Deadlines are compared with wrap around so longer periods are clamped to this*/
+#define MAX_PERIOD 0x7FFFFFFF
 
 /**********************
  *      TYPEDEFS
@@ -25,8 +30,15 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static bool lv_timer_exec(lv_timer_t * timer);
-static uint32_t lv_timer_time_remaining(lv_timer_t * timer);
+static void lv_timer_exec(lv_timer_t * timer);
+static void timer_reschedule(lv_timer_t * timer);
+static bool heap_reserve(uint32_t cnt);
+static void heap_insert(lv_timer_t * timer);
+static void heap_remove(lv_timer_t * timer);
+static void heap_update(uint32_t idx);
+static void heap_sift_up(uint32_t idx);
+static void heap_sift_down(uint32_t idx);
+static bool heap_less(const lv_timer_t * a, const lv_timer_t * b);
 
 /**********************
  *  STATIC VARIABLES
@@ -34,7 +46,16 @@ static uint32_t lv_timer_time_remaining(lv_timer_t * timer);
 static bool lv_timer_run = false;
 static uint8_t idle_last = 0;
 static bool timer_deleted;
-static bool timer_created;
+
+/*The not paused timers are stored in `_lv_timer_heap` as a binary min-heap ordered by their deadline.
+ *The timers which already ran in the current `lv_timer_handler()` call are parked right after the heap
+ *and put back only at the end of the call, so every timer runs at most once per call.
+ *The array has room for all timers, therefore resuming and rescheduling can't fail.*/
+static uint32_t heap_cnt;
+static uint32_t ran_cnt;
+static uint32_t heap_cap;
+static uint32_t timer_cnt;
+static uint32_t create_cnt;
 
 /**********************
  *      MACROS
@@ -45,6 +66,8 @@ static bool timer_created;
     #define TIMER_TRACE(...)
 #endif
 
+#define HEAP (LV_GC_ROOT(_lv_timer_heap))
+
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
@@ -55,6 +78,11 @@ static bool timer_created;
 void _lv_timer_core_init(void)
 {
     _lv_ll_init(&LV_GC_ROOT(_lv_timer_ll), sizeof(lv_timer_t));
+    HEAP = NULL;
+    heap_cnt = 0;
+    ran_cnt = 0;
+    heap_cap = 0;
+    timer_cnt = 0;
 
     /*Initially enable the lv_timer handling*/
     lv_timer_enable(true);
@@ -95,41 +123,35 @@ uint32_t LV_ATTRIBUTE_TIMER_HANDLER lv_timer_handler(void)
         }
     }
 
-    /*Run all timer from the list*/
-    lv_timer_t * next;
-    do {
-        timer_deleted             = false;
-        timer_created             = false;
-        LV_GC_ROOT(_lv_timer_act) = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-        while(LV_GC_ROOT(_lv_timer_act)) {
-            /*The timer might be deleted if it runs only once ('repeat_count = 1')
-             *So get next element until the current is surely valid*/
-            next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), LV_GC_ROOT(_lv_timer_act));
-
-            if(lv_timer_exec(LV_GC_ROOT(_lv_timer_act))) {
-                /*If a timer was created or deleted then this or the next item might be corrupted*/
-                if(timer_created || timer_deleted) {
-                    TIMER_TRACE("Start from the first timer again because a timer was created or deleted");
-                    break;
-                }
-            }
-
-            LV_GC_ROOT(_lv_timer_act) = next; /*Load the next timer*/
-        }
-    } while(LV_GC_ROOT(_lv_timer_act));
-
-    uint32_t time_till_next = LV_NO_TIMER_READY;
-    next = _lv_ll_get_head(&LV_GC_ROOT(_lv_timer_ll));
-    while(next) {
-        if(!next->paused) {
-            uint32_t delay = lv_timer_time_remaining(next);
-            if(delay < time_till_next)
-                time_till_next = delay;
-        }
+    /*Run the due timers in the order of their deadlines*/
+    ran_cnt = 0;
+    while(heap_cnt > 0) {
+        lv_timer_t * timer = HEAP[0];
+        if((int32_t)(timer->deadline - lv_tick_get()) > 0) break;
 
-        next = _lv_ll_get_next(&LV_GC_ROOT(_lv_timer_ll), next); /*Find the next timer*/
+        /*Park it after the heap until the end of this call*/
+        heap_remove(timer);
+        HEAP[heap_cnt + ran_cnt] = timer;
+        timer->heap_idx = heap_cnt + ran_cnt;
+        ran_cnt++;
+
+        LV_GC_ROOT(_lv_timer_act) = timer;
+        lv_timer_exec(timer);
+    }
+    LV_GC_ROOT(_lv_timer_act) = NULL;
+
+    /*Put back the timers which ran. The first parked timer is right after the heap
+     *so it's enough to extend the heap and move the timer up.*/
+    while(ran_cnt > 0) {
+        lv_timer_t * timer = HEAP[heap_cnt];
+        timer->deadline = timer->last_run + LV_MIN(timer->period, MAX_PERIOD);
+        heap_cnt++;
+        ran_cnt--;
+        heap_sift_up(heap_cnt - 1);
     }
 
+    uint32_t time_till_next = lv_timer_get_time_till_next();
+
     busy_time += lv_tick_elaps(handler_start);
     uint32_t idle_period_time = lv_tick_elaps(idle_period_start);
     if(idle_period_time >= IDLE_MEAS_PERIOD) {
@@ -168,9 +190,15 @@ lv_timer_t * lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void * us
 {
     lv_timer_t * new_timer = NULL;
 
+    if(!heap_reserve(timer_cnt + 1)) {
+        LV_ASSERT_MALLOC(NULL);
+        return NULL;
+    }
+
     new_timer = _lv_ll_ins_head(&LV_GC_ROOT(_lv_timer_ll));
     LV_ASSERT_MALLOC(new_timer);
     if(new_timer == NULL) return NULL;
+    timer_cnt++;
 
     new_timer->period = period;
     new_timer->timer_cb = timer_xcb;
@@ -178,8 +206,9 @@ lv_timer_t * lv_timer_create(lv_timer_cb_t timer_xcb, uint32_t period, void * us
     new_timer->paused = 0;
     new_timer->last_run = lv_tick_get();
     new_timer->user_data = user_data;
-
-    timer_created = true;
+    new_timer->create_id = create_cnt++;
+    new_timer->deadline = new_timer->last_run + LV_MIN(period, MAX_PERIOD);
+    heap_insert(new_timer);
 
     return new_timer;
 }
@@ -200,10 +229,21 @@ void lv_timer_set_cb(lv_timer_t * timer, lv_timer_cb_t timer_cb)
  */
 void lv_timer_del(lv_timer_t * timer)
 {
+    if(!timer->paused) heap_remove(timer);
     _lv_ll_remove(&LV_GC_ROOT(_lv_timer_ll), timer);
-    timer_deleted = true;
+    timer_cnt--;
+    if(timer == LV_GC_ROOT(_lv_timer_act)) timer_deleted = true;
 
     lv_mem_free(timer);
+
+    /*Shrink the heap if it's much larger than needed*/
+    if(heap_cap > HEAP_MIN_CAP && timer_cnt < heap_cap / 4) {
+        lv_timer_t ** new_heap = lv_mem_realloc(HEAP, (heap_cap / 2) * sizeof(lv_timer_t *));
+        if(new_heap) {
+            HEAP = new_heap;
+            heap_cap = heap_cap / 2;
+        }
+    }
 }
 
 /**
@@ -212,12 +252,19 @@ void lv_timer_del(lv_timer_t * timer)
  */
 void lv_timer_pause(lv_timer_t * timer)
 {
+    if(timer->paused) return;
+
+    heap_remove(timer);
     timer->paused = true;
 }
 
 void lv_timer_resume(lv_timer_t * timer)
 {
+    if(!timer->paused) return;
+
     timer->paused = false;
+    timer->deadline = timer->last_run + LV_MIN(timer->period, MAX_PERIOD);
+    heap_insert(timer);
 }
 
 /**
@@ -228,6 +275,7 @@ void lv_timer_resume(lv_timer_t * timer)
 void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 {
     timer->period = period;
+    timer_reschedule(timer);
 }
 
 /**
@@ -237,6 +285,7 @@ void lv_timer_set_period(lv_timer_t * timer, uint32_t period)
 void lv_timer_ready(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get() - timer->period - 1;
+    timer_reschedule(timer);
 }
 
 /**
@@ -247,6 +296,12 @@ void lv_timer_ready(lv_timer_t * timer)
 void lv_timer_set_repeat_count(lv_timer_t * timer, int32_t repeat_count)
 {
     timer->repeat_count = repeat_count;
+
+    /*Make it due now to get it deleted in the next `lv_timer_handler()` call*/
+    if(repeat_count == 0 && !timer->paused && timer->heap_idx < heap_cnt) {
+        timer->deadline = lv_tick_get();
+        heap_update(timer->heap_idx);
+    }
 }
 
 /**
@@ -257,6 +312,7 @@ void lv_timer_set_repeat_count(lv_timer_t * timer, int32_t repeat_count)
 void lv_timer_reset(lv_timer_t * timer)
 {
     timer->last_run = lv_tick_get();
+    timer_reschedule(timer);
 }
 
 /**
@@ -277,6 +333,18 @@ uint8_t lv_timer_get_idle(void)
     return idle_last;
 }
 
+/**
+ * Get the time until the next timer is due.
+ * @return the time in ms, 0 if a timer is already due, or `LV_NO_TIMER_READY` if there are no running timers
+ */
+uint32_t lv_timer_get_time_till_next(void)
+{
+    if(heap_cnt == 0) return LV_NO_TIMER_READY;
+
+    int32_t remaining = (int32_t)(HEAP[0]->deadline - lv_tick_get());
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
 /**
  * Iterate through the timers
  * @param timer NULL to start iteration or the previous return value to get the next timer
@@ -293,28 +361,22 @@ lv_timer_t * lv_timer_get_next(lv_timer_t * timer)
  **********************/
 
 /**
- * Execute timer if its remaining time is zero
+ * Execute a due timer and delete it if its repeat count is over
  * @param timer pointer to lv_timer
- * @return true: execute, false: not executed
  */
-static bool lv_timer_exec(lv_timer_t * timer)
+static void lv_timer_exec(lv_timer_t * timer)
 {
-    if(timer->paused) return false;
-
-    bool exec = false;
-    if(lv_timer_time_remaining(timer) == 0) {
-        /* Decrement the repeat count before executing the timer_cb.
-         * If any timer is deleted `if(timer->repeat_count == 0)` is not executed below
-         * but at least the repeat count is zero and the timer can be deleted in the next round*/
-        int32_t original_repeat_count = timer->repeat_count;
-        if(timer->repeat_count > 0) timer->repeat_count--;
-        timer->last_run = lv_tick_get();
-        TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
-        if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
-        TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
-        LV_ASSERT_MEM_INTEGRITY();
-        exec = true;
-    }
+    /* Decrement the repeat count before executing the timer_cb.
+     * If the timer is deleted `if(timer->repeat_count == 0)` is not executed below
+     * but at least the repeat count is zero and the timer can be deleted in the next round*/
+    int32_t original_repeat_count = timer->repeat_count;
+    if(timer->repeat_count > 0) timer->repeat_count--;
+    timer->last_run = lv_tick_get();
+    timer_deleted = false;
+    TIMER_TRACE("calling timer callback: %p", *((void **)&timer->timer_cb));
+    if(timer->timer_cb && original_repeat_count != 0) timer->timer_cb(timer);
+    TIMER_TRACE("timer callback %p finished", *((void **)&timer->timer_cb));
+    LV_ASSERT_MEM_INTEGRITY();
 
     if(timer_deleted == false) { /*The timer might be deleted by itself as well*/
         if(timer->repeat_count == 0) { /*The repeat count is over, delete the timer*/
@@ -322,20 +384,136 @@ static bool lv_timer_exec(lv_timer_t * timer)
             lv_timer_del(timer);
         }
     }
+}
 
-    return exec;
+/**
+ * Update the position of a timer in the heap after its period or last run has changed.
+ * The timers parked in `lv_timer_handler()` get their deadline when they are put back.
+ * @param timer pointer to lv_timer
+ */
+static void timer_reschedule(lv_timer_t * timer)
+{
+    if(timer->paused || timer->heap_idx >= heap_cnt) return;
+
+    timer->deadline = timer->last_run + LV_MIN(timer->period, MAX_PERIOD);
+    heap_update(timer->heap_idx);
 }
 
 /**
- * Find out how much time remains before a timer must be run.
+ * Make sure the heap has room for `cnt` timers
+ * @param cnt number of timers
+ * @return true: success; false: out of memory
+ */
+static bool heap_reserve(uint32_t cnt)
+{
+    if(cnt <= heap_cap) return true;
+
+    uint32_t new_cap = heap_cap ? heap_cap * 2 : HEAP_MIN_CAP;
+    lv_timer_t ** new_heap = lv_mem_realloc(HEAP, new_cap * sizeof(lv_timer_t *));
+    if(new_heap == NULL) return false;
+
+    HEAP = new_heap;
+    heap_cap = new_cap;
+    return true;
+}
+
+/**
+ * Add a timer to the heap. There must be room for it (see `heap_reserve()`).
  * @param timer pointer to lv_timer
- * @return the time remaining, or 0 if it needs to be run again
  */
-static uint32_t lv_timer_time_remaining(lv_timer_t * timer)
+static void heap_insert(lv_timer_t * timer)
+{
+    /*Move the first parked timer to the end of the parked ones to make room*/
+    if(ran_cnt > 0) {
+        lv_timer_t * parked = HEAP[heap_cnt];
+        HEAP[heap_cnt + ran_cnt] = parked;
+        parked->heap_idx = heap_cnt + ran_cnt;
+    }
+
+    HEAP[heap_cnt] = timer;
+    timer->heap_idx = heap_cnt;
+    heap_cnt++;
+    heap_sift_up(heap_cnt - 1);
+}
+
+/**
+ * Remove a timer from the heap or from the parked timers
+ * @param timer pointer to lv_timer
+ */
+static void heap_remove(lv_timer_t * timer)
+{
+    uint32_t idx = timer->heap_idx;
+
+    if(idx >= heap_cnt) {
+        /*It's a parked timer, fill its slot with the last parked one*/
+        ran_cnt--;
+        lv_timer_t * last = HEAP[heap_cnt + ran_cnt];
+        HEAP[idx] = last;
+        last->heap_idx = idx;
+        return;
+    }
+
+    heap_cnt--;
+    if(idx != heap_cnt) {
+        lv_timer_t * last = HEAP[heap_cnt];
+        HEAP[idx] = last;
+        last->heap_idx = idx;
+        heap_update(idx);
+    }
+
+    /*The heap got shorter so move the last parked timer to the freed slot*/
+    if(ran_cnt > 0) {
+        lv_timer_t * parked = HEAP[heap_cnt + ran_cnt];
+        HEAP[heap_cnt] = parked;
+        parked->heap_idx = heap_cnt;
+    }
+}
+
+static void heap_update(uint32_t idx)
+{
+    if(idx > 0 && heap_less(HEAP[idx], HEAP[(idx - 1) / 2])) heap_sift_up(idx);
+    else heap_sift_down(idx);
+}
+
+static void heap_sift_up(uint32_t idx)
+{
+    lv_timer_t * timer = HEAP[idx];
+    while(idx > 0) {
+        uint32_t parent = (idx - 1) / 2;
+        if(!heap_less(timer, HEAP[parent])) break;
+        HEAP[idx] = HEAP[parent];
+        HEAP[idx]->heap_idx = idx;
+        idx = parent;
+    }
+    HEAP[idx] = timer;
+    timer->heap_idx = idx;
+}
+
+static void heap_sift_down(uint32_t idx)
+{
+    lv_timer_t * timer = HEAP[idx];
+    while(1) {
+        uint32_t child = idx * 2 + 1;
+        if(child >= heap_cnt) break;
+        if(child + 1 < heap_cnt && heap_less(HEAP[child + 1], HEAP[child])) child++;
+        if(!heap_less(HEAP[child], timer)) break;
+        HEAP[idx] = HEAP[child];
+        HEAP[idx]->heap_idx = idx;
+        idx = child;
+    }
+    HEAP[idx] = timer;
+    timer->heap_idx = idx;
+}
+
+/**
+ * Order of the timers in the heap
+ * @return true: `a` needs to run before `b`
+ */
+static bool heap_less(const lv_timer_t * a, const lv_timer_t * b)
 {
-    /*Check if at least 'period' time elapsed*/
-    uint32_t elp = lv_tick_elaps(timer->last_run);
-    if(elp >= timer->period)
-        return 0;
-    return timer->period - elp;
+    int32_t diff = (int32_t)(a->deadline - b->deadline);
+    if(diff != 0) return diff < 0;
+
+    /*On the same deadline run the newer timer first as the former list based handler did*/
+    return (int32_t)(a->create_id - b->create_id) > 0;
 }
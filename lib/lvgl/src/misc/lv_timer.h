@@ -48,6 +48,9 @@ typedef struct _lv_timer_t {
     void * user_data; /**< Custom user data*/
     int32_t repeat_count; /**< 1: One time;  -1 : infinity;  n>0: residual times*/
     uint32_t paused : 1;
+    uint32_t heap_idx : 31; /**< Position in the timer handler's heap (internal)*/
+    uint32_t deadline; /**< The tick when the timer is due (internal, set by the lv_timer functions)*/
+    uint32_t create_id; /**< Creation order to run the newer timer first on equal deadlines (internal)*/
 } lv_timer_t;
 
 /**********************
@@ -165,6 +168,13 @@ void lv_timer_enable(bool en);
  */
 uint8_t lv_timer_get_idle(void);
 
+/**
+ * Get the time until the next timer is due.
+ * Useful to sleep exactly until `lv_timer_handler()` has something to do.
+ * @return the time in ms, 0 if a timer is already due, or `LV_NO_TIMER_READY` if there are no running timers
+ */
+uint32_t lv_timer_get_time_till_next(void);
+
 /**
  * Iterate through the timers
  * @param timer NULL to start iteration or the previous return value to get the next timer
@@ -0,0 +1,175 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define ANIM_CNT 1000
+
+static int32_t vars[ANIM_CNT];
+static uint32_t ready_cnt;
+static uint32_t deleted_cnt;
+
+void setUp(void)
+{
+    /* Function run before every test */
+    ready_cnt = 0;
+    deleted_cnt = 0;
+}
+
+void tearDown(void)
+{
+    /* Function run after every test */
+    lv_anim_del_all();
+}
+
+static void exec_cb(void * var, int32_t v)
+{
+    *((int32_t *)var) = v;
+}
+
+static void exec_2_cb(void * var, int32_t v)
+{
+    *((int32_t *)var) = -v;
+}
+
+static void ready_cb(lv_anim_t * a)
+{
+    LV_UNUSED(a);
+    ready_cnt++;
+}
+
+static void deleted_cb(lv_anim_t * a)
+{
+    LV_UNUSED(a);
+    deleted_cnt++;
+}
+
+static void replace_other_ready_cb(lv_anim_t * a)
+{
+    ready_cnt++;
+
+    /*Restart the animation of a later variable with a shorter time*/
+    int32_t * other = ((int32_t *)a->var) + ANIM_CNT / 2;
+    lv_anim_t b;
+    lv_anim_init(&b);
+    lv_anim_set_var(&b, other);
+    lv_anim_set_exec_cb(&b, exec_cb);
+    lv_anim_set_values(&b, 0, 50);
+    lv_anim_set_time(&b, 50);
+    lv_anim_start(&b);
+}
+
+static void advance(uint32_t ms)
+{
+    lv_tick_inc(ms);
+    lv_anim_refr_now();
+}
+
+void test_anim_many_concurrent(void)
+{
+    static const lv_anim_path_cb_t paths[] = {
+        lv_anim_path_linear, lv_anim_path_ease_in, lv_anim_path_ease_out, lv_anim_path_ease_in_out,
+        lv_anim_path_overshoot, lv_anim_path_bounce, lv_anim_path_step
+    };
+
+    uint32_t i;
+    for(i = 0; i < ANIM_CNT; i++) {
+        lv_anim_t a;
+        lv_anim_init(&a);
+        lv_anim_set_var(&a, &vars[i]);
+        lv_anim_set_exec_cb(&a, exec_cb);
+        lv_anim_set_values(&a, -(int32_t)i, i * 3);
+        /*Groups of 10 animations with the same timing*/
+        lv_anim_set_time(&a, 100 + (i / 10 % 4) * 50);
+        lv_anim_set_delay(&a, (i / 10 % 3) * 20);
+        lv_anim_set_path_cb(&a, paths[i / 10 % 7]);
+        lv_anim_set_ready_cb(&a, ready_cb);
+        TEST_ASSERT_NOT_NULL(lv_anim_start(&a));
+    }
+    TEST_ASSERT_EQUAL(ANIM_CNT, lv_anim_count_running());
+
+    /*Every value is the same as its path would give on its own*/
+    uint32_t t;
+    for(t = 0; t < 300; t += 7) {
+        advance(7);
+        for(i = 0; i < ANIM_CNT; i++) {
+            lv_anim_t * a = lv_anim_get(&vars[i], exec_cb);
+            if(a == NULL || a->act_time < 0) continue;
+            TEST_ASSERT_EQUAL_INT32(a->path_cb(a), vars[i]);
+        }
+    }
+
+    TEST_ASSERT_EQUAL(0, lv_anim_count_running());
+    TEST_ASSERT_EQUAL(ANIM_CNT, ready_cnt);
+    for(i = 0; i < ANIM_CNT; i++) {
+        TEST_ASSERT_EQUAL_INT32(i * 3, vars[i]);
+    }
+}
+
+void test_anim_change_in_ready_cb(void)
+{
+    uint32_t i;
+    for(i = 0; i < ANIM_CNT; i++) {
+        lv_anim_t a;
+        lv_anim_init(&a);
+        lv_anim_set_var(&a, &vars[i]);
+        lv_anim_set_exec_cb(&a, exec_cb);
+        lv_anim_set_values(&a, 0, 100);
+        lv_anim_set_deleted_cb(&a, deleted_cb);
+        if(i < ANIM_CNT / 2) {
+            lv_anim_set_time(&a, 100);
+            lv_anim_set_ready_cb(&a, replace_other_ready_cb);
+        }
+        else {
+            lv_anim_set_time(&a, 200);
+        }
+        lv_anim_start(&a);
+    }
+
+    /*The first half is ready and replaced the second half's animations*/
+    advance(100);
+    TEST_ASSERT_EQUAL(ANIM_CNT / 2, ready_cnt);
+    TEST_ASSERT_EQUAL(ANIM_CNT, deleted_cnt);
+    TEST_ASSERT_EQUAL(ANIM_CNT / 2, lv_anim_count_running());
+
+    /*The new animations start from the next round*/
+    for(i = ANIM_CNT / 2; i < ANIM_CNT; i++) {
+        TEST_ASSERT_EQUAL_INT32(0, vars[i]);
+    }
+
+    advance(50);
+    TEST_ASSERT_EQUAL(0, lv_anim_count_running());
+    for(i = 0; i < ANIM_CNT; i++) {
+        TEST_ASSERT_EQUAL_INT32(i < ANIM_CNT / 2 ? 100 : 50, vars[i]);
+    }
+}
+
+void test_anim_del(void)
+{
+    uint32_t i;
+    for(i = 0; i < 10; i++) {
+        lv_anim_t a;
+        lv_anim_init(&a);
+        lv_anim_set_var(&a, &vars[i % 2]);
+        lv_anim_set_exec_cb(&a, i < 5 ? exec_cb : exec_2_cb);
+        lv_anim_set_deleted_cb(&a, deleted_cb);
+        lv_anim_set_early_apply(&a, false);
+        lv_anim_start(&a);
+    }
+
+    /*Only one animation is kept for the same variable and exec_cb*/
+    TEST_ASSERT_EQUAL(4, lv_anim_count_running());
+    TEST_ASSERT_EQUAL(6, deleted_cnt);
+
+    TEST_ASSERT_TRUE(lv_anim_del(&vars[0], NULL));
+    TEST_ASSERT_EQUAL(2, lv_anim_count_running());
+    TEST_ASSERT_NULL(lv_anim_get(&vars[0], NULL));
+    TEST_ASSERT_NOT_NULL(lv_anim_get(&vars[1], exec_cb));
+
+    TEST_ASSERT_TRUE(lv_anim_del(NULL, exec_cb));
+    TEST_ASSERT_FALSE(lv_anim_del(&vars[1], exec_cb));
+    TEST_ASSERT_EQUAL(1, lv_anim_count_running());
+    TEST_ASSERT_NOT_NULL(lv_anim_get(&vars[1], exec_2_cb));
+}
+
+#endif
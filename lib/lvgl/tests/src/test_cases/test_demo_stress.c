@@ -18,7 +18,8 @@ void test_demo_stress(void)
 #if LV_USE_DEMO_STRESS
     lv_demo_stress();
 #endif
-    /* loop once to allow objects to be created */
+    /* loop twice to allow objects to be created and the free memory blocks to settle */
+    loop_through_stress_test();
     loop_through_stress_test();
     uint32_t mem_before = lv_test_get_free_mem();
     /* loop 10 more times */
@@ -26,6 +27,38 @@ void test_demo_stress(void)
         loop_through_stress_test();
     }
     TEST_ASSERT_EQUAL(mem_before, lv_test_get_free_mem());
+#if LV_USE_DEMO_STRESS
+    lv_demo_stress_close();
+#endif
+}
+
+void test_demo_stress_peak_and_fragmentation(void)
+{
+#if LV_USE_DEMO_STRESS
+    lv_demo_stress();
+#endif
+    loop_through_stress_test();
+    loop_through_stress_test();
+
+#if LV_MEM_CUSTOM == 0
+    lv_mem_monitor_t mon_before;
+    lv_mem_monitor(&mon_before);
+
+    /* the peak usage shouldn't grow and the free memory shouldn't be split into more parts over time */
+    lv_mem_monitor_t mon;
+    for(uint32_t i = 0; i < 50; i++) {
+        loop_through_stress_test();
+        lv_mem_monitor(&mon);
+        TEST_ASSERT_EQUAL(mon_before.free_size, mon.free_size);
+        TEST_ASSERT_LESS_OR_EQUAL(mon_before.free_cnt, mon.free_cnt);
+        TEST_ASSERT_LESS_OR_EQUAL(mon_before.frag_pct, mon.frag_pct);
+    }
+    TEST_ASSERT_EQUAL(mon_before.max_used, mon.max_used);
+#endif
+
+#if LV_USE_DEMO_STRESS
+    lv_demo_stress_close();
+#endif
 }
 
 #endif
@@ -0,0 +1,157 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+
+#define W       37
+#define H       9
+#define MASK_W  (W + 4)
+
+static lv_color_t dest_buf[W * H];
+static lv_color_t dest_ori[W * H];
+static lv_color_t src_buf[W * H];
+static lv_opa_t mask_buf[MASK_W * H];
+static uint32_t seed;
+
+static uint32_t rnd(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static lv_color_t rnd_color(void)
+{
+    return lv_color_make(rnd() & 0xff, rnd() & 0xff, rnd() & 0xff);
+}
+
+static void init_bufs(void)
+{
+    uint32_t i;
+    for(i = 0; i < W * H; i++) {
+        dest_buf[i] = rnd_color();
+        src_buf[i] = rnd_color();
+    }
+    dest_buf[0] = dest_buf[1];  /*Repeated colors too*/
+    lv_memcpy(dest_ori, dest_buf, sizeof(dest_buf));
+
+    /*Runs of transparent and opaque values with anti-aliased edges*/
+    for(i = 0; i < MASK_W * H; i++) {
+        uint32_t r = rnd() % 8;
+        if(r < 3) mask_buf[i] = LV_OPA_TRANSP;
+        else if(r < 6) mask_buf[i] = LV_OPA_COVER;
+        else mask_buf[i] = rnd() & 0xff;
+        if(i % 16 < 8) mask_buf[i] = (i / 16) % 2 ? LV_OPA_COVER : LV_OPA_TRANSP;
+    }
+}
+
+static void blend(const lv_color_t * src, lv_color_t color, lv_opa_t opa, lv_opa_t * mask)
+{
+    lv_area_t area;
+    lv_area_set(&area, 0, 0, W - 1, H - 1);
+
+    lv_draw_ctx_t draw_ctx;
+    lv_memset_00(&draw_ctx, sizeof(draw_ctx));
+    draw_ctx.buf = dest_buf;
+    draw_ctx.buf_area = &area;
+    draw_ctx.clip_area = &area;
+
+    lv_draw_sw_blend_dsc_t dsc;
+    lv_memset_00(&dsc, sizeof(dsc));
+    dsc.blend_area = &area;
+    dsc.src_buf = src;
+    dsc.color = color;
+    dsc.opa = opa;
+    dsc.mask_buf = mask;
+    dsc.mask_area = &area;
+    dsc.mask_res = mask ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
+    dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+
+    _lv_refr_set_disp_refreshing(lv_disp_get_default());
+    lv_draw_sw_blend_basic(&draw_ctx, &dsc);
+    _lv_refr_set_disp_refreshing(NULL);
+}
+
+/*The expected result is calculated pixel by pixel with `lv_color_mix()`*/
+static void check(const lv_color_t * src, lv_color_t color, lv_opa_t opa, const lv_opa_t * mask)
+{
+    uint32_t x;
+    uint32_t y;
+    for(y = 0; y < H; y++) {
+        for(x = 0; x < W; x++) {
+            uint32_t i = y * W + x;
+            lv_color_t fg = src ? src[i] : color;
+            lv_color_t bg = dest_ori[i];
+            lv_color_t res;
+            lv_opa_t m = mask ? mask[y * W + x] : LV_OPA_COVER;
+            /*Images with mask are handled as opaque only from `LV_OPA_MAX + 1`*/
+            bool opa_cover = src && mask ? opa > LV_OPA_MAX : opa >= LV_OPA_MAX;
+
+            if(m == LV_OPA_TRANSP) res = bg;
+            else if(opa_cover) res = m == LV_OPA_COVER || mask == NULL ? fg : lv_color_mix(fg, bg, m);
+            else {
+                lv_opa_t mask_max = src ? LV_OPA_MAX : LV_OPA_COVER;
+                lv_opa_t opa_tmp = m >= mask_max ? opa : (uint32_t)((uint32_t)m * opa) >> 8;
+                res = lv_color_mix(fg, bg, opa_tmp);
+            }
+
+            if(res.full != dest_buf[i].full) {
+                char msg[64];
+                lv_snprintf(msg, sizeof(msg), "x: %d, y: %d, opa: %d, mask: %d", (int)x, (int)y, opa, m);
+                TEST_FAIL_MESSAGE(msg);
+            }
+        }
+    }
+}
+
+void setUp(void)
+{
+    seed = 1;
+}
+
+void tearDown(void)
+{
+}
+
+void test_draw_sw_blend_fill_mask(void)
+{
+    static const lv_opa_t opas[] = {LV_OPA_COVER, LV_OPA_MAX, LV_OPA_70, LV_OPA_10, 3};
+    uint32_t ofs;
+    uint32_t i;
+    for(ofs = 0; ofs < 4; ofs++) {
+        for(i = 0; i < sizeof(opas); i++) {
+            init_bufs();
+            lv_color_t color = rnd_color();
+            /*Use the stride of the blend area to start the mask rows on different alignments*/
+            blend(NULL, color, opas[i], &mask_buf[ofs]);
+            check(NULL, color, opas[i], &mask_buf[ofs]);
+        }
+    }
+}
+
+void test_draw_sw_blend_map(void)
+{
+    static const lv_opa_t opas[] = {LV_OPA_COVER, LV_OPA_MAX, LV_OPA_70, LV_OPA_10, 3};
+    uint32_t i;
+    for(i = 0; i < sizeof(opas); i++) {
+        init_bufs();
+        blend(src_buf, lv_color_black(), opas[i], NULL);
+        check(src_buf, lv_color_black(), opas[i], NULL);
+    }
+}
+
+void test_draw_sw_blend_map_mask(void)
+{
+    static const lv_opa_t opas[] = {LV_OPA_COVER, LV_OPA_MAX + 1, LV_OPA_MAX, LV_OPA_70, LV_OPA_10, 3};
+    uint32_t ofs;
+    uint32_t i;
+    for(ofs = 0; ofs < 4; ofs++) {
+        for(i = 0; i < sizeof(opas); i++) {
+            init_bufs();
+            blend(src_buf, lv_color_black(), opas[i], &mask_buf[ofs]);
+            check(src_buf, lv_color_black(), opas[i], &mask_buf[ofs]);
+        }
+    }
+}
+
+#endif
@@ -25,7 +25,12 @@
  **********************/
 
 static int compare_fonts(lv_font_t * f1, lv_font_t * f2);
+#if LV_USE_FONT_FMT_TXT_CACHE
+    static uint32_t get_bitmap_size(const lv_font_t * font, uint32_t letter);
+#endif
 void test_font_loader(void);
+void test_font_loader_cached_bitmaps(void);
+void test_font_loader_free_drops_cache(void);
 
 /**********************
  *  STATIC VARIABLES
@@ -72,6 +77,67 @@ void test_font_loader(void)
     lv_font_free(font_3_bin);
 }
 
+void test_font_loader_cached_bitmaps(void)
+{
+#if LV_USE_FONT_FMT_TXT_CACHE
+    /*font_1 is compressed, font_2 has the same glyphs uncompressed*/
+    lv_font_t * font_1_bin = lv_font_load("A:src/test_fonts/font_1.fnt");
+    const lv_font_t * compressed[] = {&font_1, font_1_bin};
+
+    lv_font_fmt_txt_cache_stats_t start;
+    lv_font_fmt_txt_cache_stats_t end;
+    lv_font_get_cache_stats_fmt_txt(&start);
+
+    /*The glyphs don't fit into the cache at once so they are removed and decompressed again*/
+    uint32_t i;
+    uint32_t letter;
+    for(i = 0; i < 3; i++) {
+        for(letter = 0x20; letter < 0x7F; letter++) {
+            uint32_t size = get_bitmap_size(&font_2, letter);
+            TEST_ASSERT_EQUAL(size, get_bitmap_size(&font_1, letter));
+            if(size == 0) continue;
+
+            const uint8_t * ref = lv_font_get_glyph_bitmap(&font_2, letter);
+            uint32_t f;
+            for(f = 0; f < 2; f++) {
+                /*Get it twice to get it from the cache too*/
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(ref, lv_font_get_glyph_bitmap(compressed[f], letter), size);
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(ref, lv_font_get_glyph_bitmap(compressed[f], letter), size);
+            }
+        }
+    }
+
+    lv_font_get_cache_stats_fmt_txt(&end);
+    TEST_ASSERT_GREATER_THAN(0, end.bitmap_hit_cnt - start.bitmap_hit_cnt);
+    TEST_ASSERT_GREATER_THAN(0, end.bitmap_miss_cnt - start.bitmap_miss_cnt);
+    TEST_ASSERT_GREATER_THAN(0, end.id_hit_cnt - start.id_hit_cnt);
+
+    lv_font_free(font_1_bin);
+#endif
+}
+
+void test_font_loader_free_drops_cache(void)
+{
+#if LV_USE_FONT_FMT_TXT_CACHE
+    lv_font_fmt_txt_cache_stats_t start;
+    lv_font_fmt_txt_cache_stats_t end;
+
+    lv_font_t * font_bin = lv_font_load("A:src/test_fonts/font_1.fnt");
+    lv_font_get_glyph_bitmap(font_bin, 'A');
+    lv_font_free(font_bin);
+
+    /*A new font might be loaded to the same address but it can't use the glyphs of the freed one*/
+    font_bin = lv_font_load("A:src/test_fonts/font_3.fnt");
+    lv_font_get_cache_stats_fmt_txt(&start);
+    const uint8_t * bitmap = lv_font_get_glyph_bitmap(font_bin, 'A');
+    lv_font_get_cache_stats_fmt_txt(&end);
+    TEST_ASSERT_EQUAL(1, end.bitmap_miss_cnt - start.bitmap_miss_cnt);
+    uint32_t size = get_bitmap_size(&font_3, 'A');
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(lv_font_get_glyph_bitmap(&font_3, 'A'), bitmap, size);
+    lv_font_free(font_bin);
+#endif
+}
+
 static int compare_fonts(lv_font_t * f1, lv_font_t * f2)
 {
     TEST_ASSERT_NOT_NULL_MESSAGE(f1, "font not null");
@@ -216,5 +282,17 @@ static int compare_fonts(lv_font_t * f1, lv_font_t * f2)
  *   STATIC FUNCTIONS
  **********************/
 
+#if LV_USE_FONT_FMT_TXT_CACHE
+static uint32_t get_bitmap_size(const lv_font_t * font, uint32_t letter)
+{
+    lv_font_glyph_dsc_t g;
+    if(!lv_font_get_glyph_dsc(font, &g, letter, 0)) return 0;
+
+    /*3 bpp glyphs are decompressed to 4 bpp*/
+    uint32_t bpp = g.bpp == 3 ? 4 : g.bpp;
+    return (g.box_w * g.box_h * bpp + 7) / 8;
+}
+#endif
+
 #endif // LV_BUILD_TEST
 
@@ -0,0 +1,182 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+static lv_disp_t * disp;
+static uint32_t px_sum;
+static uint32_t flush_cnt;
+static void (*flush_cb_ori)(struct _lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+
+static void monitor_cb(lv_disp_drv_t * disp_drv, uint32_t time, uint32_t px)
+{
+    LV_UNUSED(disp_drv);
+    LV_UNUSED(time);
+    px_sum += px;
+}
+
+static void counting_flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    flush_cnt++;
+    flush_cb_ori(disp_drv, area, color_p);
+}
+
+static uint32_t inv_px(void)
+{
+    uint32_t px = 0;
+    uint16_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i]) continue;
+        px += lv_area_get_size(&disp->inv_areas[i]);
+    }
+    return px;
+}
+
+static bool inv_covers(const lv_area_t * a)
+{
+    /*Every pixel of `a` has to be in an invalidated area. Check it by rows.*/
+    lv_coord_t y;
+    for(y = a->y1; y <= a->y2; y++) {
+        lv_coord_t x = a->x1;
+        while(x <= a->x2) {
+            lv_coord_t next = x;
+            uint16_t i;
+            for(i = 0; i < disp->inv_p; i++) {
+                const lv_area_t * inv = &disp->inv_areas[i];
+                if(disp->inv_area_joined[i]) continue;
+                if(y < inv->y1 || y > inv->y2 || x < inv->x1 || x > inv->x2) continue;
+                if(inv->x2 + 1 > next) next = inv->x2 + 1;
+            }
+            if(next == x) return false;
+            x = next;
+        }
+    }
+    return true;
+}
+
+static void inv(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h)
+{
+    lv_area_t a;
+    lv_area_set(&a, x, y, x + w - 1, y + h - 1);
+    _lv_inv_area(disp, &a);
+}
+
+void setUp(void)
+{
+    disp = lv_disp_get_default();
+    lv_refr_now(disp);
+    _lv_inv_area(disp, NULL);
+}
+
+void tearDown(void)
+{
+    _lv_inv_area(disp, NULL);
+    disp->driver->monitor_cb = NULL;
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_inv_area_overlapping_areas_are_joined(void)
+{
+    inv(100, 100, 50, 50);
+    inv(120, 120, 50, 50);
+
+    TEST_ASSERT_EQUAL(1, disp->inv_p);
+    TEST_ASSERT_EQUAL(100, disp->inv_areas[0].x1);
+    TEST_ASSERT_EQUAL(100, disp->inv_areas[0].y1);
+    TEST_ASSERT_EQUAL(169, disp->inv_areas[0].x2);
+    TEST_ASSERT_EQUAL(169, disp->inv_areas[0].y2);
+}
+
+void test_inv_area_contained_area_is_dropped(void)
+{
+    inv(10, 10, 10, 10);
+    inv(0, 0, 100, 100);
+    inv(50, 50, 10, 10);
+
+    TEST_ASSERT_EQUAL(1, disp->inv_p);
+    TEST_ASSERT_EQUAL(100 * 100, inv_px());
+}
+
+void test_inv_area_distant_areas_are_kept_apart(void)
+{
+    inv(0, 0, 40, 40);
+    inv(700, 400, 40, 40);
+
+    TEST_ASSERT_EQUAL(2, disp->inv_p);
+    TEST_ASSERT_EQUAL(2 * 40 * 40, inv_px());
+}
+
+void test_inv_area_join_closes_small_gaps(void)
+{
+    /*Two glyph sized areas next to each other are cheaper to draw in one pass*/
+    inv(100, 100, 12, 16);
+    inv(114, 100, 12, 16);
+
+    TEST_ASSERT_EQUAL(1, disp->inv_p);
+    TEST_ASSERT_EQUAL(26 * 16, inv_px());
+}
+
+void test_inv_area_overflow_does_not_invalidate_the_screen(void)
+{
+    lv_area_t areas[96];
+    uint32_t i;
+    uint32_t seed = 1;
+    for(i = 0; i < 96; i++) {
+        seed = seed * 1103515245 + 12345;
+        lv_coord_t x = (seed >> 8) % 780;
+        seed = seed * 1103515245 + 12345;
+        lv_coord_t y = (seed >> 8) % 460;
+        lv_area_set(&areas[i], x, y, x + 9, y + 9);
+        _lv_inv_area(disp, &areas[i]);
+    }
+
+    TEST_ASSERT_LESS_OR_EQUAL(LV_INV_BUF_SIZE, disp->inv_p);
+    for(i = 0; i < 96; i++) {
+        TEST_ASSERT_TRUE(inv_covers(&areas[i]));
+    }
+    /*96 areas of 100 px on a 800x480 screen*/
+    TEST_ASSERT_LESS_THAN(800 * 480 / 2, inv_px());
+}
+
+void test_inv_area_animated_scene(void)
+{
+    /*Arcs and labels updated every frame, like a dashboard on a small panel*/
+    lv_obj_t * arcs[12];
+    lv_obj_t * labels[24];
+    uint32_t i;
+    for(i = 0; i < 12; i++) {
+        arcs[i] = lv_arc_create(lv_scr_act());
+        lv_obj_set_size(arcs[i], 60, 60);
+        lv_obj_set_pos(arcs[i], 20 + (i % 4) * 190, 20 + (i / 4) * 150);
+        lv_arc_set_range(arcs[i], 0, 100);
+    }
+    for(i = 0; i < 24; i++) {
+        labels[i] = lv_label_create(lv_scr_act());
+        lv_obj_set_pos(labels[i], 100 + (i % 4) * 190, 30 + (i / 4) * 70);
+    }
+    lv_refr_now(disp);
+
+    flush_cb_ori = disp->driver->flush_cb;
+    disp->driver->flush_cb = counting_flush_cb;
+    disp->driver->monitor_cb = monitor_cb;
+    px_sum = 0;
+    flush_cnt = 0;
+
+    uint32_t frame;
+    for(frame = 0; frame < 50; frame++) {
+        for(i = 0; i < 12; i++) {
+            lv_arc_set_value(arcs[i], (frame * 3 + i * 7) % 100);
+        }
+        for(i = 0; i < 24; i++) {
+            lv_label_set_text_fmt(labels[i], "%"LV_PRIu32, (frame * 37 + i * 11) % 1000);
+        }
+        lv_refr_now(disp);
+    }
+
+    disp->driver->flush_cb = flush_cb_ori;
+
+    printf("inv area scene: %"LV_PRIu32" px/frame, %"LV_PRIu32" flush/frame\n", px_sum / 50, flush_cnt / 50);
+    TEST_ASSERT_LESS_THAN(800 * 480 / 4, px_sum / 50);
+}
+
+#endif
@@ -23,4 +23,105 @@ void test_mem_buf_realloc(void)
 #endif
 }
 
+void test_mem_slab(void)
+{
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_SIZE
+    lv_mem_monitor_t mon_start;
+    lv_mem_monitor(&mon_start);
+    TEST_ASSERT_EQUAL(LV_MEM_SLAB_SIZE, mon_start.slab_size);
+
+    /*Fill more than a page with the same size*/
+    uint8_t * bufs[40];
+    uint32_t i;
+    for(i = 0; i < 40; i++) {
+        bufs[i] = lv_mem_alloc(20);
+        TEST_ASSERT_NOT_NULL(bufs[i]);
+        lv_memset(bufs[i], i, 20);
+    }
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    uint32_t slot_size = (mon_start.slab_free_size - mon.slab_free_size) / 40;
+    TEST_ASSERT_EQUAL(0, slot_size % 16);
+    TEST_ASSERT_EQUAL(mon_start.slab_free_size - 40 * slot_size, mon.slab_free_size);
+    TEST_ASSERT_EQUAL(mon_start.used_cnt + 40, mon.used_cnt);
+
+    /*Stays in its slot*/
+    uint8_t * p = lv_mem_realloc(bufs[0], 24);
+    TEST_ASSERT_EQUAL_PTR(bufs[0], p);
+
+    /*Moves to a larger slot and to the heap but keeps the content*/
+    bufs[0] = lv_mem_realloc(bufs[0], 100);
+    TEST_ASSERT_EACH_EQUAL_UINT8(0, bufs[0], 20);
+    lv_mem_monitor(&mon);
+    uint32_t slab_free_size = mon.slab_free_size;
+    bufs[1] = lv_mem_realloc(bufs[1], 1000);
+    TEST_ASSERT_EACH_EQUAL_UINT8(1, bufs[1], 20);
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL(slab_free_size + slot_size, mon.slab_free_size);
+
+    /*The freed slots are reused*/
+    uint8_t * freed = bufs[39];
+    lv_mem_free(bufs[39]);
+    bufs[39] = lv_mem_alloc(17);
+    TEST_ASSERT_EQUAL_PTR(freed, bufs[39]);
+
+    for(i = 0; i < 40; i++) {
+        lv_mem_free(bufs[i]);
+    }
+
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL(mon_start.slab_free_size, mon.slab_free_size);
+    TEST_ASSERT_EQUAL(mon_start.free_size, mon.free_size);
+    TEST_ASSERT_EQUAL(mon_start.used_cnt, mon.used_cnt);
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_test());
+#endif
+}
+
+void test_mem_track(void)
+{
+#if LV_USE_MEM_TRACK
+    lv_mem_track_hist_t hist_start;
+    lv_mem_track_get_hist(&hist_start);
+
+    uint32_t line = __LINE__ + 1;
+    void * p1 = lv_mem_alloc(100);
+    void * p2 = lv_mem_alloc(200);
+
+    uint32_t cnt;
+    const lv_mem_track_site_t * sites = lv_mem_track_get_sites(&cnt);
+    const lv_mem_track_site_t * site1 = NULL;
+    const lv_mem_track_site_t * site2 = NULL;
+    uint32_t i;
+    for(i = 0; i < LV_MEM_TRACK_SITE_CNT; i++) {
+        if(sites[i].file == NULL || strcmp(sites[i].file, __FILE__)) continue;
+        if(sites[i].line == line) site1 = &sites[i];
+        if(sites[i].line == line + 1) site2 = &sites[i];
+    }
+    TEST_ASSERT_NOT_NULL(site1);
+    TEST_ASSERT_NOT_NULL(site2);
+    TEST_ASSERT_EQUAL(1, site1->live_cnt);
+    TEST_ASSERT_EQUAL(100, site1->live_size);
+    TEST_ASSERT_EQUAL(200, site2->live_size);
+
+    /*Reallocation moves it to the site of the reallocation*/
+    p1 = lv_mem_realloc(p1, 300);
+    TEST_ASSERT_EQUAL(0, site1->live_cnt);
+    TEST_ASSERT_EQUAL(100, site1->max_live_size);
+
+    lv_mem_free(p1);
+    lv_mem_free(p2);
+    TEST_ASSERT_EQUAL(0, site2->live_size);
+    TEST_ASSERT_EQUAL(1, site2->alloc_cnt);
+
+    lv_mem_track_hist_t hist;
+    lv_mem_track_get_hist(&hist);
+    TEST_ASSERT_EQUAL(hist_start.size_cnt[4] + 1, hist.size_cnt[4]);    /*100 <= 128*/
+    TEST_ASSERT_EQUAL(hist_start.size_cnt[5] + 1, hist.size_cnt[5]);    /*200 <= 256*/
+    TEST_ASSERT_EQUAL(hist_start.lifetime_cnt[0] + 2, hist.lifetime_cnt[0]);
+
+    lv_mem_track_dump(5);
+#endif
+}
+
 #endif
@@ -0,0 +1,192 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../demos/lv_demos.h"
+
+#include "unity/unity.h"
+#include <time.h>
+
+#if LV_USE_RETAINED_DRAW
+
+static lv_color_t frame_buf[800 * 480];
+
+static void refr_area(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h)
+{
+    /*Invalidate the display directly to keep the recordings*/
+    lv_area_t a;
+    lv_area_set(&a, x, y, x + w - 1, y + h - 1);
+    _lv_inv_area(lv_disp_get_default(), &a);
+    lv_refr_now(NULL);
+}
+
+static lv_color_t * get_frame(void)
+{
+    return lv_disp_get_default()->driver->draw_buf->buf1;
+}
+
+static void create_widgets(void)
+{
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(cont, 780, 460);
+    lv_obj_center(cont);
+    lv_obj_set_flex_flow(cont, LV_FLEX_FLOW_ROW_WRAP);
+
+    lv_obj_t * btn = lv_btn_create(cont);
+    lv_obj_t * label = lv_label_create(btn);
+    lv_label_set_text(label, "Button");
+    lv_slider_set_value(lv_slider_create(cont), 40, LV_ANIM_OFF);
+    lv_arc_set_value(lv_arc_create(cont), 70);
+    lv_checkbox_set_text(lv_checkbox_create(cont), "Checkbox");
+    lv_obj_add_state(lv_switch_create(cont), LV_STATE_CHECKED);
+    lv_bar_set_value(lv_bar_create(cont), 30, LV_ANIM_OFF);
+    lv_roller_create(cont);
+    lv_dropdown_create(cont);
+    lv_textarea_set_text(lv_textarea_create(cont), "Some text");
+
+    lv_obj_t * table = lv_table_create(cont);
+    lv_table_set_cell_value(table, 0, 0, "A");
+    lv_table_set_cell_value(table, 1, 1, "B");
+
+    lv_obj_t * chart = lv_chart_create(cont);
+    lv_chart_series_t * ser = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_RED), LV_CHART_AXIS_PRIMARY_Y);
+    uint32_t i;
+    for(i = 0; i < 10; i++) lv_chart_set_next_value(chart, ser, (i * 37) % 100);
+
+    lv_obj_t * rounded = lv_obj_create(cont);
+    lv_obj_set_style_clip_corner(rounded, true, 0);
+    lv_obj_set_style_radius(rounded, 20, 0);
+}
+
+#endif
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_retained_draw_replay_is_the_same(void)
+{
+#if LV_USE_RETAINED_DRAW
+    create_widgets();
+    lv_refr_now(NULL);
+    refr_area(0, 0, 800, 480);
+    lv_memcpy(frame_buf, get_frame(), sizeof(frame_buf));
+
+    lv_obj_draw_rec_stats_t start;
+    lv_obj_draw_rec_stats_t end;
+    lv_obj_get_draw_rec_stats(&start);
+    refr_area(0, 0, 800, 480);
+    lv_obj_get_draw_rec_stats(&end);
+
+    TEST_ASSERT_GREATER_THAN(10, end.replay_cnt - start.replay_cnt);
+    TEST_ASSERT_EQUAL(0, end.record_cnt - start.record_cnt);
+    TEST_ASSERT_EQUAL_MEMORY(frame_buf, get_frame(), sizeof(frame_buf));
+#endif
+}
+
+void test_retained_draw_invalidate_drops_the_recording(void)
+{
+#if LV_USE_RETAINED_DRAW
+    lv_obj_t * parent = lv_obj_create(lv_scr_act());
+    lv_obj_t * label1 = lv_label_create(parent);
+    lv_obj_t * label2 = lv_label_create(parent);
+    lv_label_set_text(label1, "Label 1");
+    lv_label_set_text(label2, "Label 2");
+    lv_obj_set_y(label2, 50);
+    lv_refr_now(NULL);
+    TEST_ASSERT_NOT_NULL(parent->draw_rec);
+    TEST_ASSERT_NOT_NULL(label1->draw_rec);
+    TEST_ASSERT_NOT_NULL(label2->draw_rec);
+
+    /*Only the changed label*/
+    lv_label_set_text(label1, "Label 1 changed");
+    TEST_ASSERT_NOT_NULL(parent->draw_rec);
+    TEST_ASSERT_NULL(label1->draw_rec);
+    TEST_ASSERT_NOT_NULL(label2->draw_rec);
+    lv_refr_now(NULL);
+    TEST_ASSERT_NOT_NULL(label1->draw_rec);
+
+    /*The children inherit the text color*/
+    lv_obj_set_style_text_color(parent, lv_color_hex(0xff0000), 0);
+    TEST_ASSERT_NULL(parent->draw_rec);
+    TEST_ASSERT_NULL(label1->draw_rec);
+    TEST_ASSERT_NULL(label2->draw_rec);
+#endif
+}
+
+void test_retained_draw_moved_object(void)
+{
+#if LV_USE_RETAINED_DRAW
+    lv_obj_t * parent = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(parent, 200, 200);
+    lv_obj_t * label = lv_label_create(parent);
+    lv_label_set_text(label, "Scrolled");
+    lv_obj_set_y(label, 300);
+    lv_obj_scroll_to_y(parent, 0, LV_ANIM_OFF);
+    lv_refr_now(NULL);
+
+    lv_obj_scroll_to_y(parent, 250, LV_ANIM_OFF);
+    lv_refr_now(NULL);
+    TEST_ASSERT_NOT_NULL(label->draw_rec);
+    TEST_ASSERT_EQUAL(label->coords.y1, label->draw_rec->coords.y1);
+
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now(NULL);
+    lv_memcpy(frame_buf, get_frame(), sizeof(frame_buf));
+
+    /*Replay at the new position*/
+    refr_area(0, 0, 800, 480);
+    TEST_ASSERT_EQUAL_MEMORY(frame_buf, get_frame(), sizeof(frame_buf));
+#endif
+}
+
+void test_retained_draw_partial_area(void)
+{
+#if LV_USE_RETAINED_DRAW
+    create_widgets();
+    lv_refr_now(NULL);
+    refr_area(0, 0, 800, 480);
+    lv_memcpy(frame_buf, get_frame(), sizeof(frame_buf));
+
+    /*Redraw the screen in stripes, the result has to be the same*/
+    lv_coord_t y;
+    for(y = 0; y < 480; y += 60) {
+        refr_area(0, y, 800, 60);
+        TEST_ASSERT_EQUAL_MEMORY(&frame_buf[y * 800], get_frame(), sizeof(lv_color_t) * 800 * 60);
+    }
+#endif
+}
+
+void test_retained_draw_widgets_demo(void)
+{
+#if LV_USE_RETAINED_DRAW && LV_USE_DEMO_WIDGETS
+    lv_demo_widgets();
+    lv_refr_now(NULL);
+
+    /*Something changes on the middle of the screen, e.g. a pop-up is animated*/
+    lv_obj_draw_rec_stats_t start;
+    lv_obj_draw_rec_stats_t end;
+    lv_obj_get_draw_rec_stats(&start);
+    clock_t t = clock();
+
+    uint32_t i;
+    for(i = 0; i < 20; i++) {
+        refr_area(200, 100, 400, 280);
+    }
+
+    t = clock() - t;
+    lv_obj_get_draw_rec_stats(&end);
+    uint32_t replay_cnt = (end.replay_cnt - start.replay_cnt) / 20;
+    uint32_t record_cnt = (end.record_cnt - start.record_cnt) / 20;
+    printf("retained draw: %"LV_PRIu32" replayed/frame, %"LV_PRIu32" recorded/frame, %"LV_PRIu32" us/frame\n",
+           replay_cnt, record_cnt, (uint32_t)(t * 1000000 / CLOCKS_PER_SEC / 20));
+
+    TEST_ASSERT_GREATER_THAN(0, replay_cnt);
+    TEST_ASSERT_EQUAL(0, record_cnt);
+#endif
+}
+
+#endif
@@ -0,0 +1,165 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../demos/lv_demos.h"
+
+#include "unity/unity.h"
+#include <time.h>
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_scr_act());
+}
+
+void test_style_cache_local_style_change(void)
+{
+#if LV_OBJ_STYLE_CACHE_SIZE
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_bg_color(obj, lv_color_hex(0xff0000), 0);
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0xff0000).full, lv_obj_get_style_bg_color(obj, 0).full);
+
+    lv_obj_set_style_bg_color(obj, lv_color_hex(0x00ff00), 0);
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0x00ff00).full, lv_obj_get_style_bg_color(obj, 0).full);
+
+    lv_obj_remove_local_style_prop(obj, LV_STYLE_BG_COLOR, 0);
+    lv_obj_set_style_border_width(obj, 7, LV_PART_SCROLLBAR);
+    TEST_ASSERT_NOT_EQUAL(lv_color_hex(0x00ff00).full, lv_obj_get_style_bg_color(obj, 0).full);
+    TEST_ASSERT_EQUAL(7, lv_obj_get_style_border_width(obj, LV_PART_SCROLLBAR));
+    TEST_ASSERT_NOT_EQUAL(7, lv_obj_get_style_border_width(obj, LV_PART_MAIN));
+#endif
+}
+
+void test_style_cache_shared_style_change(void)
+{
+#if LV_OBJ_STYLE_CACHE_SIZE
+    static lv_style_t style;
+    lv_style_init(&style);
+    lv_style_set_radius(&style, 3);
+
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_add_style(obj, &style, 0);
+    TEST_ASSERT_EQUAL(3, lv_obj_get_style_radius(obj, 0));
+
+    /*Even without `lv_obj_report_style_change()` the new value has to be read*/
+    lv_style_set_radius(&style, 9);
+    TEST_ASSERT_EQUAL(9, lv_obj_get_style_radius(obj, 0));
+
+    lv_style_remove_prop(&style, LV_STYLE_RADIUS);
+    lv_obj_report_style_change(&style);
+    TEST_ASSERT_NOT_EQUAL(9, lv_obj_get_style_radius(obj, 0));
+
+    lv_obj_remove_style(obj, &style, 0);
+    lv_style_reset(&style);
+#endif
+}
+
+void test_style_cache_state_change(void)
+{
+#if LV_OBJ_STYLE_CACHE_SIZE
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_border_width(obj, 1, 0);
+    lv_obj_set_style_border_width(obj, 5, LV_STATE_PRESSED);
+    TEST_ASSERT_EQUAL(1, lv_obj_get_style_border_width(obj, 0));
+
+    lv_obj_add_state(obj, LV_STATE_PRESSED);
+    TEST_ASSERT_EQUAL(5, lv_obj_get_style_border_width(obj, 0));
+
+    lv_obj_clear_state(obj, LV_STATE_PRESSED);
+    TEST_ASSERT_EQUAL(1, lv_obj_get_style_border_width(obj, 0));
+#endif
+}
+
+void test_style_cache_inherited_from_parent(void)
+{
+#if LV_OBJ_STYLE_CACHE_SIZE
+    lv_obj_t * parent1 = lv_obj_create(lv_scr_act());
+    lv_obj_t * parent2 = lv_obj_create(lv_scr_act());
+    lv_obj_t * label = lv_label_create(parent1);
+    lv_obj_set_style_text_color(parent1, lv_color_hex(0x112233), 0);
+    lv_obj_set_style_text_color(parent2, lv_color_hex(0x445566), 0);
+    lv_obj_set_style_text_color(parent1, lv_color_hex(0x778899), LV_STATE_CHECKED);
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0x112233).full, lv_obj_get_style_text_color(label, 0).full);
+
+    /*Only the parent's state changes, the label inherits the new value*/
+    lv_obj_add_state(parent1, LV_STATE_CHECKED);
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0x778899).full, lv_obj_get_style_text_color(label, 0).full);
+
+    lv_obj_set_parent(label, parent2);
+    TEST_ASSERT_EQUAL_HEX(lv_color_hex(0x445566).full, lv_obj_get_style_text_color(label, 0).full);
+#endif
+}
+
+void test_style_cache_deleted_object(void)
+{
+#if LV_OBJ_STYLE_CACHE_SIZE
+    /*A new object is likely to get the address of the deleted one*/
+    uint32_t i;
+    for(i = 0; i < 10; i++) {
+        lv_obj_t * obj = lv_obj_create(lv_scr_act());
+        lv_obj_set_style_pad_left(obj, i, 0);
+        TEST_ASSERT_EQUAL(i, lv_obj_get_style_pad_left(obj, 0));
+        lv_obj_del(obj);
+    }
+#endif
+}
+
+void test_style_cache_transition(void)
+{
+#if LV_OBJ_STYLE_CACHE_SIZE
+    static const lv_style_prop_t props[] = {LV_STYLE_BG_OPA, 0};
+    static lv_style_transition_dsc_t tr;
+    lv_style_transition_dsc_init(&tr, props, lv_anim_path_linear, 100, 0, NULL);
+
+    lv_obj_t * obj = lv_obj_create(lv_scr_act());
+    lv_obj_set_style_bg_opa(obj, 0, 0);
+    lv_obj_set_style_bg_opa(obj, 200, LV_STATE_PRESSED);
+    lv_obj_set_style_transition(obj, &tr, LV_STATE_PRESSED);
+    TEST_ASSERT_EQUAL(0, lv_obj_get_style_bg_opa(obj, 0));
+
+    lv_obj_add_state(obj, LV_STATE_PRESSED);
+    lv_tick_inc(50);
+    lv_timer_handler();
+    lv_opa_t opa_mid = lv_obj_get_style_bg_opa(obj, 0);
+    TEST_ASSERT_GREATER_THAN(0, opa_mid);
+    TEST_ASSERT_LESS_THAN(200, opa_mid);
+
+    lv_tick_inc(100);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(200, lv_obj_get_style_bg_opa(obj, 0));
+#endif
+}
+
+void test_style_cache_widgets_demo(void)
+{
+#if LV_OBJ_STYLE_CACHE_SIZE && LV_USE_DEMO_WIDGETS
+    lv_demo_widgets();
+    lv_refr_now(NULL);
+
+    lv_obj_style_cache_stats_t start;
+    lv_obj_style_cache_stats_t end;
+    lv_obj_get_style_cache_stats(&start);
+    clock_t t = clock();
+
+    uint32_t i;
+    for(i = 0; i < 20; i++) {
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+    }
+
+    t = clock() - t;
+    lv_obj_get_style_cache_stats(&end);
+    uint32_t read_cnt = (end.read_cnt - start.read_cnt) / 20;
+    uint32_t resolve_cnt = (end.resolve_cnt - start.resolve_cnt) / 20;
+    printf("style cache: %"LV_PRIu32" reads/frame, %"LV_PRIu32" resolved/frame, %"LV_PRIu32" us/frame\n",
+           read_cnt, resolve_cnt, (uint32_t)(t * 1000000 / CLOCKS_PER_SEC / 20));
+
+    /*The screen has more object parts than cache entries, but the parent's and the
+     *parts of the same object drawn one after the other are still in the cache*/
+    TEST_ASSERT_LESS_THAN(read_cnt * 3 / 4, resolve_cnt);
+#endif
+}
+
+#endif
@@ -0,0 +1,170 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#define TIMER_CNT 3000
+
+static uint32_t deadlines[TIMER_CNT];
+static uint32_t last_deadline;
+static uint32_t run_cnt;
+static bool order_ok;
+
+static lv_timer_t * other_timer;
+static uint32_t other_run_cnt;
+static uint32_t idle_run_cnt;
+
+void setUp(void)
+{
+    /* Function run before every test */
+}
+
+void tearDown(void)
+{
+    /* Function run after every test */
+}
+
+static void order_timer_cb(lv_timer_t * timer)
+{
+    uint32_t deadline = deadlines[(uintptr_t)timer->user_data];
+    if((int32_t)(deadline - last_deadline) < 0) order_ok = false;
+    if((int32_t)(lv_tick_get() - deadline) < 0) order_ok = false;
+    last_deadline = deadline;
+    run_cnt++;
+}
+
+static void idle_timer_cb(lv_timer_t * timer)
+{
+    LV_UNUSED(timer);
+    idle_run_cnt++;
+}
+
+static void count_timer_cb(lv_timer_t * timer)
+{
+    LV_UNUSED(timer);
+    other_run_cnt++;
+}
+
+static void del_other_timer_cb(lv_timer_t * timer)
+{
+    /*Create a one-shot timer which is due at once and delete the other one*/
+    lv_timer_t * t = lv_timer_create(count_timer_cb, 0, NULL);
+    lv_timer_set_repeat_count(t, 1);
+    if(other_timer) {
+        lv_timer_del(other_timer);
+        other_timer = NULL;
+    }
+
+    lv_timer_del(timer);
+}
+
+void test_timer_order(void)
+{
+    uint32_t i;
+    for(i = 0; i < TIMER_CNT; i++) {
+        lv_timer_t * t = lv_timer_create(order_timer_cb, lv_rand(0, 200), (void *)(uintptr_t)i);
+        TEST_ASSERT_NOT_NULL(t);
+        lv_timer_set_repeat_count(t, 1);
+        deadlines[i] = t->last_run + t->period;
+    }
+
+    run_cnt = 0;
+    last_deadline = deadlines[0];
+    for(i = 1; i < TIMER_CNT; i++) {
+        if((int32_t)(deadlines[i] - last_deadline) < 0) last_deadline = deadlines[i];
+    }
+    order_ok = true;
+
+    for(i = 0; i <= 200 && run_cnt < TIMER_CNT; i++) {
+        lv_timer_handler();
+        lv_tick_inc(1);
+    }
+    lv_timer_handler();
+
+    TEST_ASSERT_EQUAL(TIMER_CNT, run_cnt);
+    TEST_ASSERT_TRUE(order_ok);
+
+    /*All one-shot timers are deleted*/
+    lv_timer_t * t = lv_timer_get_next(NULL);
+    while(t) {
+        TEST_ASSERT_FALSE(t->timer_cb == order_timer_cb);
+        t = lv_timer_get_next(t);
+    }
+}
+
+void test_timer_many_idle(void)
+{
+    static lv_timer_t * timers[TIMER_CNT];
+    uint32_t i;
+    idle_run_cnt = 0;
+    for(i = 0; i < TIMER_CNT; i++) {
+        timers[i] = lv_timer_create(idle_timer_cb, 100000 + i, NULL);
+        TEST_ASSERT_NOT_NULL(timers[i]);
+    }
+
+    /*The timers which are not due don't run and the next timer is not one of them*/
+    for(i = 0; i < 1000; i++) {
+        lv_tick_inc(1);
+        lv_timer_handler();
+    }
+    TEST_ASSERT_EQUAL(0, idle_run_cnt);
+    TEST_ASSERT_LESS_OR_EQUAL(LV_DISP_DEF_REFR_PERIOD, lv_timer_get_time_till_next());
+
+    /*All are due, each of them runs once*/
+    lv_tick_inc(100000 + TIMER_CNT);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(TIMER_CNT, idle_run_cnt);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(TIMER_CNT, idle_run_cnt);
+
+    for(i = 0; i < TIMER_CNT; i++) {
+        lv_timer_del(timers[i]);
+    }
+}
+
+void test_timer_change_in_cb(void)
+{
+    other_run_cnt = 0;
+    other_timer = lv_timer_create(count_timer_cb, 0, NULL);
+    lv_timer_pause(other_timer);
+
+    lv_timer_t * t = lv_timer_create(del_other_timer_cb, 0, NULL);
+    lv_timer_set_period(t, 10);
+    lv_timer_ready(t);
+    TEST_ASSERT_EQUAL(0, lv_timer_get_time_till_next());
+
+    /*The paused timer doesn't run, the new timer runs once in the same call*/
+    lv_timer_handler();
+    TEST_ASSERT_NULL(other_timer);
+    TEST_ASSERT_EQUAL(1, other_run_cnt);
+
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(1, other_run_cnt);
+
+    /*A paused timer keeps its schedule and runs after it's resumed*/
+    other_timer = lv_timer_create(count_timer_cb, 0, NULL);
+    lv_timer_pause(other_timer);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(1, other_run_cnt);
+    lv_timer_resume(other_timer);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(2, other_run_cnt);
+
+    /*Every timer runs at most once per call*/
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(3, other_run_cnt);
+
+    /*Zero repeat count deletes the timer on the next call*/
+    lv_timer_set_period(other_timer, 100000);
+    lv_timer_set_repeat_count(other_timer, 0);
+    lv_timer_handler();
+    TEST_ASSERT_EQUAL(3, other_run_cnt);
+    t = lv_timer_get_next(NULL);
+    while(t) {
+        TEST_ASSERT_FALSE(t == other_timer);
+        t = lv_timer_get_next(t);
+    }
+    other_timer = NULL;
+}
+
+#endif